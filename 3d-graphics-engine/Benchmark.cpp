@@ -0,0 +1,489 @@
+#include "Benchmark.h"
+#include "Constants.h"
+#include "Entity.h"
+#include "GraphicsEngine.h"
+#include "GLState.h"
+#include "InstanceBuffer.h"
+#include "Mesh.h"
+#include "MeshCache.h"
+#include "MeshLoader.h"
+#include "MeshOptimiser.h"
+#include "ShaderProgram.h"
+#include "UniformBlocks.h"
+#include "UniformBuffer.h"
+#include <GL\glew.h>
+#include <glm\glm.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+
+namespace
+{
+	// The model from the models directory that is measured
+	const std::string BENCHMARK_MODEL = "teapot2.obj";
+
+	// The generated model is a grid of this many vertices squared,
+	// roughly 2 million triangles
+	constexpr int SYNTHETIC_GRID_SIZE = 1024;
+	const std::string SYNTHETIC_MODEL_PATH = Constants::MODEL_PATH + "benchmark-synthetic.obj";
+
+	// The number of draws whose uniforms are set when measuring uniform updates
+	constexpr int UNIFORM_BENCHMARK_DRAWS = 100000;
+
+	// The numbers of point lights the frame is measured with, the lights are spread over a
+	// ground of this half size and fall off within roughly a unit and a half. The ground is
+	// made of tiles, so that each tile is only reached by some of the lights.
+	constexpr int CLUSTER_BENCHMARK_LIGHT_COUNTS[] = { 256, 1024 };
+	constexpr float CLUSTER_BENCHMARK_PLANE_SCALE = 20.0f;
+	constexpr int CLUSTER_BENCHMARK_TILES = 16;
+	constexpr PointLight::Attenuation CLUSTER_BENCHMARK_ATTENUATION{ 200.0f, 0.0f, 1.0f };
+	constexpr int CLUSTER_BENCHMARK_FRAMES = 50;
+
+	using Clock = std::chrono::steady_clock;
+
+	double ElapsedMilliseconds(Clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	// Writes a triangulated grid with positions, texture coordinates and normals
+	bool WriteSyntheticObj(const std::string& filepath, int gridSize)
+	{
+		std::ofstream file(filepath, std::ios::out | std::ios::binary);
+		if(!file)
+		{
+			return false;
+		}
+
+		char line[256];
+		const float step = 1.0f / (gridSize - 1);
+
+		for(int z = 0; z < gridSize; ++z)
+		{
+			for(int x = 0; x < gridSize; ++x)
+			{
+				int length = snprintf(line, sizeof(line), "v %f %f %f\n",
+					x * step, 0.1f * ((x ^ z) & 7) * step, z * step);
+				file.write(line, length);
+			}
+		}
+
+		for(int z = 0; z < gridSize; ++z)
+		{
+			for(int x = 0; x < gridSize; ++x)
+			{
+				int length = snprintf(line, sizeof(line), "vt %f %f\n", x * step, z * step);
+				file.write(line, length);
+			}
+		}
+
+		file << "vn 0.000000 1.000000 0.000000\n";
+
+		for(int z = 0; z < gridSize - 1; ++z)
+		{
+			for(int x = 0; x < gridSize - 1; ++x)
+			{
+				// OBJ indices start at 1
+				int topLeft     = z * gridSize + x + 1;
+				int topRight    = topLeft + 1;
+				int bottomLeft  = topLeft + gridSize;
+				int bottomRight = bottomLeft + 1;
+
+				int length = snprintf(line, sizeof(line), "f %d/%d/1 %d/%d/1 %d/%d/1\nf %d/%d/1 %d/%d/1 %d/%d/1\n",
+					topLeft, topLeft, bottomLeft, bottomLeft, topRight, topRight,
+					topRight, topRight, bottomLeft, bottomLeft, bottomRight, bottomRight);
+				file.write(line, length);
+			}
+		}
+
+		return static_cast<bool>(file);
+	}
+
+	void MeasureLoadThroughput(const std::string& filepath, int iterations, int maxThreads = 0)
+	{
+		std::error_code error;
+		const auto fileSize = std::filesystem::file_size(filepath, error);
+		if(error)
+		{
+			printf("Benchmark: could not find '%s'\n", filepath.c_str());
+			return;
+		}
+
+		double totalMs = 0.0;
+		double bestMs = 0.0;
+		std::size_t numVertices = 0;
+
+		for(int i = 0; i < iterations; ++i)
+		{
+			MeshData meshData;
+
+			Clock::time_point start = Clock::now();
+			bool loaded = LoadMeshData(filepath, &meshData, maxThreads);
+			double ms = ElapsedMilliseconds(start);
+
+			if(!loaded)
+			{
+				printf("Benchmark: failed to load '%s'\n", filepath.c_str());
+				return;
+			}
+
+			totalMs += ms;
+			bestMs = (i == 0 || ms < bestMs) ? ms : bestMs;
+			numVertices = meshData.positions.size();
+		}
+
+		const double megabytes = fileSize / (1024.0 * 1024.0);
+		const double averageMs = totalMs / iterations;
+
+		if(maxThreads > 0)
+		{
+			printf("%s: %.2f MB, %zu vertices, %d thread(s)\n", filepath.c_str(), megabytes, numVertices, maxThreads);
+		}
+		else
+		{
+			printf("%s: %.2f MB, %zu vertices\n", filepath.c_str(), megabytes, numVertices);
+		}
+		printf("    average %.2f ms (%.1f MB/s), best %.2f ms (%.1f MB/s) over %d runs\n",
+			averageMs, megabytes / (averageMs / 1000.0), bestMs, megabytes / (bestMs / 1000.0), iterations);
+	}
+
+	// Creates a flat grid of vertices in memory, roughly 2 million triangles
+	MeshData CreateGridMeshData(int gridSize)
+	{
+		MeshData meshData;
+		const float step = 1.0f / (gridSize - 1);
+
+		for(int z = 0; z < gridSize; ++z)
+		{
+			for(int x = 0; x < gridSize; ++x)
+			{
+				meshData.positions.push_back({ x * step, 0.0f, z * step });
+				meshData.texCoords.push_back({ x * step, z * step });
+				meshData.normals.push_back({ 0.0f, 1.0f, 0.0f });
+			}
+		}
+
+		for(int z = 0; z < gridSize - 1; ++z)
+		{
+			for(int x = 0; x < gridSize - 1; ++x)
+			{
+				const GLuint topLeft = z * gridSize + x;
+				const GLuint bottomLeft = topLeft + gridSize;
+
+				meshData.indices.insert(meshData.indices.end(),
+					{ topLeft, bottomLeft, topLeft + 1, topLeft + 1, bottomLeft, bottomLeft + 1 });
+			}
+		}
+
+		return meshData;
+	}
+
+	// Measures the GPU time taken to draw the mesh, with rasterisation disabled so
+	// that only the vertex stage is measured
+	void MeasureVertexThroughput(const char* name, const Mesh& mesh, GLsizei numIndices, int iterations)
+	{
+		GLuint query;
+		glGenQueries(1, &query);
+
+		// Warm up, the first draw may include driver work
+		mesh.Render();
+		glFinish();
+
+		glBeginQuery(GL_TIME_ELAPSED, query);
+		for(int i = 0; i < iterations; ++i)
+		{
+			mesh.Render();
+		}
+		glEndQuery(GL_TIME_ELAPSED);
+
+		GLuint64 elapsedNs = 0;
+		glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsedNs);
+		glDeleteQueries(1, &query);
+
+		const double ms = elapsedNs / 1e6 / iterations;
+		const double indicesPerSecond = numIndices / (ms / 1000.0);
+
+		printf("%s: %.3f ms per draw, %.1f million indexed vertices/s\n", name, ms, indicesPerSecond / 1e6);
+	}
+
+	// Measures the average GPU time of rendering a frame
+	double MeasureFrameTime(GraphicsEngine& engine, int frames)
+	{
+		// Timestamps rather than a GL_TIME_ELAPSED query, since the renderer times its shadow
+		// passes with GL_TIME_ELAPSED queries of its own and those cannot be nested
+		GLuint queries[2];
+		glGenQueries(2, queries);
+
+		// Warm up, the first frame also draws the shadow maps
+		engine.Render();
+		glFinish();
+
+		glQueryCounter(queries[0], GL_TIMESTAMP);
+		for(int i = 0; i < frames; ++i)
+		{
+			engine.Render();
+		}
+		glQueryCounter(queries[1], GL_TIMESTAMP);
+
+		GLuint64 startNs = 0;
+		GLuint64 endNs = 0;
+		glGetQueryObjectui64v(queries[0], GL_QUERY_RESULT, &startNs);
+		glGetQueryObjectui64v(queries[1], GL_QUERY_RESULT, &endNs);
+		glDeleteQueries(2, queries);
+
+		return (endNs - startNs) / 1e6 / frames;
+	}
+
+	// Compares creating a mesh by parsing the OBJ file against creating it from the binary cache
+	void MeasureCacheSpeedup(const std::string& filepath)
+	{
+		std::error_code error;
+		std::filesystem::remove(MeshCache::GetCachePath(filepath), error);
+
+		Clock::time_point start = Clock::now();
+		delete LoadMesh(filepath);
+		const double parseMs = ElapsedMilliseconds(start);
+
+		start = Clock::now();
+		delete LoadMesh(filepath);
+		const double cacheMs = ElapsedMilliseconds(start);
+
+		std::filesystem::remove(MeshCache::GetCachePath(filepath), error);
+
+		printf("%s: parse and write cache %.2f ms, load from cache %.2f ms (%.1fx faster)\n",
+			filepath.c_str(), parseMs, cacheMs, parseMs / cacheMs);
+	}
+}
+
+namespace Benchmark
+{
+	void MeshLoading()
+	{
+		printf("--- Mesh loading ---\n");
+
+		MeasureLoadThroughput(Constants::MODEL_PATH + BENCHMARK_MODEL, 20);
+
+		printf("Generating synthetic model...\n");
+		if(!WriteSyntheticObj(SYNTHETIC_MODEL_PATH, SYNTHETIC_GRID_SIZE))
+		{
+			printf("Benchmark: could not write '%s'\n", SYNTHETIC_MODEL_PATH.c_str());
+			return;
+		}
+
+		MeasureLoadThroughput(SYNTHETIC_MODEL_PATH, 3);
+
+		// Shows how well parsing scales with the number of threads
+		const int numHardwareThreads = static_cast<int>(std::thread::hardware_concurrency());
+		for(int numThreads = 1; numThreads <= numHardwareThreads; numThreads *= 2)
+		{
+			MeasureLoadThroughput(SYNTHETIC_MODEL_PATH, 3, numThreads);
+		}
+
+		MeasureCacheSpeedup(SYNTHETIC_MODEL_PATH);
+
+		std::remove(SYNTHETIC_MODEL_PATH.c_str());
+	}
+
+	void VertexThroughput()
+	{
+		printf("--- Vertex throughput ---\n");
+
+		// Reads every vertex attribute, so that no attribute fetch is optimised away
+		ShaderProgram shader((Constants::SHADER_PATH + "phong/vert.glsl").c_str(),
+			(Constants::SHADER_PATH + "phong/frag.glsl").c_str());
+		shader.Bind();
+
+		// Every mesh is drawn as a single instance with no transform
+		const InstanceData identity{ glm::mat4(1.0f), glm::mat4(1.0f) };
+		InstanceBuffer instanceBuffer;
+		instanceBuffer.Upload(&identity, 1);
+		shader.SetUniform("instanceOffset", 0);
+
+		CameraUniformBlock camera{};
+		camera.viewProjMatrix = glm::mat4(1.0f);
+		UniformBuffer cameraBuffer(sizeof(CameraUniformBlock), UniformBlocks::CAMERA_BINDING);
+		cameraBuffer.Update(camera);
+
+		MeshData meshData = CreateGridMeshData(SYNTHETIC_GRID_SIZE);
+		MeshOptimiser::Optimise(&meshData);
+
+		const MeshView view = GetMeshView(meshData);
+		Mesh splitMesh(view, VertexFormat::SPLIT);
+		Mesh interleavedMesh(view, VertexFormat::INTERLEAVED);
+		Mesh quantisedMesh(view, VertexFormat::QUANTISED);
+
+		GLState::SetEnabled(GL_RASTERIZER_DISCARD, true);
+
+		MeasureVertexThroughput("Split", splitMesh, view.numIndices, 20);
+		MeasureVertexThroughput("Interleaved", interleavedMesh, view.numIndices, 20);
+
+		shader.SetUniform("octahedralNormals", true);
+		MeasureVertexThroughput("Quantised", quantisedMesh, view.numIndices, 20);
+
+		GLState::SetEnabled(GL_RASTERIZER_DISCARD, false);
+	}
+
+	void UniformUpdates()
+	{
+		printf("--- Uniform updates ---\n");
+
+		ShaderProgram shader((Constants::SHADER_PATH + "phong-notexture/vert.glsl").c_str(),
+			(Constants::SHADER_PATH + "phong-notexture/frag.glsl").c_str());
+		shader.Bind();
+
+		const GLuint programID = shader.GetProgramID();
+		const glm::vec3 colour(0.5f);
+
+		// The uniforms the render pass sets for each draw
+		Clock::time_point start = Clock::now();
+		for(int i = 0; i < UNIFORM_BENCHMARK_DRAWS; ++i)
+		{
+			glProgramUniform1i(programID, glGetUniformLocation(programID, std::string("instanceOffset").c_str()), i);
+			glProgramUniform1i(programID, glGetUniformLocation(programID, std::string("octahedralNormals").c_str()), i & 1);
+			glProgramUniform3fv(programID, glGetUniformLocation(programID, std::string("material.ambient").c_str()), 1, &colour.x);
+			glProgramUniform3fv(programID, glGetUniformLocation(programID, std::string("material.diffuse").c_str()), 1, &colour.x);
+			glProgramUniform3fv(programID, glGetUniformLocation(programID, std::string("material.specular").c_str()), 1, &colour.x);
+			glProgramUniform1f(programID, glGetUniformLocation(programID, std::string("material.shininess").c_str()), 32.0f);
+		}
+		glFinish();
+		const double lookupMs = ElapsedMilliseconds(start);
+
+		start = Clock::now();
+		for(int i = 0; i < UNIFORM_BENCHMARK_DRAWS; ++i)
+		{
+			shader.SetUniform("instanceOffset", i);
+			shader.SetUniform("octahedralNormals", i & 1);
+			shader.SetUniform("material.ambient", colour);
+			shader.SetUniform("material.diffuse", colour);
+			shader.SetUniform("material.specular", colour);
+			shader.SetUniform("material.shininess", 32.0f);
+		}
+		glFinish();
+		const double nameMs = ElapsedMilliseconds(start);
+
+		constexpr UniformHandle INSTANCE_OFFSET("instanceOffset");
+		constexpr UniformHandle OCTAHEDRAL_NORMALS("octahedralNormals");
+		constexpr UniformHandle AMBIENT("material.ambient");
+		constexpr UniformHandle DIFFUSE("material.diffuse");
+		constexpr UniformHandle SPECULAR("material.specular");
+		constexpr UniformHandle SHININESS("material.shininess");
+
+		start = Clock::now();
+		for(int i = 0; i < UNIFORM_BENCHMARK_DRAWS; ++i)
+		{
+			shader.SetUniform(INSTANCE_OFFSET, i);
+			shader.SetUniform(OCTAHEDRAL_NORMALS, i & 1);
+			shader.SetUniform(AMBIENT, colour);
+			shader.SetUniform(DIFFUSE, colour);
+			shader.SetUniform(SPECULAR, colour);
+			shader.SetUniform(SHININESS, 32.0f);
+		}
+		glFinish();
+		const double handleMs = ElapsedMilliseconds(start);
+
+		printf("%d uniforms in %zu slots\n", static_cast<int>(shader.GetUniforms().GetNumUniforms()),
+			shader.GetUniforms().GetNumSlots());
+
+		const double toNsPerDraw = 1e6 / UNIFORM_BENCHMARK_DRAWS;
+		printf("glGetUniformLocation: %.1f ns per draw\n", lookupMs * toNsPerDraw);
+		printf("Reflected table by name: %.1f ns per draw\n", nameMs * toNsPerDraw);
+		printf("Reflected table by handle: %.1f ns per draw (%.1fx faster than glGetUniformLocation)\n",
+			handleMs * toNsPerDraw, lookupMs / handleMs);
+
+		glDeleteProgram(programID);
+	}
+
+	void ManyPointLights(GraphicsEngine& engine)
+	{
+		printf("--- Many point lights ---\n");
+
+		engine.AddShader("phong");
+		engine.AddShader("phong-notexture");
+		engine.AddShader("shadow-map");
+		engine.AddShader("debug-quad");
+		engine.AddShader("point-light-gizmo");
+		engine.AddShader("deferred-geometry");
+		engine.AddShader("deferred-directional");
+		engine.AddShader("deferred-point");
+		engine.AddShader("depth-prepass");
+
+		const float tileScale = CLUSTER_BENCHMARK_PLANE_SCALE / CLUSTER_BENCHMARK_TILES;
+		for(int z = 0; z < CLUSTER_BENCHMARK_TILES; ++z)
+		{
+			for(int x = 0; x < CLUSTER_BENCHMARK_TILES; ++x)
+			{
+				Entity* tile = engine.CreateEntity("plane");
+				tile->SetScale(tileScale);
+				tile->SetPosition(glm::vec3((x * 2 + 1) * tileScale - CLUSTER_BENCHMARK_PLANE_SCALE, 0.0f,
+					(z * 2 + 1) * tileScale - CLUSTER_BENCHMARK_PLANE_SCALE));
+			}
+		}
+		engine.SetGlobalAmbientLight(glm::vec3(0.05f));
+
+		// The automatic pre-pass would run on some frames and not others
+		Renderer& renderer = engine.GetRenderer();
+		renderer.SetDepthPrePassMode(DepthPrePassMode::OFF);
+		int numLights = 0;
+		bool prepared = false;
+
+		for(int lightCount : CLUSTER_BENCHMARK_LIGHT_COUNTS)
+		{
+			// Lights are only ever added, so each count builds on the last. The positions are
+			// scattered with a fixed sequence so that every run measures the same scene.
+			for(; numLights < lightCount; ++numLights)
+			{
+				const float u = std::fmod(numLights * 0.618034f, 1.0f);
+				const float v = std::fmod(numLights * 0.754878f, 1.0f);
+				const glm::vec3 position((u * 2.0f - 1.0f) * CLUSTER_BENCHMARK_PLANE_SCALE, 0.5f,
+					(v * 2.0f - 1.0f) * CLUSTER_BENCHMARK_PLANE_SCALE);
+				const glm::vec3 colour(u, v, 1.0f - u);
+
+				engine.CreatePointLight(position, colour, 1.0f, CLUSTER_BENCHMARK_ATTENUATION);
+			}
+
+			if(!prepared)
+			{
+				engine.PrepareToRender();
+				prepared = true;
+
+				// The light volumes of deferred shading are drawn with the sphere mesh
+				engine.FinishMeshLoads();
+			}
+
+			renderer.SetLightAssignment(LightAssignment::EVERY_LIGHT);
+			const double everyLightMs = MeasureFrameTime(engine, CLUSTER_BENCHMARK_FRAMES);
+
+			renderer.SetLightAssignment(LightAssignment::PER_ENTITY);
+			const double perEntityMs = MeasureFrameTime(engine, CLUSTER_BENCHMARK_FRAMES);
+			const int numEntityLightIndices = engine.GetRenderStats().numEntityLightIndices;
+
+			renderer.SetLightAssignment(LightAssignment::CLUSTERED);
+			const double clusteredMs = MeasureFrameTime(engine, CLUSTER_BENCHMARK_FRAMES);
+			const RenderStats& stats = engine.GetRenderStats();
+			const float clusterBuildMs = stats.clusterBuildMs;
+			const int numClusterLightIndices = stats.numClusterLightIndices;
+
+			renderer.SetDepthPrePassMode(DepthPrePassMode::ON);
+			const double prePassMs = MeasureFrameTime(engine, CLUSTER_BENCHMARK_FRAMES);
+			renderer.SetDepthPrePassMode(DepthPrePassMode::OFF);
+
+			renderer.SetShadingPath(ShadingPath::DEFERRED);
+			const double deferredMs = MeasureFrameTime(engine, CLUSTER_BENCHMARK_FRAMES);
+			renderer.SetShadingPath(ShadingPath::FORWARD);
+
+			printf("%d point lights, radius %.2f: every light %.3f ms\n", lightCount,
+				engine.GetPointLights().front()->CalculateRadius(), everyLightMs);
+			printf("    per entity %.3f ms (%.1fx faster), %d light indices\n",
+				perEntityMs, everyLightMs / perEntityMs, numEntityLightIndices);
+			printf("    clustered %.3f ms (%.1fx faster), %d light indices, cluster build %.3f ms on the CPU\n",
+				clusteredMs, everyLightMs / clusteredMs, numClusterLightIndices, clusterBuildMs);
+			printf("    clustered with a depth pre-pass %.3f ms (%.1fx faster), overdraw %.2fx\n",
+				prePassMs, everyLightMs / prePassMs, engine.GetRenderStats().overdrawRatio);
+			printf("    deferred %.3f ms (%.1fx faster)\n", deferredMs, everyLightMs / deferredMs);
+		}
+	}
+}
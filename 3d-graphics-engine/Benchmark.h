@@ -0,0 +1,29 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+class GraphicsEngine;
+
+// Performance measurements that are run instead of the scene when
+// RUN_BENCHMARKS is enabled in main.cpp. Results are written to stdout.
+namespace Benchmark
+{
+	// Measures the throughput of the OBJ loader in MB/s on a model from the
+	// models directory and on a large generated model, including how it
+	// scales with the number of parsing threads and how much faster the
+	// binary mesh cache is
+	void MeshLoading();
+
+	// Measures the GPU vertex throughput of a high-poly mesh stored with each vertex format
+	void VertexThroughput();
+
+	// Measures the CPU cost of setting a draw's uniforms by looking up each location with
+	// glGetUniformLocation, by name through the reflected table and by precomputed handle
+	void UniformUpdates();
+
+	// Measures the GPU time of a frame lit by hundreds of small point lights, with every fragment
+	// applying every light, with per entity light lists, with clustered shading with and without a
+	// depth pre-pass, and with deferred shading. Adds the scene to the engine.
+	void ManyPointLights(GraphicsEngine& engine);
+}
+
+#endif
@@ -0,0 +1,123 @@
+#include "BoundingVolume.h"
+#include <glm\glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <xmmintrin.h>
+
+namespace
+{
+	// Reads the vertex into the first three lanes, the fourth lane is left over.
+	// Reading four floats from a vec3 is only safe when another position follows it.
+	__m128 LoadPositionFollowed(const glm::vec3* pPosition)
+	{
+		return _mm_loadu_ps(&pPosition->x);
+	}
+
+	__m128 LoadLastPosition(const glm::vec3* pPosition)
+	{
+		return _mm_setr_ps(pPosition->x, pPosition->y, pPosition->z, 0.0f);
+	}
+
+	glm::vec3 StoreVec3(__m128 value)
+	{
+		alignas(16) float lanes[4];
+		_mm_store_ps(lanes, value);
+
+		return glm::vec3(lanes[0], lanes[1], lanes[2]);
+	}
+
+	// The squared length of the first three lanes
+	float LengthSquared3(__m128 value)
+	{
+		const glm::vec3 v = StoreVec3(_mm_mul_ps(value, value));
+		return v.x + v.y + v.z;
+	}
+}
+
+namespace BoundingVolume
+{
+	AABB CalculateAABB(const glm::vec3* pPositions, std::size_t count)
+	{
+		if(count == 0)
+		{
+			return AABB{ glm::vec3(0.0f), glm::vec3(0.0f) };
+		}
+
+		// Two sets of accumulators, so that consecutive min/max operations do not wait on each other
+		__m128 min0 = LoadLastPosition(pPositions);
+		__m128 max0 = min0;
+		__m128 min1 = min0;
+		__m128 max1 = min0;
+
+		std::size_t i = 0;
+		for(; i + 2 < count; i += 2)
+		{
+			const __m128 a = LoadPositionFollowed(pPositions + i);
+			const __m128 b = LoadPositionFollowed(pPositions + i + 1);
+
+			min0 = _mm_min_ps(min0, a);
+			max0 = _mm_max_ps(max0, a);
+			min1 = _mm_min_ps(min1, b);
+			max1 = _mm_max_ps(max1, b);
+		}
+
+		for(; i < count; ++i)
+		{
+			const __m128 p = LoadLastPosition(pPositions + i);
+
+			min0 = _mm_min_ps(min0, p);
+			max0 = _mm_max_ps(max0, p);
+		}
+
+		return AABB{ StoreVec3(_mm_min_ps(min0, min1)), StoreVec3(_mm_max_ps(max0, max1)) };
+	}
+
+	BoundingSphere CalculateBoundingSphere(const glm::vec3* pPositions, std::size_t count, const AABB& bounds)
+	{
+		const glm::vec3 centre = bounds.GetCentre();
+		const __m128 c = _mm_setr_ps(centre.x, centre.y, centre.z, 0.0f);
+
+		float maxDistanceSquared = 0.0f;
+		for(std::size_t i = 0; i < count; ++i)
+		{
+			const __m128 p = (i + 1 < count) ? LoadPositionFollowed(pPositions + i) : LoadLastPosition(pPositions + i);
+			maxDistanceSquared = std::max(maxDistanceSquared, LengthSquared3(_mm_sub_ps(p, c)));
+		}
+
+		return BoundingSphere{ centre, std::sqrt(maxDistanceSquared) };
+	}
+
+	AABB TransformAABB(const AABB& bounds, const glm::mat4& matrix)
+	{
+		// Start with the translation
+		AABB result{ glm::vec3(matrix[3]), glm::vec3(matrix[3]) };
+
+		for(int column = 0; column < 3; ++column)
+		{
+			const glm::vec3 axis(matrix[column]);
+			const glm::vec3 a = axis * bounds.min[column];
+			const glm::vec3 b = axis * bounds.max[column];
+
+			result.min += glm::min(a, b);
+			result.max += glm::max(a, b);
+		}
+
+		return result;
+	}
+
+	BoundingSphere TransformBoundingSphere(const BoundingSphere& sphere, const glm::mat4& matrix)
+	{
+		const float maxScale = std::max({ glm::length(glm::vec3(matrix[0])),
+			glm::length(glm::vec3(matrix[1])), glm::length(glm::vec3(matrix[2])) });
+
+		return BoundingSphere{ glm::vec3(matrix * glm::vec4(sphere.centre, 1.0f)), sphere.radius * maxScale };
+	}
+
+	bool Intersects(const BoundingSphere& sphere, const AABB& bounds)
+	{
+		const glm::vec3 closest = glm::clamp(sphere.centre, bounds.min, bounds.max);
+		const glm::vec3 offset = sphere.centre - closest;
+
+		return glm::dot(offset, offset) <= sphere.radius * sphere.radius;
+	}
+}
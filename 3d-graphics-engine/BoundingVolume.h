@@ -0,0 +1,47 @@
+#ifndef BOUNDING_VOLUME_H
+#define BOUNDING_VOLUME_H
+
+#include <glm\glm.hpp>
+#include <cstddef>
+
+// An axis-aligned bounding box
+struct AABB
+{
+	glm::vec3 min;
+	glm::vec3 max;
+
+	glm::vec3 GetCentre() const { return (min + max) * 0.5f; }
+	glm::vec3 GetExtents() const { return (max - min) * 0.5f; }
+};
+
+struct BoundingSphere
+{
+	glm::vec3 centre;
+	float radius;
+};
+
+// Calculates and transforms the bounds of a set of positions, so that meshes and entities
+// can be tested against each other and the camera without looking at their vertices
+namespace BoundingVolume
+{
+	// Uses SSE to find the minimum and maximum of every axis at once.
+	// An empty set of positions has an empty box at the origin.
+	AABB CalculateAABB(const glm::vec3* pPositions, std::size_t count);
+
+	// The sphere is centred on the box, with a radius that reaches the furthest position.
+	// This is not the smallest possible sphere, but never larger than the box's own sphere.
+	BoundingSphere CalculateBoundingSphere(const glm::vec3* pPositions, std::size_t count, const AABB& bounds);
+
+	// Finds the box that encloses the transformed box, using Jim Arvo's method
+	// of adding up the smallest and largest contribution of each matrix element
+	AABB TransformAABB(const AABB& bounds, const glm::mat4& matrix);
+
+	// The radius is scaled by the largest scale of the matrix, so non-uniform scaling
+	// produces a sphere that is larger than necessary
+	BoundingSphere TransformBoundingSphere(const BoundingSphere& sphere, const glm::mat4& matrix);
+
+	// True if any part of the sphere is inside the box, found from the closest point of the box
+	bool Intersects(const BoundingSphere& sphere, const AABB& bounds);
+}
+
+#endif
@@ -16,12 +16,20 @@ namespace Constants
 	inline constexpr float NEAR_PLANE = 0.01f;
 	inline constexpr float FAR_PLANE = 100.0f;
 
-	// The maximum number of light sources supported
-	inline constexpr int MAX_LIGHTS = 4;
+	// The maximum number of lights that cast shadows, each has its own shadow map. There is no
+	// limit on the number of lights, the lights added after these are drawn without shadows.
+	inline constexpr int MAX_SHADOW_MAPS = 4;
 
 	// The number of MSAA samples
 	inline constexpr int MSAA_SAMPLES = 4;
 
+	// The time in milliseconds that may be spent uploading loaded meshes to the GPU each frame
+	inline constexpr double MESH_UPLOAD_BUDGET_MS = 2.0;
+
+	// The default limits on redrawing shadow maps when shadow updates are time sliced
+	inline constexpr int DEFAULT_SHADOW_UPDATES_PER_FRAME = 1;
+	inline constexpr float DEFAULT_SHADOW_BUDGET_MS = 1.0f;
+
 	// The number of anisotropic samples per pixel
 	inline constexpr float ANIOSTROPY = 8.0f;
 
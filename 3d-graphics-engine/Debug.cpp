@@ -1,4 +1,5 @@
 #include "Debug.h"
+#include "GLState.h"
 #include <GL\glew.h>
 #include <glm\glm.hpp>
 #include <cassert>
@@ -60,10 +61,10 @@ namespace Debug::Mesh
 		std::vector<glm::vec3> combined = GenerateNormalLines(positions, endpoint);
 
 		glGenVertexArrays(1, &g_normalsVaoID);
-		glBindVertexArray(g_normalsVaoID);
+		GLState::BindVertexArray(g_normalsVaoID);
 
 		glGenBuffers(1, &g_normalsBufferID);
-		glBindBuffer(GL_ARRAY_BUFFER, g_normalsBufferID);
+		GLState::BindBuffer(GL_ARRAY_BUFFER, g_normalsBufferID);
 
 		// Since combined is a pointer, we need to deference it to access the size of the first element.
 		glBufferData(GL_ARRAY_BUFFER, sizeof(combined[0]) * combined.size(),
@@ -1,4 +1,5 @@
 #include "DebugQuad.h"
+#include "GLState.h"
 #include "ShaderProgram.h"
 #include <glm\glm.hpp>
 #include <glm\gtc\matrix_transform.hpp>
@@ -20,8 +21,8 @@ DebugQuad::DebugQuad()
 	glGenVertexArrays(1, &m_VAO);
 	glGenBuffers(1, &m_VBO);
 
-	glBindVertexArray(m_VAO);
-	glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+	GLState::BindVertexArray(m_VAO);
+	GLState::BindBuffer(GL_ARRAY_BUFFER, m_VBO);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(quadVerts), &quadVerts, GL_STATIC_DRAW);
 
 	// Positional and texture coordinate data are interleaved
@@ -34,12 +35,12 @@ DebugQuad::DebugQuad()
 
 void DebugQuad::Render(GLsizei windowWidth, GLsizei windowHeight) const
 {
-	glBindVertexArray(m_VAO);
+	GLState::BindVertexArray(m_VAO);
 
-	glViewport(0, 0, windowWidth, windowHeight);
+	GLState::Viewport(0, 0, windowWidth, windowHeight);
 	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
-	glBindVertexArray(0);
+	GLState::BindVertexArray(0);
 }
 
 void DebugQuad::Bind() const
@@ -1,7 +1,7 @@
 #include "DirectionalLight.h"
-#include "ShaderProgram.h"
+#include "UniformBlocks.h"
 #include <glm/gtc/matrix_transform.hpp>
-#include <string>
+#include <cassert>
 
 int DirectionalLight::s_count = 0;
 
@@ -40,25 +40,25 @@ DirectionalLight::~DirectionalLight()
 	std::cout << "DirectionalLight [" << m_id << "] destroyed\n"; 
 }
 
-void DirectionalLight::SetUniforms(ShaderProgram* pShader, int shadowIndex)
+void DirectionalLight::WriteUniforms(DirectionalLightUniforms* pUniforms) const
 {
-	std::string idStr = std::to_string(m_id);
-
-	pShader->SetUniform("directionalLights[" + idStr + "].light.shadowIndex", shadowIndex);
-	pShader->SetUniform("directionalLights[" + idStr + "].light.ambient",  GetAmbient());
-	pShader->SetUniform("directionalLights[" + idStr + "].light.diffuse",  GetDiffuse());
-	pShader->SetUniform("directionalLights[" + idStr + "].light.specular", GetSpecular());
-	pShader->SetUniform("directionalLights[" + idStr + "].direction", m_direction);
+	DirectionalLightUniforms& uniforms = *pUniforms;
+	uniforms.light.shadowIndex = m_shadowIndex;
+	uniforms.light.ambient  = GetAmbient();
+	uniforms.light.diffuse  = GetDiffuse();
+	uniforms.light.specular = GetSpecular();
+	uniforms.direction = m_direction;
 }
 
 
 void DirectionalLight::SetDirection(const glm::vec3& direction)
 {
 	// Ignore the zero vector if given
-	if(glm::length(direction) > 0.0f)
+	if(glm::length(direction) > 0.0f && glm::normalize(direction) != m_direction)
 	{
 		// Normalise the vector before assigning
 		m_direction = glm::normalize(direction);
+		m_shadowDirty = true;
 
 		// Update this light's view matrix
 		m_shadowData->UpdateLightViewMatrix(CreateViewMatrix(m_direction));
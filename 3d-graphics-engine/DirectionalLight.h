@@ -4,6 +4,8 @@
 #include "Light.h"
 #include <glm/glm.hpp>
 
+struct DirectionalLightUniforms;
+
 glm::mat4 CreateViewMatrix(const glm::vec3& dir);
 
 class DirectionalLight : public Light
@@ -15,7 +17,8 @@ public:
 	DirectionalLight(const glm::vec3& direction, const glm::vec3& color, float intensity);
 	~DirectionalLight();
 
-	virtual void SetUniforms(ShaderProgram* pShader, int shadowIndex) override;
+	// Writes the light's attributes to its element of the directional light buffer
+	void WriteUniforms(DirectionalLightUniforms* pUniforms) const;
 
 	void SetDirection(const glm::vec3& direction);
 	const glm::vec3& GetDirection() const { return m_direction; }
@@ -1,3 +1,4 @@
+#include "BoundingVolume.h"
 #include "Entity.h"
 #include "Material.h"
 #include "Mesh.h"
@@ -13,6 +14,8 @@ Entity::Entity(Mesh* pMesh)
 	, m_position{ 0.0f, 0.0f, 0.0f }
 	, m_rotation{0.0, 0.0f, 0.0f}
 	, m_scale{ 1.0f, 1.0f, 1.0f }
+	, m_transformDirty{ false }
+	, m_previousWorldBounds{ glm::vec3(0.0f), glm::vec3(0.0f) }
 {
 }
 
@@ -27,7 +30,32 @@ void Entity::Render() const
 	m_pMesh->Render();
 }
 
+bool Entity::IsMeshLoaded() const
+{
+	return m_pMesh->IsLoaded();
+}
+
 glm::mat4 Entity::CalculateModelMatrix() const
+{
+	return CalculateTransform() * m_pMesh->GetDequantisationMatrix();
+}
+
+glm::mat4 Entity::CalculateNormalMatrix() const
+{
+	return CalculateTransform();
+}
+
+AABB Entity::CalculateWorldBounds() const
+{
+	return BoundingVolume::TransformAABB(m_pMesh->GetBounds(), CalculateTransform());
+}
+
+BoundingSphere Entity::CalculateWorldBoundingSphere() const
+{
+	return BoundingVolume::TransformBoundingSphere(m_pMesh->GetBoundingSphere(), CalculateTransform());
+}
+
+glm::mat4 Entity::CalculateTransform() const
 {
 	// Create translation matrix
 	glm::mat4 T = glm::translate(glm::mat4(1.0f), m_position);
@@ -42,3 +70,12 @@ glm::mat4 Entity::CalculateModelMatrix() const
 
 	return T * R * glm::scale(glm::mat4(1.0f), m_scale);
 }
+
+void Entity::OnTransformChanging()
+{
+	if(!m_transformDirty)
+	{
+		m_previousWorldBounds = CalculateWorldBounds();
+		m_transformDirty = true;
+	}
+}
@@ -1,6 +1,7 @@
 #ifndef ENTITY_H
 #define ENTITY_H
 
+#include "BoundingVolume.h"
 #include "Material.h"
 #include <glm\glm.hpp>
 #include <string>
@@ -27,38 +28,88 @@ class Entity
 
 	glm::vec3 m_scale;
 
+	// Set when the transform changes, so that shadow maps the entity appears in can be redrawn.
+	// The world bounds from before the first change are kept, since the entity's old shadow
+	// must be removed too.
+	bool m_transformDirty;
+	AABB m_previousWorldBounds;
+
 public:
 	Entity(Mesh* pMesh);
 
 	void Bind(ShaderProgram* pShader) const;
 
 	void Render() const;
+
+	// Returns false while the entity's mesh is still being loaded
+	bool IsMeshLoaded() const;
+
+	// Transforms the mesh's vertex positions to world space, including any dequantisation of the mesh
 	glm::mat4 CalculateModelMatrix() const;
 
+	// Transforms the mesh's normals to world space, the w component of the normal must be 0.
+	// Only uniform scaling is supported, so the normals only need to be renormalised afterwards.
+	glm::mat4 CalculateNormalMatrix() const;
+
+	// The world space bounds of the entity's mesh, these are empty while the mesh is loading
+	AABB CalculateWorldBounds() const;
+	BoundingSphere CalculateWorldBoundingSphere() const;
+
 	const glm::vec3& GetPosition() const { return m_position; }
 	glm::vec3 GetRotation() const { return { m_rotation.x, m_rotation.y, m_rotation.z }; }
 	const glm::vec3& GetScale()    const { return m_scale;    }
 	
-	void SetPosition(const glm::vec3& pos) { m_position = pos; }
+	void SetPosition(const glm::vec3& pos)
+	{
+		if(pos != m_position)
+		{
+			OnTransformChanging();
+			m_position = pos;
+		}
+	}
+
 	void SetRotation(float angleX, float angleY, float angleZ)
 	{
-		m_rotation.x = angleX;
-		m_rotation.y = angleY;
-		m_rotation.z = angleZ;
+		if(angleX != m_rotation.x || angleY != m_rotation.y || angleZ != m_rotation.z)
+		{
+			OnTransformChanging();
+			m_rotation.x = angleX;
+			m_rotation.y = angleY;
+			m_rotation.z = angleZ;
+		}
 	}
 
 	// Only allow for uniform scaling since the engine doesn't
 	// support non-uniform scaling
 	void SetScale(float factor)  
 	{
-		m_scale.x = factor;
-		m_scale.y = factor;
-		m_scale.z = factor;
+		if(glm::vec3(factor) != m_scale)
+		{
+			OnTransformChanging();
+			m_scale.x = factor;
+			m_scale.y = factor;
+			m_scale.z = factor;
+		}
 	}
 
+	// True if the transform has changed since ClearTransformDirty() was last called
+	bool IsTransformDirty() const { return m_transformDirty; }
+	const AABB& GetPreviousWorldBounds() const { return m_previousWorldBounds; }
+	void ClearTransformDirty() { m_transformDirty = false; }
+
+	const Mesh* GetMesh() const { return m_pMesh; }
+
 	void SetShader(ShaderProgram* pShader) { m_pShader = pShader; }
 	Material* GetMaterial() { return &m_material; }
+	const Material* GetMaterial() const { return &m_material; }
 	ShaderProgram* GetShader() const { return m_pShader; }
+
+private:
+	// The translation, rotation and scale of the entity
+	glm::mat4 CalculateTransform() const;
+
+	// Must be called before the transform is changed
+	void OnTransformChanging();
 };
 
 #endif
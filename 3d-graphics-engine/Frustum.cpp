@@ -0,0 +1,177 @@
+#include "BoundingVolume.h"
+#include "Frustum.h"
+#include <glm\glm.hpp>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <xmmintrin.h>
+
+namespace
+{
+	bool IsInsidePlanes(const glm::vec4* pPlanes, std::size_t numPlanes,
+		const glm::vec3& centre, const glm::vec3& extents, float radius)
+	{
+		for(std::size_t i = 0; i < numPlanes; ++i)
+		{
+			const glm::vec3 normal(pPlanes[i]);
+			const float distance = glm::dot(normal, centre) + pPlanes[i].w;
+
+			// The distance the box reaches towards the plane
+			const float boxRadius = glm::dot(glm::abs(normal), extents);
+
+			if(distance < -std::min(radius, boxRadius))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
+
+void CullingBounds::Add(const AABB& bounds, const BoundingSphere& sphere)
+{
+	const glm::vec3 centre = bounds.GetCentre();
+	const glm::vec3 extents = bounds.GetExtents();
+
+	m_centreX.push_back(centre.x);
+	m_centreY.push_back(centre.y);
+	m_centreZ.push_back(centre.z);
+	m_extentX.push_back(extents.x);
+	m_extentY.push_back(extents.y);
+	m_extentZ.push_back(extents.z);
+	m_radius.push_back(sphere.radius);
+}
+
+void CullingBounds::Clear()
+{
+	m_centreX.clear();
+	m_centreY.clear();
+	m_centreZ.clear();
+	m_extentX.clear();
+	m_extentY.clear();
+	m_extentZ.clear();
+	m_radius.clear();
+}
+
+AABB CullingBounds::GetAABB(std::size_t index) const
+{
+	const glm::vec3 centre(m_centreX[index], m_centreY[index], m_centreZ[index]);
+	const glm::vec3 extents(m_extentX[index], m_extentY[index], m_extentZ[index]);
+
+	return AABB{ centre - extents, centre + extents };
+}
+
+Frustum::Frustum(const glm::mat4& viewProjection)
+{
+	// The rows of the matrix, glm stores matrices by column
+	std::array<glm::vec4, 4> rows;
+	for(int i = 0; i < 4; ++i)
+	{
+		rows[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+	}
+
+	// A point is inside when -w <= x, y, z <= w in clip space
+	m_planes[LEFT_PLANE]   = rows[3] + rows[0];
+	m_planes[RIGHT_PLANE]  = rows[3] - rows[0];
+	m_planes[BOTTOM_PLANE] = rows[3] + rows[1];
+	m_planes[TOP_PLANE]    = rows[3] - rows[1];
+	m_planes[NEAR_PLANE]   = rows[3] + rows[2];
+	m_planes[FAR_PLANE]    = rows[3] - rows[2];
+
+	// Normalise so that the planes give the true distance to a point
+	for(glm::vec4& plane : m_planes)
+	{
+		plane /= glm::length(glm::vec3(plane));
+	}
+}
+
+bool Frustum::IsVisible(const AABB& bounds) const
+{
+	return IsInsidePlanes(m_planes.data(), m_planes.size(), bounds.GetCentre(), bounds.GetExtents(), FLT_MAX);
+}
+
+bool Frustum::IsVisible(const BoundingSphere& sphere) const
+{
+	return IsInsidePlanes(m_planes.data(), m_planes.size(), sphere.centre, glm::vec3(FLT_MAX), sphere.radius);
+}
+
+void Frustum::TestVisibility(const CullingBounds& bounds, std::vector<std::uint8_t>* pVisible) const
+{
+	TestPlanes(m_planes.data(), m_planes.size(), bounds, pVisible);
+}
+
+void Frustum::TestSweptVisibility(const CullingBounds& bounds, const glm::vec3& direction,
+	std::vector<std::uint8_t>* pVisible) const
+{
+	// Sweeping an object that is outside a plane only brings it inside if the direction points
+	// into the frustum, so only the planes facing away from the direction can cull it
+	std::array<glm::vec4, NUM_PLANES> planes;
+	std::size_t numPlanes = 0;
+
+	for(const glm::vec4& plane : m_planes)
+	{
+		if(glm::dot(glm::vec3(plane), direction) <= 0.0f)
+		{
+			planes[numPlanes++] = plane;
+		}
+	}
+
+	TestPlanes(planes.data(), numPlanes, bounds, pVisible);
+}
+
+void Frustum::TestPlanes(const glm::vec4* pPlanes, std::size_t numPlanes, const CullingBounds& bounds,
+	std::vector<std::uint8_t>* pVisible)
+{
+	const std::size_t count = bounds.GetSize();
+	pVisible->resize(count);
+
+	std::size_t i = 0;
+	for(; i + 4 <= count; i += 4)
+	{
+		const __m128 centreX = _mm_loadu_ps(&bounds.m_centreX[i]);
+		const __m128 centreY = _mm_loadu_ps(&bounds.m_centreY[i]);
+		const __m128 centreZ = _mm_loadu_ps(&bounds.m_centreZ[i]);
+		const __m128 extentX = _mm_loadu_ps(&bounds.m_extentX[i]);
+		const __m128 extentY = _mm_loadu_ps(&bounds.m_extentY[i]);
+		const __m128 extentZ = _mm_loadu_ps(&bounds.m_extentZ[i]);
+		const __m128 radius  = _mm_loadu_ps(&bounds.m_radius[i]);
+
+		__m128 outside = _mm_setzero_ps();
+		for(std::size_t p = 0; p < numPlanes; ++p)
+		{
+			const glm::vec4& plane = pPlanes[p];
+
+			const __m128 distance = _mm_add_ps(_mm_add_ps(
+				_mm_mul_ps(_mm_set1_ps(plane.x), centreX),
+				_mm_mul_ps(_mm_set1_ps(plane.y), centreY)), _mm_add_ps(
+				_mm_mul_ps(_mm_set1_ps(plane.z), centreZ), _mm_set1_ps(plane.w)));
+
+			const __m128 boxRadius = _mm_add_ps(_mm_add_ps(
+				_mm_mul_ps(_mm_set1_ps(std::abs(plane.x)), extentX),
+				_mm_mul_ps(_mm_set1_ps(std::abs(plane.y)), extentY)),
+				_mm_mul_ps(_mm_set1_ps(std::abs(plane.z)), extentZ));
+
+			const __m128 minusReach = _mm_sub_ps(_mm_setzero_ps(), _mm_min_ps(radius, boxRadius));
+			outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, minusReach));
+		}
+
+		const int outsideMask = _mm_movemask_ps(outside);
+		for(int lane = 0; lane < 4; ++lane)
+		{
+			(*pVisible)[i + lane] = (outsideMask & (1 << lane)) ? 0 : 1;
+		}
+	}
+
+	// The objects that do not fill a whole register
+	for(; i < count; ++i)
+	{
+		const glm::vec3 centre(bounds.m_centreX[i], bounds.m_centreY[i], bounds.m_centreZ[i]);
+		const glm::vec3 extents(bounds.m_extentX[i], bounds.m_extentY[i], bounds.m_extentZ[i]);
+
+		(*pVisible)[i] = IsInsidePlanes(pPlanes, numPlanes, centre, extents, bounds.m_radius[i]) ? 1 : 0;
+	}
+}
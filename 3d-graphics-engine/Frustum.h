@@ -0,0 +1,78 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include "BoundingVolume.h"
+#include <glm\glm.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// The world space bounds of many objects stored as separate arrays per component,
+// so that four objects can be loaded into SSE registers at once
+class CullingBounds
+{
+	friend class Frustum;
+
+	std::vector<float> m_centreX;
+	std::vector<float> m_centreY;
+	std::vector<float> m_centreZ;
+	std::vector<float> m_extentX;
+	std::vector<float> m_extentY;
+	std::vector<float> m_extentZ;
+	std::vector<float> m_radius;
+
+public:
+	// The box and sphere must share a centre, which is true for the bounds of a mesh
+	// transformed by BoundingVolume::TransformAABB and TransformBoundingSphere
+	void Add(const AABB& bounds, const BoundingSphere& sphere);
+
+	// Removes every object while keeping the memory for the next frame
+	void Clear();
+
+	AABB GetAABB(std::size_t index) const;
+
+	std::size_t GetSize() const { return m_radius.size(); }
+};
+
+// The volume of space that a view-projection matrix maps onto the screen
+class Frustum
+{
+	enum Plane
+	{
+		LEFT_PLANE,
+		RIGHT_PLANE,
+		BOTTOM_PLANE,
+		TOP_PLANE,
+		NEAR_PLANE,
+		FAR_PLANE,
+
+		NUM_PLANES
+	};
+
+	// Each plane is stored as (normal, distance) with the normal pointing into the frustum
+	std::array<glm::vec4, NUM_PLANES> m_planes;
+
+	static void TestPlanes(const glm::vec4* pPlanes, std::size_t numPlanes, const CullingBounds& bounds,
+		std::vector<std::uint8_t>* pVisible);
+
+public:
+	// Extracts the planes from the matrix using the Gribb-Hartmann method
+	explicit Frustum(const glm::mat4& viewProjection);
+
+	// False only if the bounds are completely outside one of the planes, objects near the corners
+	// of the frustum may be reported as visible even though they are not
+	bool IsVisible(const AABB& bounds) const;
+	bool IsVisible(const BoundingSphere& sphere) const;
+
+	// Tests four objects at a time, an object is culled if either its box or its sphere is outside
+	// of a plane. pVisible is resized to the number of objects and set to 1 for each visible one.
+	void TestVisibility(const CullingBounds& bounds, std::vector<std::uint8_t>* pVisible) const;
+
+	// Like TestVisibility, but each object is swept infinitely along the direction first. This finds
+	// the objects that can cast a shadow into the frustum from a light shining in that direction.
+	void TestSweptVisibility(const CullingBounds& bounds, const glm::vec3& direction,
+		std::vector<std::uint8_t>* pVisible) const;
+};
+
+#endif
@@ -0,0 +1,127 @@
+#include "GBuffer.h"
+#include "GLState.h"
+#include <GL\glew.h>
+#include <cassert>
+#include <iostream>
+
+namespace
+{
+	// Positions need full precision so that shadow map lookups do not acne, the rest fit in less
+	struct TargetFormat
+	{
+		GLint internalFormat;
+		GLenum type;
+	};
+
+	constexpr TargetFormat TARGET_FORMATS[GBuffer::NUM_TARGETS] = {
+		{ GL_RGBA32F, GL_FLOAT },
+		{ GL_RGBA16F, GL_FLOAT },
+		{ GL_RGBA8, GL_UNSIGNED_BYTE },
+		{ GL_RGBA8, GL_UNSIGNED_BYTE }
+	};
+
+	void AllocateTexture(GLuint textureID, GLint internalFormat, GLenum format, GLenum type,
+		GLsizei width, GLsizei height)
+	{
+		GLState::BindTexture(GL_TEXTURE_2D, textureID);
+		glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, type, nullptr);
+	}
+}
+
+GBuffer::GBuffer()
+	: m_frameBufferID(0)
+	, m_targetIDs{}
+	, m_depthID(0)
+	, m_width(0)
+	, m_height(0)
+{
+	glGenTextures(NUM_TARGETS, m_targetIDs.data());
+	glGenTextures(1, &m_depthID);
+	glGenFramebuffers(1, &m_frameBufferID);
+
+	// The targets are read one texel per pixel, so they are never filtered
+	for(int i = 0; i <= NUM_TARGETS; ++i)
+	{
+		GLState::BindTexture(GL_TEXTURE_2D, i < NUM_TARGETS ? m_targetIDs[i] : m_depthID);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	}
+
+	GLState::BindFramebuffer(m_frameBufferID);
+
+	std::array<GLenum, NUM_TARGETS> drawBuffers;
+	for(int i = 0; i < NUM_TARGETS; ++i)
+	{
+		glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, m_targetIDs[i], 0);
+		drawBuffers[i] = GL_COLOR_ATTACHMENT0 + i;
+	}
+	glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_depthID, 0);
+	glDrawBuffers(NUM_TARGETS, drawBuffers.data());
+
+	GLState::BindFramebuffer(0);
+}
+
+GBuffer::~GBuffer()
+{
+	GLState::DeleteFramebuffers(1, &m_frameBufferID);
+	GLState::DeleteTextures(NUM_TARGETS, m_targetIDs.data());
+	GLState::DeleteTextures(1, &m_depthID);
+}
+
+void GBuffer::Resize(GLsizei width, GLsizei height)
+{
+	// A framebuffer with empty attachments is incomplete, so the targets are kept until the
+	// window has a size again
+	if(width == 0 || height == 0 || (width == m_width && height == m_height))
+	{
+		return;
+	}
+
+	m_width = width;
+	m_height = height;
+
+	for(int i = 0; i < NUM_TARGETS; ++i)
+	{
+		AllocateTexture(m_targetIDs[i], TARGET_FORMATS[i].internalFormat, GL_RGBA, TARGET_FORMATS[i].type,
+			width, height);
+	}
+	AllocateTexture(m_depthID, GL_DEPTH_COMPONENT32F, GL_DEPTH_COMPONENT, GL_FLOAT, width, height);
+
+	GLState::BindFramebuffer(m_frameBufferID);
+	if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+	{
+		std::cerr << "G-buffer framebuffer of " << width << "x" << height << " is incomplete\n";
+		assert(false && "G-buffer framebuffer is incomplete");
+	}
+	GLState::BindFramebuffer(0);
+}
+
+void GBuffer::Write() const
+{
+	GLState::BindFramebuffer(m_frameBufferID);
+	GLState::Viewport(0, 0, m_width, m_height);
+}
+
+void GBuffer::Clear() const
+{
+	// The other targets are always written where the normal is
+	constexpr GLfloat ZERO[4]{ 0.0f, 0.0f, 0.0f, 0.0f };
+	constexpr GLfloat FAR_DEPTH = 1.0f;
+
+	glClearBufferfv(GL_COLOR, NORMAL, ZERO);
+	glClearBufferfv(GL_DEPTH, 0, &FAR_DEPTH);
+}
+
+void GBuffer::Read() const
+{
+	for(int i = 0; i < NUM_TARGETS; ++i)
+	{
+		GLState::ActiveTexture(GL_TEXTURE0 + START_TEXTURE_SLOT + i);
+		GLState::BindTexture(GL_TEXTURE_2D, m_targetIDs[i]);
+	}
+
+	GLState::ActiveTexture(GL_TEXTURE0 + DEPTH_TEXTURE_SLOT);
+	GLState::BindTexture(GL_TEXTURE_2D, m_depthID);
+}
@@ -0,0 +1,69 @@
+#ifndef GBUFFER_H
+#define GBUFFER_H
+
+#include "Constants.h"
+#include "ShadowMap.h"
+#include <GL\glew.h>
+#include <array>
+
+// The framebuffer the geometry pass of deferred shading writes each pixel's surface into, so
+// that the lighting passes only light the surface that ends up visible
+class GBuffer
+{
+public:
+	// The colour targets, in the order of the geometry shader's outputs
+	enum Target
+	{
+		// World space position in xyz, the material's shininess in w
+		POSITION,
+
+		// World space normal in xyz, a zero normal marks a pixel that nothing was drawn to
+		NORMAL,
+
+		// The diffuse colour, which is also used as the ambient colour
+		ALBEDO,
+
+		// The specular colour
+		SPECULAR,
+
+		NUM_TARGETS
+	};
+
+	// The targets are read from the texture units after the shadow maps, in the order of
+	// Target followed by the depth. These match the sampler bindings of the deferred shaders.
+	static constexpr int START_TEXTURE_SLOT = ShadowMap::START_TEXTURE_SLOT + Constants::MAX_SHADOW_MAPS;
+	static constexpr int DEPTH_TEXTURE_SLOT = START_TEXTURE_SLOT + NUM_TARGETS;
+
+private:
+	GLuint m_frameBufferID;
+	std::array<GLuint, NUM_TARGETS> m_targetIDs;
+	GLuint m_depthID;
+
+	GLsizei m_width;
+	GLsizei m_height;
+
+public:
+	GBuffer();
+	~GBuffer();
+
+	GBuffer(const GBuffer&) = delete;
+	GBuffer& operator=(const GBuffer&) = delete;
+
+	// Reallocates the targets if the size has changed, they must match the window's size.
+	// An empty size, such as that of a minimised window, is ignored.
+	void Resize(GLsizei width, GLsizei height);
+
+	// Binds the framebuffer for the geometry pass
+	void Write() const;
+
+	// Clears the normals, which mark the pixels that are drawn to, and the depth of the bound G-buffer
+	void Clear() const;
+
+	// Binds every target and the depth to their texture units for the lighting passes
+	void Read() const;
+
+	GLsizei GetWidth()  const { return m_width; }
+	GLsizei GetHeight() const { return m_height; }
+};
+
+#endif
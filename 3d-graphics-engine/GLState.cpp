@@ -0,0 +1,381 @@
+#include "GLState.h"
+#include <GL\glew.h>
+#include <array>
+#include <cassert>
+#include <limits>
+#include <utility>
+
+namespace
+{
+	// A name that GL never uses for an object, so that the first call of each kind is always sent
+	constexpr GLuint UNKNOWN = ~0u;
+	constexpr GLenum UNKNOWN_ENUM = ~0u;
+
+	constexpr int MAX_TEXTURE_UNITS = 16;
+	constexpr int MAX_BUFFER_BINDINGS = 16;
+
+	// The targets that are tracked, calls for any other target are always sent
+	constexpr std::array<GLenum, 2> TEXTURE_TARGETS = { GL_TEXTURE_2D, GL_TEXTURE_CUBE_MAP };
+	constexpr std::array<GLenum, 3> BUFFER_TARGETS = { GL_ARRAY_BUFFER, GL_SHADER_STORAGE_BUFFER, GL_UNIFORM_BUFFER };
+	constexpr std::array<GLenum, 9> CAPABILITIES = {
+		GL_CULL_FACE, GL_DEPTH_TEST, GL_BLEND, GL_MULTISAMPLE, GL_POLYGON_OFFSET_FILL,
+		GL_PRIMITIVE_RESTART, GL_RASTERIZER_DISCARD, GL_TEXTURE_CUBE_MAP_SEAMLESS, GL_DEPTH_CLAMP
+	};
+
+	// 0 and 1 for disabled and enabled
+	constexpr int UNKNOWN_CAPABILITY = -1;
+
+	struct State
+	{
+		GLuint program;
+		GLuint vertexArray;
+		GLuint framebuffer;
+		GLenum activeTexture;
+
+		std::array<std::array<GLuint, TEXTURE_TARGETS.size()>, MAX_TEXTURE_UNITS> textures;
+		std::array<GLuint, BUFFER_TARGETS.size()> buffers;
+		std::array<std::array<GLuint, MAX_BUFFER_BINDINGS>, BUFFER_TARGETS.size()> indexedBuffers;
+		std::array<int, CAPABILITIES.size()> capabilities;
+
+		std::array<GLint, 4> viewport;
+		int depthMask;
+		int colourMask;
+		GLenum depthFunc;
+		GLenum cullFace;
+		std::pair<GLenum, GLenum> blendFunc;
+		GLenum frontFace;
+		GLenum polygonMode;
+		std::pair<float, float> polygonOffset;
+	};
+
+	State CreateUnknownState()
+	{
+		State state;
+		state.program = UNKNOWN;
+		state.vertexArray = UNKNOWN;
+		state.framebuffer = UNKNOWN;
+		state.activeTexture = UNKNOWN_ENUM;
+
+		for(auto& unit : state.textures)
+		{
+			unit.fill(UNKNOWN);
+		}
+
+		state.buffers.fill(UNKNOWN);
+		for(auto& target : state.indexedBuffers)
+		{
+			target.fill(UNKNOWN);
+		}
+
+		state.capabilities.fill(UNKNOWN_CAPABILITY);
+		state.viewport.fill(-1);
+		state.depthMask = UNKNOWN_CAPABILITY;
+		state.colourMask = UNKNOWN_CAPABILITY;
+		state.depthFunc = UNKNOWN_ENUM;
+		state.cullFace = UNKNOWN_ENUM;
+		state.blendFunc = std::make_pair(UNKNOWN_ENUM, UNKNOWN_ENUM);
+		state.frontFace = UNKNOWN_ENUM;
+		state.polygonMode = UNKNOWN_ENUM;
+
+		// NaN never compares equal, so the first offset is always sent
+		const float unknownOffset = std::numeric_limits<float>::quiet_NaN();
+		state.polygonOffset = std::make_pair(unknownOffset, unknownOffset);
+
+		return state;
+	}
+
+	State g_state = CreateUnknownState();
+	GLState::Stats g_stats{};
+
+	// Returns the index of the value in the array, or -1 if it is not there
+	template <typename T, std::size_t N>
+	int Find(const std::array<T, N>& values, T value)
+	{
+		for(std::size_t i = 0; i < N; ++i)
+		{
+			if(values[i] == value)
+			{
+				return static_cast<int>(i);
+			}
+		}
+
+		return -1;
+	}
+
+	// Updates the remembered value, returning false if the call can be dropped
+	template <typename T>
+	bool Change(T* pCurrent, const T& value)
+	{
+		if(*pCurrent == value)
+		{
+			++g_stats.numElidedCalls;
+			return false;
+		}
+
+		*pCurrent = value;
+		++g_stats.numCalls;
+		return true;
+	}
+
+	// Counts a call for state that is not tracked
+	bool PassThrough()
+	{
+		++g_stats.numCalls;
+		return true;
+	}
+}
+
+namespace GLState
+{
+	void UseProgram(GLuint program)
+	{
+		if(Change(&g_state.program, program))
+		{
+			glUseProgram(program);
+		}
+	}
+
+	void BindVertexArray(GLuint vertexArray)
+	{
+		if(Change(&g_state.vertexArray, vertexArray))
+		{
+			glBindVertexArray(vertexArray);
+		}
+	}
+
+	void BindBuffer(GLenum target, GLuint buffer)
+	{
+		assert(target != GL_ELEMENT_ARRAY_BUFFER && "The element array buffer belongs to the vertex array");
+
+		const int targetIndex = Find(BUFFER_TARGETS, target);
+		if(targetIndex < 0 ? PassThrough() : Change(&g_state.buffers[targetIndex], buffer))
+		{
+			glBindBuffer(target, buffer);
+		}
+	}
+
+	void BindBufferBase(GLenum target, GLuint index, GLuint buffer)
+	{
+		const int targetIndex = Find(BUFFER_TARGETS, target);
+		if(targetIndex < 0 || index >= MAX_BUFFER_BINDINGS)
+		{
+			PassThrough();
+			glBindBufferBase(target, index, buffer);
+
+			// The generic binding is changed too
+			if(targetIndex >= 0)
+			{
+				g_state.buffers[targetIndex] = buffer;
+			}
+			return;
+		}
+
+		if(Change(&g_state.indexedBuffers[targetIndex][index], buffer))
+		{
+			glBindBufferBase(target, index, buffer);
+			g_state.buffers[targetIndex] = buffer;
+		}
+	}
+
+	void ActiveTexture(GLenum unit)
+	{
+		if(Change(&g_state.activeTexture, unit))
+		{
+			glActiveTexture(unit);
+		}
+	}
+
+	void BindTexture(GLenum target, GLuint texture)
+	{
+		const int unit = static_cast<int>(g_state.activeTexture - GL_TEXTURE0);
+		const int targetIndex = Find(TEXTURE_TARGETS, target);
+
+		// The active unit is unknown until ActiveTexture() has been called
+		const bool tracked = g_state.activeTexture != UNKNOWN_ENUM && unit < MAX_TEXTURE_UNITS && targetIndex >= 0;
+		if(!tracked ? PassThrough() : Change(&g_state.textures[unit][targetIndex], texture))
+		{
+			glBindTexture(target, texture);
+		}
+	}
+
+	void BindFramebuffer(GLuint framebuffer)
+	{
+		if(Change(&g_state.framebuffer, framebuffer))
+		{
+			glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+		}
+	}
+
+	void Viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+	{
+		if(Change(&g_state.viewport, std::array<GLint, 4>{ x, y, width, height }))
+		{
+			glViewport(x, y, width, height);
+		}
+	}
+
+	void SetEnabled(GLenum capability, bool enabled)
+	{
+		const int index = Find(CAPABILITIES, capability);
+		if(index < 0 ? PassThrough() : Change(&g_state.capabilities[index], enabled ? 1 : 0))
+		{
+			if(enabled)
+			{
+				glEnable(capability);
+			}
+			else
+			{
+				glDisable(capability);
+			}
+		}
+	}
+
+	void DepthMask(bool enabled)
+	{
+		if(Change(&g_state.depthMask, enabled ? 1 : 0))
+		{
+			glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+		}
+	}
+
+	void ColourMask(bool enabled)
+	{
+		if(Change(&g_state.colourMask, enabled ? 1 : 0))
+		{
+			const GLboolean mask = enabled ? GL_TRUE : GL_FALSE;
+			glColorMask(mask, mask, mask, mask);
+		}
+	}
+
+	void DepthFunc(GLenum func)
+	{
+		if(Change(&g_state.depthFunc, func))
+		{
+			glDepthFunc(func);
+		}
+	}
+
+	void CullFace(GLenum mode)
+	{
+		if(Change(&g_state.cullFace, mode))
+		{
+			glCullFace(mode);
+		}
+	}
+
+	void BlendFunc(GLenum sourceFactor, GLenum destFactor)
+	{
+		if(Change(&g_state.blendFunc, std::make_pair(sourceFactor, destFactor)))
+		{
+			glBlendFunc(sourceFactor, destFactor);
+		}
+	}
+
+	void FrontFace(GLenum mode)
+	{
+		if(Change(&g_state.frontFace, mode))
+		{
+			glFrontFace(mode);
+		}
+	}
+
+	void PolygonMode(GLenum mode)
+	{
+		if(Change(&g_state.polygonMode, mode))
+		{
+			glPolygonMode(GL_FRONT_AND_BACK, mode);
+		}
+	}
+
+	void PolygonOffset(float factor, float units)
+	{
+		if(Change(&g_state.polygonOffset, std::make_pair(factor, units)))
+		{
+			glPolygonOffset(factor, units);
+		}
+	}
+
+	void DeleteVertexArrays(GLsizei count, const GLuint* pVertexArrays)
+	{
+		for(GLsizei i = 0; i < count; ++i)
+		{
+			if(g_state.vertexArray == pVertexArrays[i])
+			{
+				g_state.vertexArray = 0;
+			}
+		}
+
+		glDeleteVertexArrays(count, pVertexArrays);
+	}
+
+	void DeleteBuffers(GLsizei count, const GLuint* pBuffers)
+	{
+		for(GLsizei i = 0; i < count; ++i)
+		{
+			for(std::size_t target = 0; target < BUFFER_TARGETS.size(); ++target)
+			{
+				if(g_state.buffers[target] == pBuffers[i])
+				{
+					g_state.buffers[target] = 0;
+				}
+
+				for(GLuint& binding : g_state.indexedBuffers[target])
+				{
+					if(binding == pBuffers[i])
+					{
+						binding = 0;
+					}
+				}
+			}
+		}
+
+		glDeleteBuffers(count, pBuffers);
+	}
+
+	void DeleteFramebuffers(GLsizei count, const GLuint* pFramebuffers)
+	{
+		for(GLsizei i = 0; i < count; ++i)
+		{
+			if(g_state.framebuffer == pFramebuffers[i])
+			{
+				g_state.framebuffer = 0;
+			}
+		}
+
+		glDeleteFramebuffers(count, pFramebuffers);
+	}
+
+	void DeleteTextures(GLsizei count, const GLuint* pTextures)
+	{
+		for(GLsizei i = 0; i < count; ++i)
+		{
+			for(auto& unit : g_state.textures)
+			{
+				for(GLuint& binding : unit)
+				{
+					if(binding == pTextures[i])
+					{
+						binding = 0;
+					}
+				}
+			}
+		}
+
+		glDeleteTextures(count, pTextures);
+	}
+
+	void Invalidate()
+	{
+		g_state = CreateUnknownState();
+	}
+
+	const Stats& GetStats()
+	{
+		return g_stats;
+	}
+
+	void ResetStats()
+	{
+		g_stats = Stats{};
+	}
+}
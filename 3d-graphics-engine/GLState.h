@@ -0,0 +1,69 @@
+#ifndef GL_STATE_H
+#define GL_STATE_H
+
+#include <GL\glew.h>
+
+// Remembers the GL state the engine has set, so that calls which would not change anything are
+// never sent to the driver. Every bind and enable the engine makes must go through here, otherwise
+// the remembered state no longer matches GL's. Code outside the engine that changes state without
+// restoring it must be followed by Invalidate().
+//
+// The element array buffer is not tracked, since it belongs to the bound vertex array.
+namespace GLState
+{
+	// Counts the calls made through the cache since ResetStats()
+	struct Stats
+	{
+		// Calls that were sent to the driver
+		int numCalls;
+
+		// Calls that were dropped because the state was already set
+		int numElidedCalls;
+	};
+
+	void UseProgram(GLuint program);
+	void BindVertexArray(GLuint vertexArray);
+
+	// GL_ELEMENT_ARRAY_BUFFER must be bound directly, after binding the vertex array it belongs to
+	void BindBuffer(GLenum target, GLuint buffer);
+
+	// Binds the buffer to an indexed binding point, which also binds it to the generic target
+	void BindBufferBase(GLenum target, GLuint index, GLuint buffer);
+
+	// unit is GL_TEXTURE0 + i
+	void ActiveTexture(GLenum unit);
+
+	// Binds the texture to the active texture unit
+	void BindTexture(GLenum target, GLuint texture);
+
+	// Binds the framebuffer for both drawing and reading
+	void BindFramebuffer(GLuint framebuffer);
+
+	void Viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+	// glEnable or glDisable
+	void SetEnabled(GLenum capability, bool enabled);
+
+	void DepthMask(bool enabled);
+	void ColourMask(bool enabled);
+	void DepthFunc(GLenum func);
+	void CullFace(GLenum mode);
+	void BlendFunc(GLenum sourceFactor, GLenum destFactor);
+	void FrontFace(GLenum mode);
+	void PolygonMode(GLenum mode);
+	void PolygonOffset(float factor, float units);
+
+	// Deletes the objects and forgets any bindings of them, since GL may reuse their names
+	void DeleteVertexArrays(GLsizei count, const GLuint* pVertexArrays);
+	void DeleteBuffers(GLsizei count, const GLuint* pBuffers);
+	void DeleteFramebuffers(GLsizei count, const GLuint* pFramebuffers);
+	void DeleteTextures(GLsizei count, const GLuint* pTextures);
+
+	// Forgets every remembered state, so that the next call of each kind is sent to the driver
+	void Invalidate();
+
+	const Stats& GetStats();
+	void ResetStats();
+}
+
+#endif
@@ -6,6 +6,7 @@
 #include "DirectionalLight.h"
 #include "Entity.h"
 #include "GraphicsEngine.h"
+#include "GLState.h"
 #include "Light.h"
 #include "MeshCreator.h"
 #include "MeshLoader.h"
@@ -16,13 +17,12 @@
 #include <glm\glm.hpp>
 #include <iostream>
 #include <cassert>
+#include <limits>
+#include <thread>
 
 GraphicsEngine::GraphicsEngine(Window* window)
 	: m_window(window)
 	, m_camera(window->GetWidth(), window->GetHeight())
-	, m_numLights(0)
-	, m_directionalLightCount(0)
-	, m_pointLightCount(0)
 	, m_renderer(this, m_camera, m_lights, m_globalAmbientLight)
 	, m_uiController(this)
 	, m_skybox(nullptr)
@@ -39,7 +39,7 @@ GraphicsEngine::GraphicsEngine(Window* window)
 	m_systemData.version  = glGetString(GL_VERSION);
 
 	// Enable multisampling 
-	glEnable(GL_MULTISAMPLE);
+	GLState::SetEnabled(GL_MULTISAMPLE, true);
 
 	// Create internal meshes (primitives)
 	m_meshManager.CreateMesh("plane", MeshCreator::CreatePlane(4));
@@ -58,9 +58,9 @@ GraphicsEngine::~GraphicsEngine()
 	}
 
 	std::cout << "Freeing all lights\n";
-	for(int i = 0; i < m_numLights; ++i)
+	for(Light* pLight : m_lights)
 	{
-		delete m_lights[i];
+		delete pLight;
 	}
 
 	// Delete skybox
@@ -70,9 +70,10 @@ GraphicsEngine::~GraphicsEngine()
 	}
 }
 
-void GraphicsEngine::AddMesh(const std::string& filename)
+void GraphicsEngine::AddMesh(const std::string& filename, const MeshLoadOptions& options)
 {
-	m_meshManager.CreateMesh(filename);
+	// The mesh can be used straight away, it is drawn once it has finished loading
+	m_meshManager.CreateMeshAsync(filename, options);
 }
 
 void GraphicsEngine::AddShader(const std::string& dirName)
@@ -90,35 +91,34 @@ void GraphicsEngine::AddTexture(const std::string& filename)
 
 void GraphicsEngine::AddLight(Light* pLight)
 {
-	if(m_numLights >= Constants::MAX_LIGHTS)
+	// Lights past the shadow map limit are still drawn, but do not cast shadows
+	if(GetLightCount() < Constants::MAX_SHADOW_MAPS)
 	{
-		// Assumes that the pointer is to memory on the heap
-		delete pLight;
-		assert(false && "Maximum light capacity reached");
+		pLight->SetShadowIndex(GetLightCount());
 	}
-	else
-	{
-		m_lights[m_numLights] = pLight;
-		m_numLights++;
 
-		std::cout << "Created " << m_numLights << "/" << Constants::MAX_LIGHTS << " lights\n";
-	}
+	m_lights.push_back(pLight);
+
+	std::cout << "Created " << GetLightCount() << " lights, " << GetShadowedLightCount() << "/"
+		<< Constants::MAX_SHADOW_MAPS << " cast shadows\n";
 }
 
 void GraphicsEngine::CreatePointLight(const glm::vec3& position, const glm::vec3& color,
-	float intensity)
+	float intensity, const PointLight::Attenuation& attenuation)
 {
 	// Keep track of each light by name
 	//m_lightFreq.Add("PointLight");
 	m_uiController.AddSceneObject("PointLight");
 
-	PointLight* pPointLight = new PointLight(position, color, intensity);
+	PointLight* pPointLight = new PointLight(position, color, intensity, attenuation);
 
-	// Allow for shadow mapping with point lights
-	pPointLight->CreateShadowData(GetWindowWidth() / GetWindowHeight());
+	// Allow for shadow mapping with point lights, if there is a shadow map left for it
+	if(GetLightCount() < Constants::MAX_SHADOW_MAPS)
+	{
+		pPointLight->CreateShadowData(GetWindowWidth() / GetWindowHeight());
+	}
 
 	AddLight(pPointLight);
-	m_pointLightCount++;
 
 	// Store point light data separately for easier point light drawing
 	m_pointLights.push_back(pPointLight);
@@ -129,8 +129,10 @@ void GraphicsEngine::CreateDirectionalLight(const glm::vec3& direction, const gl
 	//m_lightFreq.Add("DirectionalLight");
 	m_uiController.AddSceneObject("DirectionalLight");
 
-	AddLight(new DirectionalLight(glm::normalize(direction), color, intensity));
-	m_directionalLightCount++;
+	DirectionalLight* pDirectionalLight = new DirectionalLight(glm::normalize(direction), color, intensity);
+
+	AddLight(pDirectionalLight);
+	m_directionalLights.push_back(pDirectionalLight);
 }
 
 Entity* GraphicsEngine::CreateEntity(const std::string& meshName)
@@ -159,7 +161,6 @@ void GraphicsEngine::SetGlobalAmbientLight(const glm::vec3& ambient)
 	}
 
 	m_globalAmbientLight = ambient;
-	m_renderer.UpdateAmbientLight();
 }
 
 void GraphicsEngine::SetSkybox(const std::string& cubemapDir)
@@ -195,7 +196,7 @@ void GraphicsEngine::SetSkybox(const std::string& cubemapDir)
 		m_renderer.SetSkybox(m_skybox);
 
 		// Enable interpolation across cubemap textures to prevent seams
-		glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
+		GLState::SetEnabled(GL_TEXTURE_CUBE_MAP_SEAMLESS, true);
 	}
 }
 
@@ -216,15 +217,10 @@ ShaderProgram* GraphicsEngine::GetShader(const std::string& name)
 
 void GraphicsEngine::Render() const
 {
+	GLState::ResetStats();
+
 	// Update any state that may have changed
-	if(m_enableBackfaceCulling)
-	{
-		glEnable(GL_CULL_FACE);
-	}
-	else
-	{
-		glDisable(GL_CULL_FACE);
-	}
+	GLState::SetEnabled(GL_CULL_FACE, m_enableBackfaceCulling);
 
 	m_renderer.Render();
 }
@@ -232,7 +228,7 @@ void GraphicsEngine::Render() const
 void GraphicsEngine::OnWindowResized(int width, int height)
 {
 	// Readjust the viewport
-	glViewport(0, 0, width, height);
+	GLState::Viewport(0, 0, width, height);
 
 	m_camera.CreateProjectionMatrix(width, height);
 }
@@ -339,17 +335,31 @@ void GraphicsEngine::AssignShaders()
 	}
 }
 
-void GraphicsEngine::Run()
+void GraphicsEngine::PrepareToRender()
 {
 	// Set up entity shaders, this cannot be done on their creation
 	// since the material is not known at that time.
 	AssignShaders();
 
-	float previousTime = 0.0f;
-
 	// Set before first render call begins
 	m_renderer.BeforeFirstRender();
-	m_uiController.BeforeFirstRender(m_entities.size(), m_numLights);
+	m_uiController.BeforeFirstRender(m_entities.size(), m_lights.size());
+}
+
+void GraphicsEngine::FinishMeshLoads()
+{
+	while(GetMeshLoadsInFlight() > 0)
+	{
+		m_meshManager.ProcessCompletedLoads(std::numeric_limits<double>::max());
+		std::this_thread::yield();
+	}
+}
+
+void GraphicsEngine::Run()
+{
+	PrepareToRender();
+
+	float previousTime = 0.0f;
 
 	// Main loop
 	while(!m_window->ShouldClose())
@@ -364,6 +374,9 @@ void GraphicsEngine::Run()
 
 		ProcessInput(deltaTime);
 
+		// Upload any meshes that have finished loading in the background
+		m_meshManager.ProcessCompletedLoads(Constants::MESH_UPLOAD_BUDGET_MS);
+
 		Render();
 
 		// Draw the GUI
@@ -3,6 +3,7 @@
 
 #include "Camera.h"
 #include "Constants.h"
+#include "DirectionalLight.h"
 #include "MeshManager.h"
 #include "PointLight.h"
 #include "Renderer.h"
@@ -17,6 +18,7 @@
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_opengl3.h"
 
+#include <algorithm>
 #include <array>
 #include <string>
 #include <map>
@@ -40,20 +42,20 @@ class GraphicsEngine
 	Camera    m_camera;
 	Renderer  m_renderer;
 	Skybox* m_skybox;
-	std::array<ShadowMap, Constants::MAX_LIGHTS> m_shadowMaps;
+	std::array<ShadowMap, Constants::MAX_SHADOW_MAPS> m_shadowMaps;
 
 	ShaderManager  m_shaderManager;
 	MeshManager    m_meshManager;
 	TextureManager m_textureManager;
 
-	int m_directionalLightCount;
-	int m_pointLightCount;
-	int m_numLights;
-
 	std::vector<Entity*>                      m_entities;
 	glm::vec3                                 m_globalAmbientLight;
-	std::array<Light*, Constants::MAX_LIGHTS> m_lights;
+
+	// Every light, in the order they were added. The lights are also stored by type, since
+	// the shaders read each type from its own buffer.
+	std::vector<Light*>                       m_lights;
 	std::vector<PointLight*>                  m_pointLights;
+	std::vector<DirectionalLight*>            m_directionalLights;
 
 	// Stores rendering device info as strings
 	SystemData m_systemData;
@@ -67,7 +69,7 @@ public:
 	GraphicsEngine(Window* window);
 	~GraphicsEngine();
 
-	void AddMesh(const std::string& filename);
+	void AddMesh(const std::string& filename, const MeshLoadOptions& options = {});
 	void AddTexture(const std::string& filename);
 	void AddShader(const std::string& dirName);
 
@@ -78,10 +80,16 @@ public:
 	void SetSkybox(const std::string& cubemapDir);
 
 	void CreatePointLight(const glm::vec3& position, const glm::vec3& color,
-		float intensity = 1.0f);
+		float intensity = 1.0f, const PointLight::Attenuation& attenuation = PointLight::DEFAULT_ATTENUATION);
 	void CreateDirectionalLight(const glm::vec3& direction, const glm::vec3& color,
 		float intensity = 1.0f);
 
+	// Sets up what the renderer needs once the scene has been created, Run calls this itself
+	void PrepareToRender();
+
+	// Waits for every mesh that is loading in the background and uploads it, for rendering
+	// without the Run loop
+	void FinishMeshLoads();
 	void Run();
 	void ProcessInput(float dt);
 	void Render() const;
@@ -96,15 +104,23 @@ public:
 	// Accessors
 	Skybox*        GetSkybox()      { return m_skybox; }	
 	const auto&    GetShadowMaps()  { return m_shadowMaps; }
-	const auto&    GetPointLights() { return m_pointLights; }
+	const auto&    GetPointLights()       const { return m_pointLights; }
+	const auto&    GetDirectionalLights() const { return m_directionalLights; }
 
 	const auto&    GetEntities()           const { return m_entities; }
 	const auto&    GetLights()             const { return m_lights; }
 	glm::vec3      GetGlobalAmbientLight() const { return m_globalAmbientLight; }
 
-	int GetLightCount()            const { return m_numLights; }
-	int GetPointLightCount()       const { return m_pointLightCount; }
-	int GetDirectionalLightCount() const { return m_directionalLightCount; }
+	int GetLightCount()            const { return static_cast<int>(m_lights.size()); }
+	int GetPointLightCount()       const { return static_cast<int>(m_pointLights.size()); }
+	int GetDirectionalLightCount() const { return static_cast<int>(m_directionalLights.size()); }
+
+	// The number of lights that have a shadow map, these are the first lights that were added
+	int GetShadowedLightCount() const { return std::min(GetLightCount(), Constants::MAX_SHADOW_MAPS); }
+
+	int GetMeshLoadsInFlight() const { return m_meshManager.GetLoadsInFlight(); }
+	const RenderStats& GetRenderStats() const { return m_renderer.GetStats(); }
+	Renderer& GetRenderer() { return m_renderer; }
 
 	int GetWindowWidth()  const { return m_window->GetWidth(); }
 	int GetWindowHeight() const { return m_window->GetHeight(); }
@@ -0,0 +1,23 @@
+#include "GLState.h"
+#include "InstanceBuffer.h"
+#include <GL\glew.h>
+#include <cstddef>
+
+InstanceBuffer::InstanceBuffer()
+	: m_bufferID{ 0 }
+{
+	glGenBuffers(1, &m_bufferID);
+}
+
+InstanceBuffer::~InstanceBuffer()
+{
+	GLState::DeleteBuffers(1, &m_bufferID);
+}
+
+void InstanceBuffer::Upload(const InstanceData* pInstances, std::size_t count) const
+{
+	GLState::BindBuffer(GL_SHADER_STORAGE_BUFFER, m_bufferID);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(InstanceData) * count, pInstances, GL_STREAM_DRAW);
+
+	GLState::BindBufferBase(GL_SHADER_STORAGE_BUFFER, BINDING_POINT, m_bufferID);
+}
@@ -0,0 +1,45 @@
+#ifndef INSTANCE_BUFFER_H
+#define INSTANCE_BUFFER_H
+
+#include <GL\glew.h>
+#include <glm\glm.hpp>
+#include <cstddef>
+
+// The per-instance data read by the vertex shaders, laid out to match the
+// std430 Instance struct in the shaders
+struct InstanceData
+{
+	glm::mat4 modelMatrix;
+	glm::mat4 normalMatrix;
+};
+
+// The range of an instance's lights in the entity light index buffer, laid out to match the
+// uvec2 elements of the shaders' InstanceLightBuffer
+struct InstanceLights
+{
+	GLuint offset;
+	GLuint count;
+};
+
+// A shader storage buffer that holds the instances drawn by the current pass.
+// Shaders index it with an instance offset uniform plus gl_InstanceID.
+class InstanceBuffer
+{
+	GLuint m_bufferID;
+
+public:
+	// The binding point the shaders read the instances from
+	static constexpr GLuint BINDING_POINT = 0;
+
+	InstanceBuffer();
+	~InstanceBuffer();
+
+	InstanceBuffer(const InstanceBuffer&) = delete;
+	InstanceBuffer& operator=(const InstanceBuffer&) = delete;
+
+	// Replaces the contents of the buffer and binds it to BINDING_POINT. The previous contents
+	// are orphaned rather than overwritten, so draws that still read them do not stall.
+	void Upload(const InstanceData* pInstances, std::size_t count) const;
+};
+
+#endif
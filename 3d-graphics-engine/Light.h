@@ -5,7 +5,6 @@
 #include <iostream>
 #include <algorithm>
 
-class ShaderProgram;
 
 class ShadowData
 {
@@ -37,6 +36,16 @@ public:
 
 	void UpdateLightViewMatrix(const glm::mat4& viewMatrix) { m_lightMatrix.viewMatrix = viewMatrix; }
 
+	// The world space position of the light's view
+	glm::vec3 GetViewPosition() const { return glm::vec3(glm::inverse(m_lightMatrix.viewMatrix)[3]); }
+
+	// The world space direction the light's view looks in, the view matrix looks down its negative z axis
+	glm::vec3 GetViewDirection() const
+	{
+		const glm::mat4& view = m_lightMatrix.viewMatrix;
+		return -glm::vec3(view[0][2], view[1][2], view[2][2]);
+	}
+
 	float GetNearPlane()  const { return m_lightMatrix.nearPlane; }
 	float GetFarPlane()   const { return m_lightMatrix.farPlane; }
 	float GetShadowBias() const { return m_shadowBias; }
@@ -57,11 +66,19 @@ protected:
 	float m_intensity;
 
 	int m_id;
+
+	// The index of the light's shadow map in the shadow map array, -1 if it has none
+	int m_shadowIndex;
+
+	// Set when the light's shadow map must be redrawn, lights start dirty since they have no shadow map yet
+	bool m_shadowDirty;
 public:
 	// TODO: Set default initializers
 	Light()
 		: m_shadowData(nullptr)
 		, m_id(0)
+		, m_shadowIndex(-1)
+		, m_shadowDirty(true)
 	{
 		SetColour({ 0.0f, 0.0f, 0.0f });
 		SetIntensity(0.0f);
@@ -70,6 +87,8 @@ public:
 	Light(const glm::vec3& color, float intensity = 1.0f)
 		: m_shadowData(nullptr)
 		, m_id(0)
+		, m_shadowIndex(-1)
+		, m_shadowDirty(true)
 	{
 		SetColour(color);
 		SetIntensity(intensity);
@@ -83,12 +102,6 @@ public:
 		}
 	}
 
-	// Set a shaders uniform values with the light attributes.
-	// 'shadowIndex' is the index of the light's shadow map, in the 
-	// shadow map array. Currently the index of the light and its 
-	// shadow map are the same.
-	virtual void SetUniforms(ShaderProgram* pShader, int shadowIndex) = 0;
-
 	static bool IsValidColour(const glm::vec3& colour)
 	{
 		return (colour.r >= 0.0f && colour.r <= 1.0f) &&
@@ -120,6 +133,14 @@ public:
 	// Accessors
 	ShadowData* GetShadowData() const { return m_shadowData; }
 
+	// Only the first Constants::MAX_SHADOW_MAPS lights are given a shadow map, and the index
+	// of the light and its shadow map are the same
+	void SetShadowIndex(int shadowIndex) { m_shadowIndex = shadowIndex; }
+	int GetShadowIndex() const { return m_shadowIndex; }
+
+	bool IsShadowDirty() const { return m_shadowDirty; }
+	void ClearShadowDirty() { m_shadowDirty = false; }
+
 	float GetIntensity() const { return m_intensity; }
 
 	// Returns the colour of the light without accounting for intensity
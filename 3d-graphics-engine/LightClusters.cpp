@@ -0,0 +1,205 @@
+#include "LightClusters.h"
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+#include <thread>
+
+namespace
+{
+	// Threads are only started when each one gets at least this many lights to assign
+	constexpr int MIN_LIGHTS_PER_THREAD = 32;
+
+	// The view depth at which slice 'slice' starts, the slices split the depth range exponentially
+	float GetSliceDepth(int slice, float nearPlane, float farPlane)
+	{
+		return nearPlane * std::pow(farPlane / nearPlane, static_cast<float>(slice) / LightClusters::GRID_SIZE_Z);
+	}
+}
+
+LightClusters::LightClusters()
+	: m_clusterBounds(NUM_CLUSTERS)
+	, m_rowBounds(GRID_SIZE_Y * GRID_SIZE_Z)
+	, m_projection{ 0.0f }
+	, m_nearPlane{ 0.0f }
+	, m_farPlane{ 0.0f }
+	, m_clusters(NUM_CLUSTERS, Cluster{ 0, 0 })
+{
+}
+
+void LightClusters::CalculateClusterBounds(const glm::mat4& projection, float nearPlane, float farPlane)
+{
+	m_projection = projection;
+	m_nearPlane = nearPlane;
+	m_farPlane = farPlane;
+
+	const glm::mat4 inverseProjection = glm::inverse(projection);
+
+	// The direction through a corner of a tile, scaled so that its depth is 1
+	auto cornerRay = [&inverseProjection](int x, int y)
+	{
+		const glm::vec2 ndc = glm::vec2(
+			-1.0f + 2.0f * x / GRID_SIZE_X,
+			-1.0f + 2.0f * y / GRID_SIZE_Y);
+
+		const glm::vec4 viewPos = inverseProjection * glm::vec4(ndc, -1.0f, 1.0f);
+		const glm::vec3 point = glm::vec3(viewPos) / viewPos.w;
+
+		return point / -point.z;
+	};
+
+	for(int slice = 0; slice < GRID_SIZE_Z; ++slice)
+	{
+		const float sliceNear = GetSliceDepth(slice, nearPlane, farPlane);
+		const float sliceFar = GetSliceDepth(slice + 1, nearPlane, farPlane);
+
+		for(int y = 0; y < GRID_SIZE_Y; ++y)
+		{
+			AABB& row = m_rowBounds[slice * GRID_SIZE_Y + y];
+			row.min = glm::vec3(FLT_MAX);
+			row.max = glm::vec3(-FLT_MAX);
+
+			for(int x = 0; x < GRID_SIZE_X; ++x)
+			{
+				const glm::vec3 rays[4] = {
+					cornerRay(x, y), cornerRay(x + 1, y), cornerRay(x, y + 1), cornerRay(x + 1, y + 1)
+				};
+
+				AABB& bounds = m_clusterBounds[GetClusterIndex(x, y, slice)];
+				bounds.min = glm::vec3(FLT_MAX);
+				bounds.max = glm::vec3(-FLT_MAX);
+
+				for(const glm::vec3& ray : rays)
+				{
+					bounds.min = glm::min(bounds.min, glm::min(ray * sliceNear, ray * sliceFar));
+					bounds.max = glm::max(bounds.max, glm::max(ray * sliceNear, ray * sliceFar));
+				}
+
+				row.min = glm::min(row.min, bounds.min);
+				row.max = glm::max(row.max, bounds.max);
+			}
+		}
+	}
+}
+
+void LightClusters::AssignSlices(int firstSlice, int lastSlice, std::vector<std::uint32_t>* pIndices)
+{
+	std::vector<std::uint32_t>& indices = *pIndices;
+	indices.clear();
+
+	std::vector<std::uint32_t> sliceLights;
+	std::vector<std::uint32_t> rowLights;
+
+	for(int slice = firstSlice; slice < lastSlice; ++slice)
+	{
+		// Narrow the lights down by depth first, then by row, before testing each cluster
+		const float sliceNear = GetSliceDepth(slice, m_nearPlane, m_farPlane);
+		const float sliceFar = GetSliceDepth(slice + 1, m_nearPlane, m_farPlane);
+
+		sliceLights.clear();
+		for(std::uint32_t i = 0; i < m_viewLights.size(); ++i)
+		{
+			const float depth = -m_viewLights[i].centre.z;
+			if(depth + m_viewLights[i].radius >= sliceNear && depth - m_viewLights[i].radius <= sliceFar)
+			{
+				sliceLights.push_back(i);
+			}
+		}
+
+		for(int y = 0; y < GRID_SIZE_Y; ++y)
+		{
+			rowLights.clear();
+			for(std::uint32_t i : sliceLights)
+			{
+				if(BoundingVolume::Intersects(m_viewLights[i], m_rowBounds[slice * GRID_SIZE_Y + y]))
+				{
+					rowLights.push_back(i);
+				}
+			}
+
+			for(int x = 0; x < GRID_SIZE_X; ++x)
+			{
+				const int clusterIndex = GetClusterIndex(x, y, slice);
+				Cluster& cluster = m_clusters[clusterIndex];
+				cluster.offset = static_cast<std::uint32_t>(indices.size());
+
+				for(std::uint32_t i : rowLights)
+				{
+					if(BoundingVolume::Intersects(m_viewLights[i], m_clusterBounds[clusterIndex]))
+					{
+						indices.push_back(i);
+					}
+				}
+
+				cluster.count = static_cast<std::uint32_t>(indices.size()) - cluster.offset;
+			}
+		}
+	}
+}
+
+void LightClusters::Build(const glm::mat4& view, const glm::mat4& projection, float nearPlane, float farPlane,
+	const std::vector<BoundingSphere>& lights, int maxThreads)
+{
+	assert(nearPlane > 0.0f && farPlane > nearPlane && "Invalid depth range for the clusters");
+
+	if(projection != m_projection || nearPlane != m_nearPlane || farPlane != m_farPlane)
+	{
+		CalculateClusterBounds(projection, nearPlane, farPlane);
+	}
+
+	m_viewLights.resize(lights.size());
+	for(std::size_t i = 0; i < lights.size(); ++i)
+	{
+		m_viewLights[i].centre = glm::vec3(view * glm::vec4(lights[i].centre, 1.0f));
+		m_viewLights[i].radius = lights[i].radius;
+	}
+
+	int numThreads = 1;
+	if(maxThreads > 0)
+	{
+		// An explicit thread count is always honoured
+		numThreads = maxThreads;
+	}
+	else
+	{
+		const int numHardwareThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+		numThreads = std::min(numHardwareThreads, static_cast<int>(lights.size()) / MIN_LIGHTS_PER_THREAD);
+	}
+	numThreads = std::clamp(numThreads, 1, GRID_SIZE_Z);
+
+	m_threadIndices.resize(numThreads);
+
+	m_threadPool.Run(numThreads, [this, numThreads](int i)
+	{
+		const int firstSlice = GRID_SIZE_Z * i / numThreads;
+		const int lastSlice = GRID_SIZE_Z * (i + 1) / numThreads;
+
+		AssignSlices(firstSlice, lastSlice, &m_threadIndices[i]);
+	});
+
+	// Join the threads' index lists, moving each thread's clusters to where its list now starts
+	m_lightIndices.clear();
+	for(int i = 0; i < numThreads; ++i)
+	{
+		const int firstCluster = GRID_SIZE_X * GRID_SIZE_Y * (GRID_SIZE_Z * i / numThreads);
+		const int lastCluster = GRID_SIZE_X * GRID_SIZE_Y * (GRID_SIZE_Z * (i + 1) / numThreads);
+		const std::uint32_t base = static_cast<std::uint32_t>(m_lightIndices.size());
+
+		for(int cluster = firstCluster; cluster < lastCluster; ++cluster)
+		{
+			m_clusters[cluster].offset += base;
+		}
+
+		m_lightIndices.insert(m_lightIndices.end(), m_threadIndices[i].begin(), m_threadIndices[i].end());
+	}
+}
+
+float LightClusters::GetSliceScale() const
+{
+	return GRID_SIZE_Z / std::log(m_farPlane / m_nearPlane);
+}
+
+float LightClusters::GetSliceBias() const
+{
+	return -GRID_SIZE_Z * std::log(m_nearPlane) / std::log(m_farPlane / m_nearPlane);
+}
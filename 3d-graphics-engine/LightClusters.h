@@ -0,0 +1,75 @@
+#ifndef LIGHT_CLUSTERS_H
+#define LIGHT_CLUSTERS_H
+
+#include "BoundingVolume.h"
+#include "ThreadPool.h"
+#include <glm\glm.hpp>
+#include <cstdint>
+#include <vector>
+
+// Divides the camera's frustum into a grid of clusters, screen space tiles that are split into
+// slices along the view depth, and finds the point lights that can reach each cluster. The
+// slices grow exponentially with depth so that clusters far from the camera are not too thin.
+class LightClusters
+{
+public:
+	static constexpr int GRID_SIZE_X = 16;
+	static constexpr int GRID_SIZE_Y = 9;
+	static constexpr int GRID_SIZE_Z = 24;
+	static constexpr int NUM_CLUSTERS = GRID_SIZE_X * GRID_SIZE_Y * GRID_SIZE_Z;
+
+	// The lights of a cluster are the 'count' indices starting at 'offset' in the light index list.
+	// Laid out to match the uvec2 elements of the shaders' cluster buffer.
+	struct Cluster
+	{
+		std::uint32_t offset;
+		std::uint32_t count;
+	};
+
+private:
+	// The view space bounds of every cluster and of every row of clusters within a slice,
+	// recalculated only when the projection changes
+	std::vector<AABB> m_clusterBounds;
+	std::vector<AABB> m_rowBounds;
+	glm::mat4 m_projection;
+	float m_nearPlane;
+	float m_farPlane;
+
+	std::vector<Cluster> m_clusters;
+	std::vector<std::uint32_t> m_lightIndices;
+
+	// The view space lights and the light indices each thread found, kept between frames
+	std::vector<BoundingSphere> m_viewLights;
+	std::vector<std::vector<std::uint32_t>> m_threadIndices;
+
+	// The clusters are built every frame, so the threads are kept rather than started each time
+	ThreadPool m_threadPool;
+
+	void CalculateClusterBounds(const glm::mat4& projection, float nearPlane, float farPlane);
+
+	// Fills the clusters of the slices [firstSlice, lastSlice) with offsets into pIndices.
+	// Threads are given separate slices, so they never write to the same cluster.
+	void AssignSlices(int firstSlice, int lastSlice, std::vector<std::uint32_t>* pIndices);
+
+public:
+	LightClusters();
+
+	// Assigns the world space lights to the clusters of the camera, each light is a sphere outside
+	// of which it has no effect. The work is split between threads by slice, at most maxThreads
+	// or as many as are worthwhile if it is 0.
+	void Build(const glm::mat4& view, const glm::mat4& projection, float nearPlane, float farPlane,
+		const std::vector<BoundingSphere>& lights, int maxThreads = 0);
+
+	// Clusters are ordered by x, then y, then slice
+	static int GetClusterIndex(int x, int y, int slice) { return (slice * GRID_SIZE_Y + y) * GRID_SIZE_X + x; }
+
+	// The slice at a view depth is log(depth) * scale + bias
+	float GetSliceScale() const;
+	float GetSliceBias() const;
+
+	const std::vector<Cluster>& GetClusters()           const { return m_clusters; }
+	const std::vector<std::uint32_t>& GetLightIndices() const { return m_lightIndices; }
+	const AABB& GetClusterBounds(int index)             const { return m_clusterBounds[index]; }
+};
+
+#endif
@@ -0,0 +1,163 @@
+#include "MappedFile.h"
+#include <string>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	// Empty files cannot be mapped, point to this instead so they can still be read
+	const char EMPTY_FILE_DATA[1]{};
+}
+
+MappedFile::MappedFile()
+	: m_pData(nullptr)
+	, m_size(0)
+#ifdef _WIN32
+	, m_fileHandle(INVALID_HANDLE_VALUE)
+	, m_mappingHandle(nullptr)
+#else
+	, m_fileDescriptor(-1)
+#endif
+{
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const std::string& filepath)
+{
+	Close();
+
+	m_fileHandle = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+	if(m_fileHandle == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if(!GetFileSizeEx(m_fileHandle, &fileSize))
+	{
+		Close();
+		return false;
+	}
+
+	m_size = static_cast<std::size_t>(fileSize.QuadPart);
+	if(m_size == 0)
+	{
+		m_pData = EMPTY_FILE_DATA;
+		return true;
+	}
+
+	m_mappingHandle = CreateFileMappingA(m_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if(!m_mappingHandle)
+	{
+		Close();
+		return false;
+	}
+
+	m_pData = static_cast<const char*>(MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+	if(!m_pData)
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if(m_pData && m_pData != EMPTY_FILE_DATA)
+	{
+		UnmapViewOfFile(m_pData);
+	}
+
+	if(m_mappingHandle)
+	{
+		CloseHandle(m_mappingHandle);
+	}
+
+	if(m_fileHandle != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(m_fileHandle);
+	}
+
+	m_pData = nullptr;
+	m_size = 0;
+	m_mappingHandle = nullptr;
+	m_fileHandle = INVALID_HANDLE_VALUE;
+}
+
+#else
+
+bool MappedFile::Open(const std::string& filepath)
+{
+	Close();
+
+	m_fileDescriptor = open(filepath.c_str(), O_RDONLY);
+	if(m_fileDescriptor == -1)
+	{
+		return false;
+	}
+
+	struct stat fileStats;
+	if(fstat(m_fileDescriptor, &fileStats) == -1)
+	{
+		Close();
+		return false;
+	}
+
+	m_size = static_cast<std::size_t>(fileStats.st_size);
+	if(m_size == 0)
+	{
+		m_pData = EMPTY_FILE_DATA;
+		return true;
+	}
+
+	void* pMapping = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_fileDescriptor, 0);
+	if(pMapping == MAP_FAILED)
+	{
+		Close();
+		return false;
+	}
+
+	// The file is read from front to back
+	madvise(pMapping, m_size, MADV_SEQUENTIAL);
+
+	m_pData = static_cast<const char*>(pMapping);
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if(m_pData && m_pData != EMPTY_FILE_DATA)
+	{
+		munmap(const_cast<char*>(m_pData), m_size);
+	}
+
+	if(m_fileDescriptor != -1)
+	{
+		close(m_fileDescriptor);
+	}
+
+	m_pData = nullptr;
+	m_size = 0;
+	m_fileDescriptor = -1;
+}
+
+#endif
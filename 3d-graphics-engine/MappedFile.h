@@ -0,0 +1,40 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+// Maps the contents of a file into memory for read-only access, allowing
+// the file to be read in place without copying it into a buffer first.
+// The mapping is released when the lifetime of an instance of this class ends.
+class MappedFile
+{
+	const char* m_pData;
+	std::size_t m_size;
+
+#ifdef _WIN32
+	void* m_fileHandle;
+	void* m_mappingHandle;
+#else
+	int m_fileDescriptor;
+#endif
+
+public:
+	MappedFile();
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	// Returns false if the file could not be opened or mapped
+	bool Open(const std::string& filepath);
+	void Close();
+
+	bool IsOpen() const { return m_pData != nullptr; }
+
+	const char* GetData() const { return m_pData; }
+	const char* GetEnd()  const { return m_pData + m_size; }
+	std::size_t GetSize() const { return m_size; }
+};
+
+#endif
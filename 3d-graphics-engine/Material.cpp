@@ -1,15 +1,27 @@
+#include "GLState.h"
 #include "Material.h"
 #include "Texture.h"
 #include "ShaderProgram.h"
 #include <GL\glew.h>
 
+namespace
+{
+	constexpr UniformHandle UNIFORM_AMBIENT("material.ambient");
+	constexpr UniformHandle UNIFORM_DIFFUSE("material.diffuse");
+	constexpr UniformHandle UNIFORM_SPECULAR("material.specular");
+	constexpr UniformHandle UNIFORM_SHININESS("material.shininess");
+	constexpr UniformHandle UNIFORM_HAS_DIFFUSE_MAP("material.hasDiffuseMap");
+}
+
 Material::Material()
 	: m_diffuseMap(nullptr)
+	, m_hasTexture(false)
 {
 }
 
 Material::Material(Texture* diffuseMap)
 	: m_diffuseMap(diffuseMap)
+	, m_hasTexture(diffuseMap != nullptr)
 {
 }
 
@@ -24,17 +36,35 @@ void Material::SetShininess(float shininess)
 	m_shininess = shininess;
 }
 
+bool Material::operator==(const Material& other) const
+{
+	return m_diffuseMap == other.m_diffuseMap
+		&& m_hasTexture == other.m_hasTexture
+		&& m_ambient == other.m_ambient
+		&& m_diffuse == other.m_diffuse
+		&& m_specular == other.m_specular
+		&& m_shininess == other.m_shininess;
+}
+
 void Material::Bind(ShaderProgram* pShader) const
 {
 	if(HasTexture())
 	{
 		// Bind the diffuse map
-		glActiveTexture(GL_TEXTURE0);
+		GLState::ActiveTexture(GL_TEXTURE0);
 		m_diffuseMap->Bind();
 	}
 
-	pShader->SetUniform("material.ambient", m_ambient);
-	pShader->SetUniform("material.diffuse", m_diffuse);
-	pShader->SetUniform("material.specular", m_specular);
-	pShader->SetUniform("material.shininess", m_shininess);
+	SetUniforms(pShader);
+}
+
+void Material::SetUniforms(ShaderProgram* pShader) const
+{
+	pShader->SetUniform(UNIFORM_AMBIENT, m_ambient);
+	pShader->SetUniform(UNIFORM_DIFFUSE, m_diffuse);
+	pShader->SetUniform(UNIFORM_SPECULAR, m_specular);
+	pShader->SetUniform(UNIFORM_SHININESS, m_shininess);
+
+	// Only read by shaders that draw textured and untextured materials alike
+	pShader->SetUniform(UNIFORM_HAS_DIFFUSE_MAP, m_hasTexture);
 }
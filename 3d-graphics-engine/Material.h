@@ -27,9 +27,15 @@ public:
 
 	void SetDiffuseMap(Texture* pDiffuseMap);
 
+	// Binds the diffuse map, if there is one, and sets the material uniforms
 	void Bind(ShaderProgram* pShader) const;
+	void SetUniforms(ShaderProgram* pShader) const;
 
 	bool HasTexture() const { return m_hasTexture; }
+	Texture* GetDiffuseMap() const { return m_diffuseMap; }
+
+	// Entities whose materials are equal can be drawn together
+	bool operator==(const Material& other) const;
 };
 
 
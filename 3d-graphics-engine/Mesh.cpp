@@ -1,8 +1,11 @@
+#include "BoundingVolume.h"
 #include "Debug.h"
+#include "GLState.h"
 #include "Mesh.h"
 #include "MeshUtil.h"
 #include <GL\glew.h>
 #include <glm\glm.hpp>
+#include <glm\gtc\matrix_transform.hpp>
 #include <vector>
 
 Mesh::Mesh(const std::vector<glm::vec3>& positions, const std::vector<GLuint>& indices)
@@ -11,13 +14,15 @@ Mesh::Mesh(const std::vector<glm::vec3>& positions, const std::vector<GLuint>& i
 	auto normals = MeshUtil::GenerateVertexNormals(positions, indices);
 
 	glGenVertexArrays(1, &m_vaoID);
-	glBindVertexArray(m_vaoID);
+	GLState::BindVertexArray(m_vaoID);
 
 	glGenBuffers(MAX_BUFFERS, &m_buffers[0]);
 
 	SendVertexData(positions, POSITION_BUFFER, POSITION_ATTRIB, FLOATS_PER_POSITION);
 	SendVertexData(normals, NORMAL_BUFFER, NORMAL_ATTRIB, FLOATS_PER_NORMAL);
-	SendIndices(indices);
+	SendIndices(indices, positions.size());
+
+	CalculateBounds(positions);
 
 	//Debug::Mesh::CreateNormals(positions, normals);
 }
@@ -31,54 +36,157 @@ Mesh::Mesh(const std::vector<glm::vec3>& positions, const std::vector<glm::vec2>
 
 Mesh::Mesh(const std::vector<glm::vec3>& positions, const std::vector<glm::vec2>& texCoords,
 	const std::vector<glm::vec3>& normals, const std::vector<GLuint>& indices)
+	: Mesh{}
+{
+	CalculateBounds(positions);
+
+	Upload(MeshView{ positions.data(), texCoords.data(), normals.data(), static_cast<GLsizei>(positions.size()),
+		indices.data(), static_cast<GLsizei>(indices.size()), m_bounds, m_boundingSphere });
+}
+
+Mesh::Mesh(const std::vector<glm::vec3>& positions, const std::vector<glm::vec3>& normals, const std::vector<GLuint>& indices)
 {
 	m_numIndices = indices.size();
-	
+
 	assert(m_numIndices != 0);
 
 	glGenVertexArrays(1, &m_vaoID);
-	glBindVertexArray(m_vaoID);
+	GLState::BindVertexArray(m_vaoID);
 
 	glGenBuffers(MAX_BUFFERS, &m_buffers[0]);
 
-	SendVertexData(positions, POSITION_BUFFER, POSITION_ATTRIB, FLOATS_PER_POSITION);
-	SendVertexData(texCoords, TEXCOORD_BUFFER, TEXCOORD_ATTRIB, FLOATS_PER_TEXCOORD);
+	SendVertexData(positions, POSITION_BUFFER, POSITION_ATTRIB, FLOATS_PER_POSITION);	
 	SendVertexData(normals, NORMAL_BUFFER, NORMAL_ATTRIB, FLOATS_PER_NORMAL);
-	SendIndices(indices);
+	SendIndices(indices, positions.size());
+
+	CalculateBounds(positions);
 }
 
-Mesh::Mesh(const std::vector<glm::vec3>& positions, const std::vector<glm::vec3>& normals, const std::vector<GLuint>& indices)
+Mesh::Mesh(const MeshView& view, VertexFormat format)
+	: Mesh{}
 {
-	m_numIndices = indices.size();
+	Upload(view, format);
+}
+
+Mesh::Mesh()
+	: m_buffers{}
+	, m_vaoID{ 0 }
+	, m_numIndices{ 0 }
+	, m_indexType{ GL_UNSIGNED_INT }
+	, m_bounds{ glm::vec3(0.0f), glm::vec3(0.0f) }
+	, m_boundingSphere{ glm::vec3(0.0f), 0.0f }
+{
+}
+
+Mesh::~Mesh()
+{
+	GLState::DeleteBuffers(MAX_BUFFERS, &m_buffers[0]);
+	GLState::DeleteVertexArrays(1, &m_vaoID);
+}
+
+void Mesh::Upload(const MeshView& view, VertexFormat format)
+{
+	assert(!IsLoaded() && "Mesh has already been uploaded");
+
+	m_numIndices = view.numIndices;
+	m_bounds = view.bounds;
+	m_boundingSphere = view.boundingSphere;
 
 	assert(m_numIndices != 0);
 
 	glGenVertexArrays(1, &m_vaoID);
-	glBindVertexArray(m_vaoID);
+	GLState::BindVertexArray(m_vaoID);
 
 	glGenBuffers(MAX_BUFFERS, &m_buffers[0]);
 
-	SendVertexData(positions, POSITION_BUFFER, POSITION_ATTRIB, FLOATS_PER_POSITION);	
-	SendVertexData(normals, NORMAL_BUFFER, NORMAL_ATTRIB, FLOATS_PER_NORMAL);
-	SendIndices(indices);
+	switch(format)
+	{
+	case VertexFormat::SPLIT:
+		SendVertexData(view.pPositions, view.numVertices, POSITION_BUFFER, POSITION_ATTRIB, FLOATS_PER_POSITION);
+		SendVertexData(view.pTexCoords, view.numVertices, TEXCOORD_BUFFER, TEXCOORD_ATTRIB, FLOATS_PER_TEXCOORD);
+		SendVertexData(view.pNormals, view.numVertices, NORMAL_BUFFER, NORMAL_ATTRIB, FLOATS_PER_NORMAL);
+		break;
+	case VertexFormat::INTERLEAVED:
+		SendInterleavedVertexData<StandardVertexLayout>(view);
+		break;
+	case VertexFormat::QUANTISED:
+		SendInterleavedVertexData<QuantisedVertexLayout>(view);
+
+		// Maps the [0, 1] range of the normalised positions back onto the bounding box
+		m_dequantisationMatrix = glm::scale(glm::translate(glm::mat4(1.0f), view.bounds.min),
+			view.bounds.max - view.bounds.min);
+		m_octahedralNormals = true;
+		break;
+	}
+
+	SendIndices(view.pIndices, view.numIndices, view.numVertices);
 }
 
-Mesh::~Mesh()
+void Mesh::Render(GLenum primitiveMode) const
 {
-	glDeleteBuffers(MAX_BUFFERS, &m_buffers[0]);
-	glDeleteVertexArrays(1, &m_vaoID);
+	if(!IsLoaded())
+	{
+		return;
+	}
+
+	GLState::BindVertexArray(m_vaoID);
+
+	glDrawElements(primitiveMode, m_numIndices, m_indexType, nullptr);
 }
 
-void Mesh::Render(GLenum primitiveMode) const
+void Mesh::RenderInstanced(GLsizei numInstances, GLenum primitiveMode) const
 {
-	glBindVertexArray(m_vaoID);
+	if(!IsLoaded())
+	{
+		return;
+	}
+
+	GLState::BindVertexArray(m_vaoID);
 
-	glDrawElements(primitiveMode, m_numIndices, GL_UNSIGNED_INT, nullptr);
+	glDrawElementsInstanced(primitiveMode, m_numIndices, m_indexType, nullptr, numInstances);
+}
+
+void Mesh::Bind() const
+{
+	GLState::BindVertexArray(m_vaoID);
 }
 
-void Mesh::SendIndices(const std::vector<GLuint>& indices) const
+void Mesh::DrawInstanced(GLsizei numInstances, GLenum primitiveMode) const
 {
+	glDrawElementsInstanced(primitiveMode, m_numIndices, m_indexType, nullptr, numInstances);
+}
+
+void Mesh::CalculateBounds(const std::vector<glm::vec3>& positions)
+{
+	m_bounds = BoundingVolume::CalculateAABB(positions.data(), positions.size());
+	m_boundingSphere = BoundingVolume::CalculateBoundingSphere(positions.data(), positions.size(), m_bounds);
+}
+
+void Mesh::SendIndices(const std::vector<GLuint>& indices, std::size_t numVertices)
+{
+	SendIndices(indices.data(), indices.size(), numVertices);
+}
+
+void Mesh::SendIndices(const GLuint* pIndices, std::size_t count, std::size_t numVertices)
+{
+	m_indexType = ChooseIndexType(numVertices);
+
+	// The element array buffer is part of the vertex array's state, so it is not bound through GLState
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_buffers[INDEX_BUFFER]);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices[0]) * indices.size(),
-		&indices[0], GL_STATIC_DRAW);
+
+	if(m_indexType == GL_UNSIGNED_SHORT)
+	{
+		// Every index is known to fit, including the primitive restart index
+		std::vector<GLushort> shortIndices(count);
+		for(std::size_t i = 0; i < count; ++i)
+		{
+			shortIndices[i] = static_cast<GLushort>(pIndices[i]);
+		}
+
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLushort) * count, shortIndices.data(), GL_STATIC_DRAW);
+	}
+	else
+	{
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * count, pIndices, GL_STATIC_DRAW);
+	}
 }
\ No newline at end of file
@@ -1,10 +1,14 @@
 #ifndef MESH_H
 #define MESH_H
 
+#include "BoundingVolume.h"
+#include "GLState.h"
+#include "VertexLayout.h"
 #include <GL\glew.h>
 #include <glm\glm.hpp>
-#include <vector>
 #include <array>
+#include <cstddef>
+#include <vector>
 
 class Mesh
 {
@@ -15,7 +19,11 @@ class Mesh
 	enum BufferType
 	{
 		INDEX_BUFFER,
+
+		// The interleaved format stores every attribute in this buffer
 		POSITION_BUFFER,
+		INTERLEAVED_BUFFER = POSITION_BUFFER,
+
 		NORMAL_BUFFER,
 		TEXCOORD_BUFFER,
 
@@ -33,6 +41,20 @@ class Mesh
 	GLuint m_vaoID;
 	GLsizei m_numIndices;
 
+	// GL_UNSIGNED_SHORT or GL_UNSIGNED_INT, depending on the number of vertices
+	GLenum m_indexType;
+
+	// The bounds of the vertex positions in model space, before any quantisation
+	AABB m_bounds;
+	BoundingSphere m_boundingSphere;
+
+	// Quantised positions are stored relative to the bounding box, this transforms them back.
+	// It is the identity matrix for every other vertex format.
+	glm::mat4 m_dequantisationMatrix{ 1.0f };
+
+	// True if the normals must be decoded from the octahedral encoding in the vertex shader
+	bool m_octahedralNormals = false;
+
 public:
 	Mesh(const std::vector<glm::vec3>& positions,
 		const std::vector<GLuint>& indices);
@@ -46,30 +68,103 @@ public:
 	Mesh(const std::vector<glm::vec3>& positions, const std::vector<glm::vec3>& normals,
 		const std::vector<GLuint>& indices);
 
+	// Creates a mesh from vertex data that is already laid out in memory,
+	// such as a memory-mapped mesh cache, without copying it first
+	explicit Mesh(const MeshView& view, VertexFormat format = VertexFormat::SPLIT);
+
+	// Creates a mesh that has no data on the GPU yet, it is drawn once Upload() has been called.
+	// This allows a mesh to be referenced while it is still being loaded.
+	Mesh();
+
 	~Mesh();
 
+	// Sends the vertex data to the GPU, must only be called once
+	void Upload(const MeshView& view, VertexFormat format = VertexFormat::SPLIT);
+
+	// Returns false while the mesh has no data on the GPU
+	bool IsLoaded() const { return m_vaoID != 0; }
+
+	GLuint GetVertexArrayID() const { return m_vaoID; }
+
+	const AABB& GetBounds() const { return m_bounds; }
+	const BoundingSphere& GetBoundingSphere() const { return m_boundingSphere; }
+
+	// The type that every draw call reading the index buffer must use
+	GLenum GetIndexType() const { return m_indexType; }
+
+	// 16-bit indices are used whenever every vertex can be referenced with them. 0xFFFF is never
+	// used as a vertex index, so that it is always free to use as the primitive restart index.
+	static GLenum ChooseIndexType(std::size_t numVertices)
+	{
+		return numVertices <= 0xFFFF ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+	}
+
+	const glm::mat4& GetDequantisationMatrix() const { return m_dequantisationMatrix; }
+	bool HasOctahedralNormals() const { return m_octahedralNormals; }
+
+	// Does nothing if the mesh has not been loaded yet
 	void Render(GLenum primitiveMode = GL_TRIANGLES) const;
+
+	// Draws the mesh once for each instance, the shader reads each instance's data using gl_InstanceID
+	void RenderInstanced(GLsizei numInstances, GLenum primitiveMode = GL_TRIANGLES) const;
+
+	// Makes the mesh's vertex array current, for callers that skip redundant binds themselves
+	void Bind() const;
+
+	// Like RenderInstanced, but assumes the mesh is already bound
+	void DrawInstanced(GLsizei numInstances, GLenum primitiveMode = GL_TRIANGLES) const;
 private:
 	template <typename T>
 	void SendVertexData(const std::vector<T>& data, BufferType bufferType,
 		VertexAttrib vertexAttrib, const int numFloats) const;
 
-	void SendIndices(const std::vector<GLuint>& indices) const;
+	template <typename T>
+	void SendVertexData(const T* pData, std::size_t count, BufferType bufferType,
+		VertexAttrib vertexAttrib, const int numFloats) const;
+
+	template <typename Layout>
+	void SendInterleavedVertexData(const MeshView& view) const;
+
+	void CalculateBounds(const std::vector<glm::vec3>& positions);
+
+	// Stores the indices using the smallest index type that can reference every vertex
+	void SendIndices(const std::vector<GLuint>& indices, std::size_t numVertices);
+	void SendIndices(const GLuint* pIndices, std::size_t count, std::size_t numVertices);
 };
 
 template <typename T>
 void Mesh::SendVertexData(const std::vector<T>& data, BufferType bufferType,
 	VertexAttrib vertexAttrib, const int numFloats) const
 {
-	glBindVertexArray(m_vaoID);
+	SendVertexData(data.data(), data.size(), bufferType, vertexAttrib, numFloats);
+}
+
+template <typename T>
+void Mesh::SendVertexData(const T* pData, std::size_t count, BufferType bufferType,
+	VertexAttrib vertexAttrib, const int numFloats) const
+{
+	GLState::BindVertexArray(m_vaoID);
 
-	glBindBuffer(GL_ARRAY_BUFFER, m_buffers[bufferType]);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(data[0]) * data.size(),
-		&data[0], GL_STATIC_DRAW);
+	GLState::BindBuffer(GL_ARRAY_BUFFER, m_buffers[bufferType]);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(T) * count, pData, GL_STATIC_DRAW);
 
 	glEnableVertexAttribArray(vertexAttrib);
 	glVertexAttribPointer(vertexAttrib, numFloats,
 		GL_FLOAT, GL_FALSE, 0, nullptr);
 }
 
+template <typename Layout>
+void Mesh::SendInterleavedVertexData(const MeshView& view) const
+{
+	std::vector<unsigned char> data(static_cast<std::size_t>(view.numVertices) * Layout::STRIDE);
+	Layout::Interleave(view, data.data());
+
+	GLState::BindVertexArray(m_vaoID);
+
+	GLState::BindBuffer(GL_ARRAY_BUFFER, m_buffers[INTERLEAVED_BUFFER]);
+	glBufferData(GL_ARRAY_BUFFER, data.size(), data.data(), GL_STATIC_DRAW);
+
+	Layout::SetAttribPointers();
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,381 @@
+#include "MappedFile.h"
+#include "Mesh.h"
+#include "MeshCache.h"
+#include "MeshLoader.h"
+#include <glm\glm.hpp>
+#include <GL\glew.h>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <system_error>
+
+namespace
+{
+	const std::string CACHE_EXTENSION = ".mesh";
+
+	// Spells '3DGM' when read as bytes in little-endian order
+	constexpr std::uint32_t CACHE_MAGIC = 0x4D474433;
+
+	// Must be incremented whenever the layout of the cache changes
+	constexpr std::uint32_t CACHE_VERSION = 3;
+
+	// Flags that record which load options the mesh data was processed with
+	constexpr std::uint32_t OPTION_OPTIMISED = 1 << 0;
+
+	constexpr std::uint64_t FNV_OFFSET_BASIS = 0xCBF29CE484222325ull;
+	constexpr std::uint64_t FNV_PRIME = 0x100000001B3ull;
+
+	// The start of a cache file. It is followed by the positions, texture coordinates,
+	// normals and indices, each stored as a tightly packed array in that order.
+	// The cache is written in the byte order of the machine, which is always little-endian on
+	// the supported platforms.
+	struct CacheHeader
+	{
+		std::uint32_t magic;
+		std::uint32_t version;
+
+		// Identifies the source file the cache was created from
+		std::uint64_t sourceSize;
+		std::int64_t sourceModifiedTime;
+		std::uint64_t sourceHash;
+
+		std::uint32_t numVertices;
+		std::uint32_t numIndices;
+
+		std::uint32_t options;
+		std::uint32_t reserved;
+
+		// The axis-aligned bounding box of the vertex positions
+		glm::vec3 boundsMin;
+		glm::vec3 boundsMax;
+
+		glm::vec3 sphereCentre;
+		float sphereRadius;
+	};
+
+	// Keeps every array after the header aligned to its element type
+	static_assert(sizeof(CacheHeader) % sizeof(std::uint64_t) == 0);
+
+	struct SourceInfo
+	{
+		bool exists;
+		std::uint64_t size;
+		std::int64_t modifiedTime;
+	};
+
+	SourceInfo GetSourceInfo(const std::string& sourcePath)
+	{
+		std::error_code error;
+		SourceInfo info{};
+
+		info.size = std::filesystem::file_size(sourcePath, error);
+		if(error)
+		{
+			return info;
+		}
+
+		auto modifiedTime = std::filesystem::last_write_time(sourcePath, error);
+		if(error)
+		{
+			return info;
+		}
+
+		info.exists = true;
+		info.modifiedTime = modifiedTime.time_since_epoch().count();
+
+		return info;
+	}
+
+	// Hashes the contents of the file with 64-bit FNV-1a.
+	// Returns false if the file could not be read.
+	bool HashFile(const std::string& filepath, std::uint64_t* pHash)
+	{
+		MappedFile file;
+		if(!file.Open(filepath))
+		{
+			return false;
+		}
+
+		std::uint64_t hash = FNV_OFFSET_BASIS;
+		for(const char* p = file.GetData(); p != file.GetEnd(); ++p)
+		{
+			hash ^= static_cast<unsigned char>(*p);
+			hash *= FNV_PRIME;
+		}
+
+		*pHash = hash;
+
+		return true;
+	}
+
+	std::size_t GetCacheSize(std::uint32_t numVertices, std::uint32_t numIndices)
+	{
+		return sizeof(CacheHeader) +
+			numVertices * (sizeof(glm::vec3) + sizeof(glm::vec2) + sizeof(glm::vec3)) +
+			numIndices * sizeof(GLuint);
+	}
+
+	// Returns true if the cache was created from the current contents of the source file.
+	// pTouched is set if the contents match but the modification time does not.
+	bool IsUpToDate(const CacheHeader& header, const SourceInfo& source, const std::string& sourcePath,
+		bool* pTouched)
+	{
+		*pTouched = false;
+
+		// Only the cache has been shipped, there is nothing to compare against
+		if(!source.exists)
+		{
+			return true;
+		}
+
+		if(source.size != header.sourceSize)
+		{
+			return false;
+		}
+
+		if(source.modifiedTime == header.sourceModifiedTime)
+		{
+			return true;
+		}
+
+		// The file has been touched, for example by a checkout, but may not have changed
+		std::uint64_t hash;
+		*pTouched = HashFile(sourcePath, &hash) && hash == header.sourceHash;
+		return *pTouched;
+	}
+
+	// Stores the source's new modification time in the cache, so that the source is not hashed
+	// again the next time the cache is opened. The cache must not be mapped.
+	bool UpdateModifiedTime(const std::string& cachePath, std::int64_t modifiedTime)
+	{
+		std::fstream file(cachePath, std::ios::in | std::ios::out | std::ios::binary);
+		if(!file)
+		{
+			return false;
+		}
+
+		file.seekp(offsetof(CacheHeader, sourceModifiedTime));
+		file.write(reinterpret_cast<const char*>(&modifiedTime), sizeof(modifiedTime));
+
+		return static_cast<bool>(file);
+	}
+
+	// Returns true if every index refers to one of the vertices
+	bool AreIndicesInRange(const GLuint* pIndices, std::uint32_t numIndices, std::uint32_t numVertices)
+	{
+		GLuint maxIndex = 0;
+		for(std::uint32_t i = 0; i < numIndices; ++i)
+		{
+			maxIndex = std::max(maxIndex, pIndices[i]);
+		}
+
+		return maxIndex < numVertices;
+	}
+
+	std::uint32_t EncodeOptions(const MeshLoadOptions& options)
+	{
+		std::uint32_t flags = 0;
+		if(options.optimise)
+		{
+			flags |= OPTION_OPTIMISED;
+		}
+		return flags;
+	}
+
+	template <typename T>
+	void WriteArray(std::ofstream& file, const std::vector<T>& data)
+	{
+		file.write(reinterpret_cast<const char*>(data.data()), sizeof(T) * data.size());
+	}
+}
+
+namespace MeshCache
+{
+	std::string GetCachePath(const std::string& sourcePath)
+	{
+		return sourcePath + CACHE_EXTENSION;
+	}
+
+	bool Open(const std::string& sourcePath, const MeshLoadOptions& options, MappedFile* pFile, MeshView* pView)
+	{
+		const std::string cachePath = GetCachePath(sourcePath);
+
+		if(!pFile->Open(cachePath))
+		{
+			return false;
+		}
+
+		if(pFile->GetSize() < sizeof(CacheHeader))
+		{
+			std::cerr << "Mesh cache '" << cachePath << "' is corrupt\n";
+			return false;
+		}
+
+		const CacheHeader* pHeader = reinterpret_cast<const CacheHeader*>(pFile->GetData());
+		if(pHeader->magic != CACHE_MAGIC || pHeader->version != CACHE_VERSION)
+		{
+			std::cout << "Mesh cache '" << cachePath << "' was written by a different version\n";
+			return false;
+		}
+
+		if(pFile->GetSize() != GetCacheSize(pHeader->numVertices, pHeader->numIndices) || pHeader->numIndices == 0)
+		{
+			std::cerr << "Mesh cache '" << cachePath << "' is corrupt\n";
+			return false;
+		}
+
+		if(pHeader->options != EncodeOptions(options))
+		{
+			std::cout << "Mesh cache '" << cachePath << "' was made with different load options\n";
+			return false;
+		}
+
+		const SourceInfo source = GetSourceInfo(sourcePath);
+		bool touched = false;
+		if(!IsUpToDate(*pHeader, source, sourcePath, &touched))
+		{
+			std::cout << "Mesh cache '" << cachePath << "' is out of date\n";
+			return false;
+		}
+
+		if(touched)
+		{
+			// A mapped file cannot be written on every platform, so it is mapped again afterwards
+			const std::size_t cacheSize = pFile->GetSize();
+			pFile->Close();
+
+			if(!UpdateModifiedTime(cachePath, source.modifiedTime))
+			{
+				std::cerr << "Failed to update mesh cache: '" << cachePath << "'\n";
+			}
+
+			if(!pFile->Open(cachePath) || pFile->GetSize() != cacheSize)
+			{
+				return false;
+			}
+
+			pHeader = reinterpret_cast<const CacheHeader*>(pFile->GetData());
+		}
+
+		// The arrays follow the header directly, so they can be sent to the GPU in place
+		const char* pData = pFile->GetData() + sizeof(CacheHeader);
+		pView->numVertices = static_cast<GLsizei>(pHeader->numVertices);
+		pView->numIndices  = static_cast<GLsizei>(pHeader->numIndices);
+		pView->pPositions  = reinterpret_cast<const glm::vec3*>(pData);
+		pView->pTexCoords  = reinterpret_cast<const glm::vec2*>(pView->pPositions + pView->numVertices);
+		pView->pNormals    = reinterpret_cast<const glm::vec3*>(pView->pTexCoords + pView->numVertices);
+		pView->pIndices    = reinterpret_cast<const GLuint*>(pView->pNormals + pView->numVertices);
+
+		// The indices are drawn without any further checks, so a damaged cache must not reach the GPU
+		if(!AreIndicesInRange(pView->pIndices, pHeader->numIndices, pHeader->numVertices))
+		{
+			std::cerr << "Mesh cache '" << cachePath << "' is corrupt\n";
+			return false;
+		}
+
+		pView->bounds         = AABB{ pHeader->boundsMin, pHeader->boundsMax };
+		pView->boundingSphere = BoundingSphere{ pHeader->sphereCentre, pHeader->sphereRadius };
+
+		std::cout << "File '" << cachePath << "' loaded successfully.\n";
+
+		return true;
+	}
+
+	Mesh* Load(const std::string& sourcePath, const MeshLoadOptions& options)
+	{
+		MappedFile file;
+		MeshView view;
+		if(!Open(sourcePath, options, &file, &view))
+		{
+			return nullptr;
+		}
+
+		return new Mesh(view, options.vertexFormat);
+	}
+
+	bool Write(const std::string& sourcePath, const MeshLoadOptions& options, const MeshData& meshData)
+	{
+		const SourceInfo source = GetSourceInfo(sourcePath);
+
+		CacheHeader header{};
+		header.magic = CACHE_MAGIC;
+		header.version = CACHE_VERSION;
+		header.sourceSize = source.size;
+		header.sourceModifiedTime = source.modifiedTime;
+		header.numVertices = static_cast<std::uint32_t>(meshData.positions.size());
+		header.numIndices = static_cast<std::uint32_t>(meshData.indices.size());
+		header.options = EncodeOptions(options);
+
+		if(!source.exists || !HashFile(sourcePath, &header.sourceHash))
+		{
+			std::cerr << "Failed to read source file: '" << sourcePath << "'\n";
+			return false;
+		}
+
+		const MeshView view = GetMeshView(meshData);
+		header.boundsMin = view.bounds.min;
+		header.boundsMax = view.bounds.max;
+		header.sphereCentre = view.boundingSphere.centre;
+		header.sphereRadius = view.boundingSphere.radius;
+
+		// Write to a temporary file first, so a partially written cache is never picked up
+		const std::string cachePath = GetCachePath(sourcePath);
+		const std::string tempPath = cachePath + ".tmp";
+		{
+			std::ofstream file(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+			if(!file)
+			{
+				std::cerr << "Failed to create mesh cache: '" << cachePath << "'\n";
+				return false;
+			}
+
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			WriteArray(file, meshData.positions);
+			WriteArray(file, meshData.texCoords);
+			WriteArray(file, meshData.normals);
+			WriteArray(file, meshData.indices);
+
+			if(!file)
+			{
+				std::cerr << "Failed to write mesh cache: '" << cachePath << "'\n";
+				return false;
+			}
+		}
+
+		std::error_code error;
+		std::filesystem::rename(tempPath, cachePath, error);
+		if(error)
+		{
+			std::cerr << "Failed to write mesh cache: '" << cachePath << "'\n";
+			std::filesystem::remove(tempPath, error);
+			return false;
+		}
+
+		return true;
+	}
+
+	bool Cook(const std::string& sourcePath, const MeshLoadOptions& options)
+	{
+		MeshData meshData;
+		if(!LoadMeshData(sourcePath, &meshData))
+		{
+			return false;
+		}
+
+		ApplyLoadOptions(options, &meshData);
+
+		if(!Write(sourcePath, options, meshData))
+		{
+			return false;
+		}
+
+		std::cout << "Cooked '" << sourcePath << "' into '" << GetCachePath(sourcePath) << "'\n";
+
+		return true;
+	}
+}
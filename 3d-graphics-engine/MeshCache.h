@@ -0,0 +1,37 @@
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+#include "MeshLoader.h"
+#include <string>
+
+class MappedFile;
+class Mesh;
+
+// A versioned binary mesh format that stores the final vertex data, indices and bounds of a mesh.
+// On later runs the cache is memory-mapped and its contents are sent straight to the GPU
+// without any parsing. The cache is written next to the source file and is only used while
+// the size, modification time or hash of the source file matches the one it was created from.
+namespace MeshCache
+{
+	// Returns the path of the cache file that belongs to the source file
+	std::string GetCachePath(const std::string& sourcePath);
+
+	// Maps the cache of the source file into memory and points the view at its contents,
+	// without creating any GPU resources. The view is valid for as long as the file stays open.
+	// Returns false if there is no cache, or if it is out of date or corrupt.
+	bool Open(const std::string& sourcePath, const MeshLoadOptions& options, MappedFile* pFile, MeshView* pView);
+
+	// Creates a mesh from the cache of the source file.
+	// Returns nullptr if there is no cache, or if it is out of date or corrupt.
+	// If the source file does not exist, a valid cache is used as it is.
+	Mesh* Load(const std::string& sourcePath, const MeshLoadOptions& options);
+
+	// Writes the cache of the source file using its mesh data, which has already been
+	// processed with the options
+	bool Write(const std::string& sourcePath, const MeshLoadOptions& options, const MeshData& meshData);
+
+	// Loads the source file and writes its cache, allowing assets to be cooked offline
+	bool Cook(const std::string& sourcePath, const MeshLoadOptions& options = {});
+}
+
+#endif
@@ -1,146 +1,601 @@
+#include "BoundingVolume.h"
+#include "MappedFile.h"
 #include "Mesh.h"
+#include "MeshCache.h"
+#include "MeshLoader.h"
+#include "MeshOptimiser.h"
+#include "ParallelFor.h"
 #include <glm\glm.hpp>
 #include <GL\glew.h>
-#include <array>
-#include <fstream>
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
-#include <sstream>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
-Mesh* LoadMesh(const std::string& filepath)
+namespace
 {
-	std::ifstream inputFile(filepath, std::ios::in);
-	if(inputFile)
-	{		
-		// Stores the initial vertex attribs in vectors as they were ordered in the file
-		std::vector<glm::vec3> unorderedPositions;
-		std::vector<glm::vec2> unorderedTextureCoords;
-		std::vector<glm::vec3> unorderedNormals;
-
-		// Stores the vertex attribs in the correct order
-		std::vector<glm::vec3> finalPositions;
-		std::vector<glm::vec2> finalTextureCoords;
-		std::vector<glm::vec3> finalNormals;
-
-		while(!inputFile.eof())
-		{
-			std::string line;
-			std::getline(inputFile, line);
-
-			// If the line starts with a v, this means the line
-			// contains vertex position information
-			if(line.compare(0, 2, "v ") == 0)
-			{				
-				// Erase the prefix
-				line.erase(0, 2);
-
-				// Use a string stream to allow converting a string to numerical values
-				std::stringstream out(line);	
-
-				float x, y, z;
-				out >> x >> y >> z;
-				unorderedPositions.push_back(glm::vec3(x, y, z));
-			}
-			else if(line.compare(0, 2, "vt") == 0)
-			{			
-				// Erase the prefix
-				line.erase(0, 2);
-
-				// Use a string stream to allow converting a string to numerical values
-				std::stringstream out(line);
-
-				float s, t;
-				out >> s >> t;
-				unorderedTextureCoords.push_back(glm::vec2(s, t));
-			}
-			else if(line.compare(0, 2, "vn") == 0)
-			{
-				// Erase the prefix
-				line.erase(0, 2);
-
-				// Use a string stream to allow converting a string to numerical values
-				std::stringstream out(line);
-
-				float x, y, z;
-				out >> x >> y >> z;
-				unorderedNormals.push_back(glm::vec3(x, y, z));
-			}			
-			else if(line.compare(0, 2, "f ") == 0)
-			{
-				// Erase the prefix
-				line.erase(0, 2);
-
-				// Split the line up into three vertices
-				std::stringstream out(line);
-
-				// For each vertex in the face (triangle)
-				// Get the position, texture coord and normal indices.
-				const int NUM_VERTICES_PER_FACE = 3;
-				for(int i = 0; i < NUM_VERTICES_PER_FACE; ++i)
+	// Only triangulated meshes are supported
+	constexpr int VERTICES_PER_FACE = 3;
+
+	// Every integer up to this value can be represented exactly by a float
+	constexpr std::uint64_t MAX_EXACT_FLOAT_INTEGER = 1ull << 24;
+
+	// Powers of ten that can be represented exactly by a float
+	constexpr float EXACT_POWERS_OF_TEN[]
+	{
+		1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+	};
+
+	constexpr int MAX_EXACT_POWER_OF_TEN = 10;
+
+	// Stops the mantissa from overflowing, longer numbers are handled by the fallback
+	constexpr int MAX_MANTISSA_DIGITS = 18;
+
+	// Files are only split between threads when each thread gets at least this much to parse
+	constexpr std::ptrdiff_t MIN_BYTES_PER_CHUNK = 1 << 20;
+
+	constexpr std::size_t NO_INVALID_FACE_VERTEX = SIZE_MAX;
+
+	// Stores the indices of the position, texture coordinate and normal of a face vertex,
+	// as they appear in the file ('v/vt/vn')
+	struct FaceVertex
+	{
+		GLuint position;
+		GLuint texCoord;
+		GLuint normal;
+
+		bool operator==(const FaceVertex&) const = default;
+	};
+
+	struct FaceVertexHash
+	{
+		std::size_t operator()(const FaceVertex& faceVertex) const
+		{
+			// Spreads the three indices across the hash with large odd multipliers
+			std::uint64_t hash = faceVertex.position * 0x9E3779B97F4A7C15ull;
+			hash ^= faceVertex.texCoord * 0xC2B2AE3D27D4EB4Full;
+			hash ^= faceVertex.normal * 0x165667B19E3779F9ull;
+
+			return static_cast<std::size_t>(hash ^ (hash >> 32));
+		}
+	};
+
+	bool IsSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+	bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+
+	// Skips whitespace up until the end of the current line
+	void SkipSpaces(const char*& p, const char* pEnd)
+	{
+		while(p != pEnd && IsSpace(*p))
+		{
+			++p;
+		}
+	}
+
+	// Moves to the first character of the next line
+	void SkipLine(const char*& p, const char* pEnd)
+	{
+		while(p != pEnd && *p != '\n')
+		{
+			++p;
+		}
+
+		if(p != pEnd)
+		{
+			++p;
+		}
+	}
+
+	// Converts the number at p into a float, without allocating any memory.
+	// Most numbers in OBJ files have few significant digits, these are
+	// converted exactly using a single float multiplication or division.
+	// Anything else falls back to std::from_chars, so the result is always
+	// the correctly rounded value, the same as what a stream would produce.
+	bool ScanFloat(const char*& p, const char* pEnd, float* pValue)
+	{
+		SkipSpaces(p, pEnd);
+
+		bool negative = false;
+		if(p != pEnd && (*p == '-' || *p == '+'))
+		{
+			negative = *p == '-';
+			++p;
+		}
+
+		const char* pNumberStart = p;
+
+		std::uint64_t mantissa = 0;
+		int numDigits = 0;
+		int numMantissaDigits = 0;
+		int exponent = 0;
+
+		// Integer part
+		while(p != pEnd && IsDigit(*p))
+		{
+			if(mantissa != 0 || *p != '0')
+			{
+				mantissa = mantissa * 10 + (*p - '0');
+				numMantissaDigits++;
+			}
+			numDigits++;
+			++p;
+		}
+
+		// Fractional part
+		if(p != pEnd && *p == '.')
+		{
+			++p;
+			while(p != pEnd && IsDigit(*p))
+			{
+				if(mantissa != 0 || *p != '0')
+				{
+					mantissa = mantissa * 10 + (*p - '0');
+					numMantissaDigits++;
+				}
+				exponent--;
+				numDigits++;
+				++p;
+			}
+		}
+
+		if(numDigits == 0)
+		{
+			return false;
+		}
+
+		// Exponent part
+		if(p != pEnd && (*p == 'e' || *p == 'E'))
+		{
+			++p;
+
+			bool negativeExponent = false;
+			if(p != pEnd && (*p == '-' || *p == '+'))
+			{
+				negativeExponent = *p == '-';
+				++p;
+			}
+
+			if(p == pEnd || !IsDigit(*p))
+			{
+				return false;
+			}
+
+			int explicitExponent = 0;
+			while(p != pEnd && IsDigit(*p))
+			{
+				// Clamp silly exponents, they are handled by the fallback anyway
+				if(explicitExponent < 10000)
 				{
-					// Read the current vertex in the face, this should be in the form 'v/vt/vn'
-					std::string s;
-					out >> s;
-
-					// Each vertex will have an index of a position, texture coordinate and normal vectors
-					// in the original read in vectors.
-					std::vector<int> vertexAttribs;
-
-					// Each vertex attribute in a vertex is separated by a '/'.
-					const char delim = '/';
-
-					// The current position in the string
-					int pos = 0;
-					std::size_t curDelimIndex = 0;
-					bool endOfDelims = false;
-					while(!endOfDelims)
-					{
-						curDelimIndex = s.find(delim, pos);
-						endOfDelims = curDelimIndex == std::string::npos;
-						std::string num;
-
-						// Extract the numerical portion of the string
-						if(!endOfDelims)
-						{
-							num = s.substr(pos, curDelimIndex - pos);
-
-							// Move the current position pointer along one character past the delimeter
-							pos = curDelimIndex + 1;
-						}
-						else
-						{
-							num = s.substr(pos, s.length() - pos);
-						}
-																	
-						// Convert a string to an integer.
-						// We MUST subtract one, since OBJ files start indexing at 1, not 0.
-						int vertexAttribValue = std::stoi(num) - 1;
-						vertexAttribs.push_back(vertexAttribValue);
-					}
-
-					// Fill out the final vertex data vectors with the rearranged values
-					finalPositions.push_back(unorderedPositions[vertexAttribs[0]]);
-					finalTextureCoords.push_back(unorderedTextureCoords[vertexAttribs[1]]);
-					finalNormals.push_back(unorderedNormals[vertexAttribs[2]]);
-				}				
-			}			
-		}
-
-		std::vector<GLuint> indices;
-		indices.reserve(finalPositions.size());
-		for(int i = 0; i < finalPositions.size(); ++i)
-		{
-			indices.push_back(i);
-		}
-
-		std::cout << "File '" << filepath << "' loaded successfully.\n";
-
-		return new Mesh(finalPositions, finalTextureCoords, finalNormals, indices);
-	}
-	else
+					explicitExponent = explicitExponent * 10 + (*p - '0');
+				}
+				++p;
+			}
+
+			exponent += negativeExponent ? -explicitExponent : explicitExponent;
+		}
+
+		float value;
+		if(numMantissaDigits <= MAX_MANTISSA_DIGITS && mantissa <= MAX_EXACT_FLOAT_INTEGER &&
+			exponent >= -MAX_EXACT_POWER_OF_TEN && exponent <= MAX_EXACT_POWER_OF_TEN)
+		{
+			// Both operands are exact, so the single rounding step gives the correctly rounded result
+			value = static_cast<float>(mantissa);
+			if(exponent < 0)
+			{
+				value /= EXACT_POWERS_OF_TEN[-exponent];
+			}
+			else
+			{
+				value *= EXACT_POWERS_OF_TEN[exponent];
+			}
+		}
+		else
+		{
+			auto result = std::from_chars(pNumberStart, p, value);
+			if(result.ec != std::errc() || result.ptr != p)
+			{
+				return false;
+			}
+		}
+
+		*pValue = negative ? -value : value;
+
+		return true;
+	}
+
+	// Converts the OBJ index at p into a zero-based index
+	bool ScanIndex(const char*& p, const char* pEnd, GLuint* pIndex)
+	{
+		std::uint64_t value = 0;
+		const char* pStart = p;
+
+		while(p != pEnd && IsDigit(*p))
+		{
+			value = value * 10 + (*p - '0');
+			if(value > UINT32_MAX)
+			{
+				return false;
+			}
+			++p;
+		}
+
+		// OBJ files start indexing at 1, not 0
+		if(p == pStart || value == 0)
+		{
+			return false;
+		}
+
+		*pIndex = static_cast<GLuint>(value - 1);
+
+		return true;
+	}
+
+	bool ScanFaceVertex(const char*& p, const char* pEnd, FaceVertex* pFaceVertex)
+	{
+		SkipSpaces(p, pEnd);
+
+		// Each vertex attribute in a vertex is separated by a '/'
+		const char DELIM = '/';
+
+		if(!ScanIndex(p, pEnd, &pFaceVertex->position) || p == pEnd || *p++ != DELIM)
+		{
+			return false;
+		}
+
+		if(!ScanIndex(p, pEnd, &pFaceVertex->texCoord) || p == pEnd || *p++ != DELIM)
+		{
+			return false;
+		}
+
+		return ScanIndex(p, pEnd, &pFaceVertex->normal);
+	}
+
+	// Returns true if the line at p starts with the two character prefix
+	bool HasPrefix(const char* p, const char* pEnd, char first, char second)
+	{
+		return pEnd - p >= 2 && p[0] == first && p[1] == second;
+	}
+
+	int CountLines(const char* pBegin, const char* pEnd)
+	{
+		int count = 1;
+		for(const char* p = pBegin; p != pEnd; ++p)
+		{
+			count += *p == '\n';
+		}
+		return count;
+	}
+
+	// A section of the file that starts and ends on a line boundary,
+	// along with everything that was parsed from it
+	struct ObjChunk
+	{
+		const char* pBegin;
+		const char* pEnd;
+
+		std::vector<glm::vec3> positions;
+		std::vector<glm::vec2> texCoords;
+		std::vector<glm::vec3> normals;
+		std::vector<FaceVertex> faceVertices;
+
+		// Points to the start of the first malformed line in the chunk, if there is one
+		const char* pErrorLine = nullptr;
+
+		// The first face vertex that references a vertex attribute that does not exist
+		std::size_t invalidFaceVertex = NO_INVALID_FACE_VERTEX;
+	};
+
+	// The offset of a chunk's data in each of the combined arrays
+	struct ChunkOffsets
+	{
+		std::size_t position = 0;
+		std::size_t texCoord = 0;
+		std::size_t normal = 0;
+		std::size_t faceVertex = 0;
+	};
+
+	// Parses every line in the chunk, stopping at the first malformed line
+	void ParseObjChunk(ObjChunk* pChunk)
+	{
+		const char* p = pChunk->pBegin;
+		const char* pEnd = pChunk->pEnd;
+
+		while(p != pEnd)
+		{
+			const char* pLineStart = p;
+			bool valid = true;
+
+			// Vertex position
+			if(HasPrefix(p, pEnd, 'v', ' '))
+			{
+				p += 2;
+
+				glm::vec3 position;
+				valid = ScanFloat(p, pEnd, &position.x) && ScanFloat(p, pEnd, &position.y) &&
+					ScanFloat(p, pEnd, &position.z);
+
+				pChunk->positions.push_back(position);
+			}
+			// Texture coordinate
+			else if(HasPrefix(p, pEnd, 'v', 't'))
+			{
+				p += 2;
+
+				glm::vec2 texCoord;
+				valid = ScanFloat(p, pEnd, &texCoord.s) && ScanFloat(p, pEnd, &texCoord.t);
+
+				pChunk->texCoords.push_back(texCoord);
+			}
+			// Vertex normal
+			else if(HasPrefix(p, pEnd, 'v', 'n'))
+			{
+				p += 2;
+
+				glm::vec3 normal;
+				valid = ScanFloat(p, pEnd, &normal.x) && ScanFloat(p, pEnd, &normal.y) &&
+					ScanFloat(p, pEnd, &normal.z);
+
+				pChunk->normals.push_back(normal);
+			}
+			// Face (triangle), each vertex is in the form 'v/vt/vn'
+			else if(HasPrefix(p, pEnd, 'f', ' '))
+			{
+				p += 2;
+
+				for(int i = 0; i < VERTICES_PER_FACE && valid; ++i)
+				{
+					FaceVertex faceVertex;
+					valid = ScanFaceVertex(p, pEnd, &faceVertex);
+
+					pChunk->faceVertices.push_back(faceVertex);
+				}
+			}
+
+			if(!valid)
+			{
+				pChunk->pErrorLine = pLineStart;
+				return;
+			}
+
+			// Anything else on the line is ignored
+			SkipLine(p, pEnd);
+		}
+	}
+
+	int GetChunkCount(std::ptrdiff_t size, int maxThreads)
+	{
+		// An explicit thread count is always honoured
+		if(maxThreads > 0)
+		{
+			return maxThreads;
+		}
+
+		const int numHardwareThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+		const std::ptrdiff_t numWorthwhileChunks = std::max<std::ptrdiff_t>(1, size / MIN_BYTES_PER_CHUNK);
+
+		return static_cast<int>(std::min<std::ptrdiff_t>(numHardwareThreads, numWorthwhileChunks));
+	}
+
+	// Splits the file into roughly equally sized chunks that start and end on line boundaries.
+	// Chunks may be empty when there are fewer lines than chunks.
+	std::vector<ObjChunk> SplitIntoChunks(const char* pBegin, const char* pEnd, int numChunks)
+	{
+		std::vector<ObjChunk> chunks(numChunks);
+		const std::ptrdiff_t size = pEnd - pBegin;
+
+		const char* pChunkStart = pBegin;
+		for(int i = 0; i < numChunks; ++i)
+		{
+			const char* pChunkEnd = pEnd;
+			if(i != numChunks - 1)
+			{
+				pChunkEnd = std::max(pChunkStart, pBegin + size * (i + 1) / numChunks);
+
+				// Move the boundary past the end of the line it landed on
+				SkipLine(pChunkEnd, pEnd);
+			}
+
+			chunks[i].pBegin = pChunkStart;
+			chunks[i].pEnd = pChunkEnd;
+			pChunkStart = pChunkEnd;
+		}
+
+		return chunks;
+	}
+}
+
+bool ParseObj(const char* pBegin, const char* pEnd, MeshData* pMeshData, int maxThreads)
+{
+	std::vector<ObjChunk> chunks = SplitIntoChunks(pBegin, pEnd, GetChunkCount(pEnd - pBegin, maxThreads));
+	const int numChunks = static_cast<int>(chunks.size());
+
+	ParallelFor(numChunks, [&chunks](int i) { ParseObjChunk(&chunks[i]); });
+
+	for(const ObjChunk& chunk : chunks)
+	{
+		if(chunk.pErrorLine)
+		{
+			std::cerr << "Malformed statement on line " << CountLines(pBegin, chunk.pErrorLine) << '\n';
+			return false;
+		}
+	}
+
+	// A prefix sum over the chunk sizes gives the offset of each chunk's data in the combined arrays.
+	// OBJ indices are absolute, so once every chunk's attributes are placed at their offset,
+	// the face indices of every chunk resolve against the combined arrays unchanged.
+	std::vector<ChunkOffsets> offsets(static_cast<std::size_t>(numChunks) + 1);
+	for(int i = 0; i < numChunks; ++i)
+	{
+		offsets[i + 1].position   = offsets[i].position   + chunks[i].positions.size();
+		offsets[i + 1].texCoord   = offsets[i].texCoord   + chunks[i].texCoords.size();
+		offsets[i + 1].normal     = offsets[i].normal     + chunks[i].normals.size();
+		offsets[i + 1].faceVertex = offsets[i].faceVertex + chunks[i].faceVertices.size();
+	}
+
+	const ChunkOffsets& totals = offsets[numChunks];
+
+	// Stores the vertex attribs as they were ordered in the file
+	std::vector<glm::vec3> unorderedPositions(totals.position);
+	std::vector<glm::vec2> unorderedTextureCoords(totals.texCoord);
+	std::vector<glm::vec3> unorderedNormals(totals.normal);
+
+	ParallelFor(numChunks, [&](int i)
+	{
+		ObjChunk& chunk = chunks[i];
+		std::copy(chunk.positions.begin(), chunk.positions.end(), unorderedPositions.begin() + offsets[i].position);
+		std::copy(chunk.texCoords.begin(), chunk.texCoords.end(), unorderedTextureCoords.begin() + offsets[i].texCoord);
+		std::copy(chunk.normals.begin(), chunk.normals.end(), unorderedNormals.begin() + offsets[i].normal);
+
+		// Free the chunk's copy as early as possible
+		chunk.positions = {};
+		chunk.texCoords = {};
+		chunk.normals   = {};
+	});
+
+	ParallelFor(numChunks, [&](int i)
+	{
+		ObjChunk& chunk = chunks[i];
+
+		for(std::size_t j = 0; j < chunk.faceVertices.size(); ++j)
+		{
+			const FaceVertex& faceVertex = chunk.faceVertices[j];
+			if(faceVertex.position >= unorderedPositions.size() ||
+				faceVertex.texCoord >= unorderedTextureCoords.size() ||
+				faceVertex.normal >= unorderedNormals.size())
+			{
+				chunk.invalidFaceVertex = offsets[i].faceVertex + j;
+				return;
+			}
+		}
+	});
+
+	for(const ObjChunk& chunk : chunks)
+	{
+		if(chunk.invalidFaceVertex != NO_INVALID_FACE_VERTEX)
+		{
+			std::cerr << "Face vertex " << chunk.invalidFaceVertex
+				<< " references a vertex attribute that does not exist\n";
+			return false;
+		}
+	}
+
+	// Weld face vertices that share the same 'v/vt/vn' triple into a single vertex.
+	// Vertices are emitted in the order they are first used, so the result is deterministic.
+	const std::size_t numFaceVertices = totals.faceVertex;
+	std::unordered_map<FaceVertex, GLuint, FaceVertexHash> vertexIndices;
+	vertexIndices.reserve(numFaceVertices);
+
+	pMeshData->indices.resize(numFaceVertices);
+
+	std::size_t faceVertexIndex = 0;
+	for(const ObjChunk& chunk : chunks)
+	{
+		for(const FaceVertex& faceVertex : chunk.faceVertices)
+		{
+			const GLuint nextIndex = static_cast<GLuint>(pMeshData->positions.size());
+			auto [it, inserted] = vertexIndices.try_emplace(faceVertex, nextIndex);
+
+			// First time this combination of attributes has been seen
+			if(inserted)
+			{
+				pMeshData->positions.push_back(unorderedPositions[faceVertex.position]);
+				pMeshData->texCoords.push_back(unorderedTextureCoords[faceVertex.texCoord]);
+				pMeshData->normals.push_back(unorderedNormals[faceVertex.normal]);
+			}
+
+			pMeshData->indices[faceVertexIndex++] = it->second;
+		}
+	}
+
+	return true;
+}
+
+bool LoadMeshData(const std::string& filepath, MeshData* pMeshData, int maxThreads)
+{
+	MappedFile file;
+	if(!file.Open(filepath))
 	{
 		std::cerr << "Failed to load file: '" << filepath << "'\n";
+		return false;
+	}
+
+	if(!ParseObj(file.GetData(), file.GetEnd(), pMeshData, maxThreads))
+	{
+		std::cerr << "Failed to parse file: '" << filepath << "'\n";
+		return false;
+	}
+
+	return true;
+}
+
+void ApplyLoadOptions(const MeshLoadOptions& options, MeshData* pMeshData)
+{
+	if(options.optimise)
+	{
+		MeshOptimiser::Optimise(pMeshData);
+	}
+}
+
+MeshView GetMeshView(const MeshData& meshData)
+{
+	MeshView view{ meshData.positions.data(), meshData.texCoords.data(), meshData.normals.data(),
+		static_cast<GLsizei>(meshData.positions.size()),
+		meshData.indices.data(), static_cast<GLsizei>(meshData.indices.size()) };
+
+	view.bounds = BoundingVolume::CalculateAABB(view.pPositions, view.numVertices);
+	view.boundingSphere = BoundingVolume::CalculateBoundingSphere(view.pPositions, view.numVertices, view.bounds);
+
+	return view;
+}
+
+bool ReadMesh(const std::string& filepath, const MeshLoadOptions& options,
+	MappedFile* pCacheFile, MeshData* pMeshData, MeshView* pView)
+{
+	if(MeshCache::Open(filepath, options, pCacheFile, pView))
+	{
+		return true;
+	}
+
+	if(!LoadMeshData(filepath, pMeshData))
+	{
+		return false;
+	}
+
+	std::cout << "File '" << filepath << "' loaded successfully.\n";
+
+	// Without welding, every index would have had a vertex of its own
+	const std::size_t vertexSize = sizeof(glm::vec3) + sizeof(glm::vec2) + sizeof(glm::vec3);
+	const std::size_t numUnweldedVertices = pMeshData->indices.size();
+	const std::size_t numWeldedVertices = pMeshData->positions.size();
+	const std::size_t bytesSaved = (numUnweldedVertices - numWeldedVertices) * vertexSize;
+
+	std::cout << "Welded " << numUnweldedVertices << " vertices into " << numWeldedVertices
+		<< ", saving " << bytesSaved / 1024 << " KB\n";
+
+	ApplyLoadOptions(options, pMeshData);
+
+	// Later runs can skip parsing altogether
+	MeshCache::Write(filepath, options, *pMeshData);
+
+	*pView = GetMeshView(*pMeshData);
+
+	return !pMeshData->indices.empty();
+}
+
+Mesh* LoadMesh(const std::string& filepath, const MeshLoadOptions& options)
+{
+	MappedFile cacheFile;
+	MeshData meshData;
+	MeshView view;
+	if(!ReadMesh(filepath, options, &cacheFile, &meshData, &view))
+	{
 		return nullptr;
 	}
-}
\ No newline at end of file
+
+	return new Mesh(view, options.vertexFormat);
+}
@@ -1,10 +1,62 @@
 #ifndef MESH_LOADER_H
 #define MESH_LOADER_H
 
+#include "VertexLayout.h"
+#include <GL\glew.h>
+#include <glm\glm.hpp>
 #include <string>
+#include <vector>
 
+class MappedFile;
 class Mesh;
 
-Mesh* LoadMesh(const std::string& filepath);
+// Stores the vertex attributes and indices of a mesh in system memory,
+// before they are sent to the GPU.
+// Face vertices with the same 'v/vt/vn' triple share a single vertex.
+struct MeshData
+{
+	std::vector<glm::vec3> positions;
+	std::vector<glm::vec2> texCoords;
+	std::vector<glm::vec3> normals;
+	std::vector<GLuint>    indices;
+};
 
-#endif
\ No newline at end of file
+// Controls the processing that is applied to a mesh after it has been parsed.
+// The options are stored in the mesh cache, a cache made with different options is rebuilt.
+struct MeshLoadOptions
+{
+	// Reorders triangles and vertices for the vertex cache, overdraw and vertex fetches
+	bool optimise = true;
+
+	// How the vertices are stored on the GPU, this does not affect the mesh cache.
+	// VertexFormat::QUANTISED halves the memory used by the vertices.
+	VertexFormat vertexFormat = VertexFormat::SPLIT;
+};
+
+// Parses the OBJ file contents in the range [pBegin, pEnd) in place.
+// Returns false if the contents are malformed.
+// The contents are split into chunks that are parsed in parallel by up to 'maxThreads' threads.
+// A value of 0 uses every hardware thread, as long as the file is large enough to benefit.
+// The result is identical regardless of the number of threads.
+bool ParseObj(const char* pBegin, const char* pEnd, MeshData* pMeshData, int maxThreads = 0);
+
+// Loads an OBJ file from disk without creating any GPU resources
+bool LoadMeshData(const std::string& filepath, MeshData* pMeshData, int maxThreads = 0);
+
+// Processes the parsed mesh data as described by the options
+void ApplyLoadOptions(const MeshLoadOptions& options, MeshData* pMeshData);
+
+// Points a view at the mesh data, it is valid for as long as the mesh data is not modified
+MeshView GetMeshView(const MeshData& meshData);
+
+// Reads the mesh from the binary cache of the OBJ file if it is up to date, otherwise parses
+// the OBJ file, processes it and writes the cache for next time. No GPU resources are created.
+// The view points into either the cache file or the mesh data, so both must outlive it.
+bool ReadMesh(const std::string& filepath, const MeshLoadOptions& options,
+	MappedFile* pCacheFile, MeshData* pMeshData, MeshView* pView);
+
+// Creates a mesh from the binary cache of the OBJ file if it is up to date,
+// otherwise parses the OBJ file and writes the cache for next time
+Mesh* LoadMesh(const std::string& filepath, const MeshLoadOptions& options = {});
+
+#endif
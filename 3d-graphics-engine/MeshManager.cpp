@@ -1,13 +1,58 @@
 #include "MeshManager.h"
+#include "MappedFile.h"
 #include "MeshLoader.h"
 #include "Mesh.h"
 #include "Constants.h"
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <iostream>
 #include <string>
 
+namespace
+{
+	// Parsing a single file is already spread across every core,
+	// so only a few files are worked on at the same time
+	constexpr int MAX_LOAD_THREADS = 2;
+}
+
+// A mesh that is being loaded in the background
+struct MeshManager::LoadJob
+{
+	std::string filepath;
+	MeshLoadOptions options;
+
+	// The mesh that is handed out while loading, it receives the data once uploaded
+	Mesh* pMesh;
+
+	bool succeeded = false;
+
+	// Points into either the mapped cache file or the parsed mesh data
+	MeshView view{};
+	MappedFile cacheFile;
+	MeshData meshData;
+};
+
+MeshManager::MeshManager()
+	: m_stopWorkers(false)
+	, m_numLoadsInFlight(0)
+{
+}
+
 MeshManager::~MeshManager()
 {
+	// Stop the workers first, they may still be loading into the meshes
+	{
+		std::lock_guard<std::mutex> lock(m_pendingMutex);
+		m_stopWorkers = true;
+	}
+	m_pendingCondition.notify_all();
+
+	for(std::thread& worker : m_workers)
+	{
+		worker.join();
+	}
+
 	// Free all meshes
 	std::cout << "Freeing all meshes\n";
 
@@ -17,9 +62,9 @@ MeshManager::~MeshManager()
 	}
 }
 
-void MeshManager::CreateMesh(const std::string& filename)
+void MeshManager::CreateMesh(const std::string& filename, const MeshLoadOptions& options)
 {
-	CreateMesh(filename, LoadMesh(Constants::MODEL_PATH + filename));
+	CreateMesh(filename, LoadMesh(Constants::MODEL_PATH + filename, options));
 }
 
 void MeshManager::CreateMesh(const std::string& name, Mesh* pMesh)
@@ -37,6 +82,106 @@ void MeshManager::CreateMesh(const std::string& name, Mesh* pMesh)
 	}
 }
 
+Mesh* MeshManager::CreateMeshAsync(const std::string& filename, const MeshLoadOptions& options)
+{
+	if(m_workers.empty())
+	{
+		StartWorkers();
+	}
+
+	auto pJob = std::make_unique<LoadJob>();
+	pJob->filepath = Constants::MODEL_PATH + filename;
+	pJob->options = options;
+	pJob->pMesh = new Mesh();
+
+	Mesh* pMesh = pJob->pMesh;
+	CreateMesh(filename, pMesh);
+
+	{
+		std::lock_guard<std::mutex> lock(m_pendingMutex);
+		m_pendingLoads.push_back(std::move(pJob));
+	}
+	m_pendingCondition.notify_one();
+
+	m_numLoadsInFlight++;
+
+	return pMesh;
+}
+
+void MeshManager::ProcessCompletedLoads(double budgetMs)
+{
+	using Clock = std::chrono::steady_clock;
+	const Clock::time_point start = Clock::now();
+
+	while(m_numLoadsInFlight > 0)
+	{
+		std::unique_ptr<LoadJob> pJob;
+		{
+			std::lock_guard<std::mutex> lock(m_completedMutex);
+			if(m_completedLoads.empty())
+			{
+				return;
+			}
+
+			pJob = std::move(m_completedLoads.front());
+			m_completedLoads.pop_front();
+		}
+
+		m_numLoadsInFlight--;
+
+		// A mesh that failed to load is never drawn
+		if(pJob->succeeded)
+		{
+			pJob->pMesh->Upload(pJob->view, pJob->options.vertexFormat);
+		}
+		else
+		{
+			std::cerr << "Failed to load mesh '" << pJob->filepath << "' asynchronously\n";
+		}
+
+		const double elapsedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		if(elapsedMs >= budgetMs)
+		{
+			return;
+		}
+	}
+}
+
+void MeshManager::StartWorkers()
+{
+	const int numThreads = std::clamp(static_cast<int>(std::thread::hardware_concurrency()) - 1, 1, MAX_LOAD_THREADS);
+
+	for(int i = 0; i < numThreads; ++i)
+	{
+		m_workers.emplace_back(&MeshManager::WorkerMain, this);
+	}
+}
+
+void MeshManager::WorkerMain()
+{
+	while(true)
+	{
+		std::unique_ptr<LoadJob> pJob;
+		{
+			std::unique_lock<std::mutex> lock(m_pendingMutex);
+			m_pendingCondition.wait(lock, [this] { return m_stopWorkers || !m_pendingLoads.empty(); });
+
+			if(m_stopWorkers)
+			{
+				return;
+			}
+
+			pJob = std::move(m_pendingLoads.front());
+			m_pendingLoads.pop_front();
+		}
+
+		pJob->succeeded = ReadMesh(pJob->filepath, pJob->options, &pJob->cacheFile, &pJob->meshData, &pJob->view);
+
+		std::lock_guard<std::mutex> lock(m_completedMutex);
+		m_completedLoads.push_back(std::move(pJob));
+	}
+}
+
 Mesh* MeshManager::GetMesh(const std::string& name) const
 {
 	Mesh* pMesh = nullptr;
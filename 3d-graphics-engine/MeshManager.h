@@ -3,21 +3,64 @@
 
 class Mesh;
 
+#include "MeshLoader.h"
+#include <condition_variable>
+#include <deque>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 // This class is responsible for the management of meshes and freeing meshes when the 
-// lifetime of an instance of this class ends. Users can retrieve a reference to a mesh by name
+// lifetime of an instance of this class ends. Users can retrieve a reference to a mesh by name.
+// Meshes can be loaded asynchronously, the file is read and parsed on a pool of worker threads
+// while the mesh can already be referenced. It is uploaded to the GPU later on the GL thread.
 class MeshManager
 {
+	struct LoadJob;
+
 	std::map<std::string, Mesh*> m_meshes;
 
+	// Worker threads are only created once the first asynchronous load is requested
+	std::vector<std::thread> m_workers;
+
+	// Loads waiting to be picked up by a worker
+	std::deque<std::unique_ptr<LoadJob>> m_pendingLoads;
+	std::mutex m_pendingMutex;
+	std::condition_variable m_pendingCondition;
+	bool m_stopWorkers;
+
+	// Loads that have been read and parsed, waiting to be uploaded
+	std::deque<std::unique_ptr<LoadJob>> m_completedLoads;
+	std::mutex m_completedMutex;
+
+	// The number of asynchronous loads that have not been uploaded yet
+	int m_numLoadsInFlight;
+
 public:
+	MeshManager();
 	~MeshManager();
 
-	void CreateMesh(const std::string& filename);
+	void CreateMesh(const std::string& filename, const MeshLoadOptions& options = {});
 	void CreateMesh(const std::string& name, Mesh* pMesh);
 
+	// Starts loading the mesh in the background and returns it immediately.
+	// The mesh renders nothing until it has been uploaded by ProcessCompletedLoads().
+	Mesh* CreateMeshAsync(const std::string& filename, const MeshLoadOptions& options = {});
+
+	// Uploads meshes that have finished loading to the GPU, stopping once the time budget
+	// has been used up. At least one mesh is uploaded per call so that loading always
+	// makes progress. Must be called on the thread that owns the GL context.
+	void ProcessCompletedLoads(double budgetMs);
+
+	int GetLoadsInFlight() const { return m_numLoadsInFlight; }
+
 	Mesh* GetMesh(const std::string& name) const;
+
+private:
+	void StartWorkers();
+	void WorkerMain();
 };
 #endif
@@ -0,0 +1,439 @@
+#include "MeshLoader.h"
+#include "MeshOptimiser.h"
+#include <GL\glew.h>
+#include <glm\glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <numeric>
+#include <vector>
+
+namespace
+{
+	constexpr int VERTICES_PER_FACE = 3;
+
+	// The size of the FIFO cache that is simulated for measurements and overdraw clustering,
+	// typical of real hardware
+	constexpr std::size_t SIMULATED_CACHE_SIZE = 16;
+
+	// Tuning values from Forsyth's article, the scores assume an LRU cache of this size
+	constexpr int FORSYTH_CACHE_SIZE = 32;
+	constexpr float CACHE_DECAY_POWER = 1.5f;
+	constexpr float LAST_TRIANGLE_SCORE = 0.75f;
+	constexpr float VALENCE_BOOST_SCALE = 2.0f;
+	constexpr float VALENCE_BOOST_POWER = 0.5f;
+
+	// Allows the ACMR to degrade by 5% in exchange for less overdraw
+	constexpr float OVERDRAW_THRESHOLD = 1.05f;
+
+	constexpr GLuint NO_TRIANGLE = 0xFFFFFFFF;
+	constexpr GLuint UNUSED_VERTEX = 0xFFFFFFFF;
+
+	float ScoreVertex(int cachePosition, int numRemainingTriangles)
+	{
+		// Vertices that are not used by any remaining triangle are never picked
+		if(numRemainingTriangles == 0)
+		{
+			return -1.0f;
+		}
+
+		float score = 0.0f;
+		if(cachePosition >= 0)
+		{
+			// The vertices of the last triangle get a fixed score, so that the next triangle
+			// does not strongly prefer them over other recently used vertices
+			if(cachePosition < VERTICES_PER_FACE)
+			{
+				score = LAST_TRIANGLE_SCORE;
+			}
+			else
+			{
+				const float scaler = 1.0f / (FORSYTH_CACHE_SIZE - VERTICES_PER_FACE);
+				score = std::pow(1.0f - (cachePosition - VERTICES_PER_FACE) * scaler, CACHE_DECAY_POWER);
+			}
+		}
+
+		// Prefer vertices with few triangles left, so that lone triangles are not left until the end
+		score += VALENCE_BOOST_SCALE * std::pow(static_cast<float>(numRemainingTriangles), -VALENCE_BOOST_POWER);
+
+		return score;
+	}
+
+	// Simulates a FIFO vertex cache. A vertex is in the cache while fewer than
+	// SIMULATED_CACHE_SIZE misses have happened since it was added.
+	class FifoCache
+	{
+		std::vector<std::size_t> m_timestamps;
+		std::size_t m_timestamp;
+
+	public:
+		explicit FifoCache(std::size_t numVertices)
+			: m_timestamps(numVertices, 0)
+			, m_timestamp(SIMULATED_CACHE_SIZE + 1)
+		{
+		}
+
+		// Returns true if the vertex had to be transformed
+		bool Access(GLuint vertex)
+		{
+			if(m_timestamp - m_timestamps[vertex] > SIMULATED_CACHE_SIZE)
+			{
+				m_timestamps[vertex] = m_timestamp++;
+				return true;
+			}
+			return false;
+		}
+
+		int AccessTriangle(const GLuint* pTriangle)
+		{
+			return Access(pTriangle[0]) + Access(pTriangle[1]) + Access(pTriangle[2]);
+		}
+
+		// Evicts every vertex
+		void Clear()
+		{
+			m_timestamp += SIMULATED_CACHE_SIZE + 1;
+		}
+	};
+
+	template <typename T>
+	void RemapVertices(std::vector<T>* pData, const std::vector<GLuint>& remap, std::size_t numUsedVertices)
+	{
+		std::vector<T> remapped(numUsedVertices);
+		for(std::size_t i = 0; i < remap.size(); ++i)
+		{
+			if(remap[i] != UNUSED_VERTEX)
+			{
+				remapped[remap[i]] = (*pData)[i];
+			}
+		}
+		pData->swap(remapped);
+	}
+}
+
+namespace MeshOptimiser
+{
+	VertexCacheStats AnalyseVertexCache(const std::vector<GLuint>& indices, std::size_t numVertices)
+	{
+		FifoCache cache(numVertices);
+
+		std::size_t numMisses = 0;
+		for(GLuint index : indices)
+		{
+			numMisses += cache.Access(index);
+		}
+
+		const std::size_t numTriangles = indices.size() / VERTICES_PER_FACE;
+
+		VertexCacheStats stats{};
+		stats.acmr = numTriangles ? static_cast<float>(numMisses) / numTriangles : 0.0f;
+		stats.atvr = numVertices ? static_cast<float>(numMisses) / numVertices : 0.0f;
+
+		return stats;
+	}
+
+	void OptimiseVertexCache(std::vector<GLuint>* pIndices, std::size_t numVertices)
+	{
+		std::vector<GLuint>& indices = *pIndices;
+		const std::size_t numTriangles = indices.size() / VERTICES_PER_FACE;
+		if(numTriangles == 0)
+		{
+			return;
+		}
+
+		// Build the list of triangles that use each vertex. Each vertex's list is kept
+		// partitioned so that only its first 'numRemaining' triangles have not been emitted.
+		std::vector<int> numRemaining(numVertices, 0);
+		for(GLuint index : indices)
+		{
+			numRemaining[index]++;
+		}
+
+		std::vector<std::size_t> firstTriangle(numVertices + 1, 0);
+		for(std::size_t v = 0; v < numVertices; ++v)
+		{
+			firstTriangle[v + 1] = firstTriangle[v] + numRemaining[v];
+		}
+
+		std::vector<GLuint> vertexTriangles(indices.size());
+		{
+			std::vector<std::size_t> insertPositions(firstTriangle.begin(), firstTriangle.end() - 1);
+			for(std::size_t i = 0; i < indices.size(); ++i)
+			{
+				vertexTriangles[insertPositions[indices[i]]++] = static_cast<GLuint>(i / VERTICES_PER_FACE);
+			}
+		}
+
+		std::vector<int> cachePositions(numVertices, -1);
+		std::vector<float> vertexScores(numVertices);
+		for(std::size_t v = 0; v < numVertices; ++v)
+		{
+			vertexScores[v] = ScoreVertex(-1, numRemaining[v]);
+		}
+
+		auto scoreTriangle = [&](GLuint triangle)
+		{
+			const GLuint* pTriangle = &indices[triangle * VERTICES_PER_FACE];
+			return vertexScores[pTriangle[0]] + vertexScores[pTriangle[1]] + vertexScores[pTriangle[2]];
+		};
+
+		// Start with the best triangle in the whole mesh
+		GLuint bestTriangle = 0;
+		float bestScore = scoreTriangle(0);
+		for(GLuint t = 1; t < numTriangles; ++t)
+		{
+			const float score = scoreTriangle(t);
+			if(score > bestScore)
+			{
+				bestTriangle = t;
+				bestScore = score;
+			}
+		}
+
+		std::vector<bool> emitted(numTriangles, false);
+		std::vector<GLuint> result;
+		result.reserve(indices.size());
+
+		// The simulated LRU cache, it temporarily holds a few more entries
+		// so that the scores of evicted vertices can be updated
+		std::vector<GLuint> cache;
+		std::vector<GLuint> newCache;
+		cache.reserve(FORSYTH_CACHE_SIZE + VERTICES_PER_FACE);
+		newCache.reserve(FORSYTH_CACHE_SIZE + VERTICES_PER_FACE);
+
+		// Used to find a new starting point once the cache has no more useful triangles
+		std::size_t nextUnemitted = 0;
+
+		while(bestTriangle != NO_TRIANGLE)
+		{
+			const GLuint* pTriangle = &indices[bestTriangle * VERTICES_PER_FACE];
+			emitted[bestTriangle] = true;
+			result.insert(result.end(), pTriangle, pTriangle + VERTICES_PER_FACE);
+
+			// Remove the triangle from the lists of its vertices
+			for(int i = 0; i < VERTICES_PER_FACE; ++i)
+			{
+				const GLuint vertex = pTriangle[i];
+				GLuint* pBegin = &vertexTriangles[firstTriangle[vertex]];
+				GLuint* pEnd = pBegin + numRemaining[vertex];
+
+				std::iter_swap(std::find(pBegin, pEnd, bestTriangle), pEnd - 1);
+				numRemaining[vertex]--;
+			}
+
+			// The triangle's vertices move to the front of the cache
+			newCache.assign(pTriangle, pTriangle + VERTICES_PER_FACE);
+			for(GLuint vertex : cache)
+			{
+				if(vertex != pTriangle[0] && vertex != pTriangle[1] && vertex != pTriangle[2])
+				{
+					newCache.push_back(vertex);
+				}
+			}
+
+			for(std::size_t i = 0; i < newCache.size(); ++i)
+			{
+				const GLuint vertex = newCache[i];
+				cachePositions[vertex] = i < FORSYTH_CACHE_SIZE ? static_cast<int>(i) : -1;
+				vertexScores[vertex] = ScoreVertex(cachePositions[vertex], numRemaining[vertex]);
+			}
+
+			// Only triangles that use a vertex whose score changed need to be considered
+			bestTriangle = NO_TRIANGLE;
+			bestScore = -1.0f;
+			for(GLuint vertex : newCache)
+			{
+				const GLuint* pBegin = &vertexTriangles[firstTriangle[vertex]];
+				const GLuint* pEnd = pBegin + numRemaining[vertex];
+
+				for(const GLuint* p = pBegin; p != pEnd; ++p)
+				{
+					const float score = scoreTriangle(*p);
+					if(score > bestScore)
+					{
+						bestTriangle = *p;
+						bestScore = score;
+					}
+				}
+			}
+
+			if(newCache.size() > FORSYTH_CACHE_SIZE)
+			{
+				newCache.resize(FORSYTH_CACHE_SIZE);
+			}
+			cache.swap(newCache);
+
+			// Nothing in the cache is useful anymore, continue with the next triangle in the original order
+			if(bestTriangle == NO_TRIANGLE)
+			{
+				while(nextUnemitted < numTriangles && emitted[nextUnemitted])
+				{
+					nextUnemitted++;
+				}
+
+				if(nextUnemitted < numTriangles)
+				{
+					bestTriangle = static_cast<GLuint>(nextUnemitted);
+				}
+			}
+		}
+
+		indices.swap(result);
+	}
+
+	void OptimiseOverdraw(const std::vector<glm::vec3>& positions, std::vector<GLuint>* pIndices,
+		float threshold)
+	{
+		std::vector<GLuint>& indices = *pIndices;
+		const std::size_t numTriangles = indices.size() / VERTICES_PER_FACE;
+		if(numTriangles == 0)
+		{
+			return;
+		}
+
+		// Hard boundaries are where the cache is flushed anyway, since no vertex of the triangle is in it.
+		// Reordering clusters at these points does not change the ACMR at all.
+		std::vector<std::size_t> hardClusters;
+		{
+			FifoCache cache(positions.size());
+			for(std::size_t t = 0; t < numTriangles; ++t)
+			{
+				if(cache.AccessTriangle(&indices[t * VERTICES_PER_FACE]) == VERTICES_PER_FACE)
+				{
+					hardClusters.push_back(t);
+				}
+			}
+		}
+		hardClusters.push_back(numTriangles);
+
+		// Split the hard clusters further as soon as a cluster is efficient enough on its own,
+		// giving smaller clusters to sort at the cost of a slightly higher ACMR
+		std::vector<std::size_t> clusters;
+		FifoCache cache(positions.size());
+		for(std::size_t c = 0; c + 1 < hardClusters.size(); ++c)
+		{
+			const std::size_t start = hardClusters[c];
+			const std::size_t end = hardClusters[c + 1];
+
+			cache.Clear();
+			std::size_t numClusterMisses = 0;
+			for(std::size_t t = start; t < end; ++t)
+			{
+				numClusterMisses += cache.AccessTriangle(&indices[t * VERTICES_PER_FACE]);
+			}
+
+			const float clusterThreshold = threshold * numClusterMisses / (end - start);
+
+			cache.Clear();
+			clusters.push_back(start);
+
+			std::size_t subStart = start;
+			std::size_t numMisses = 0;
+			for(std::size_t t = start; t < end; ++t)
+			{
+				numMisses += cache.AccessTriangle(&indices[t * VERTICES_PER_FACE]);
+
+				if(t + 1 < end && static_cast<float>(numMisses) / (t + 1 - subStart) <= clusterThreshold)
+				{
+					clusters.push_back(t + 1);
+					subStart = t + 1;
+					numMisses = 0;
+					cache.Clear();
+				}
+			}
+		}
+		clusters.push_back(numTriangles);
+
+		const std::size_t numClusters = clusters.size() - 1;
+
+		// Clusters that face away from the centre of the mesh are likely to occlude the others
+		glm::vec3 meshCentroid{ 0.0f };
+		for(GLuint index : indices)
+		{
+			meshCentroid += positions[index];
+		}
+		meshCentroid /= static_cast<float>(indices.size());
+
+		std::vector<float> sortKeys(numClusters);
+		for(std::size_t c = 0; c < numClusters; ++c)
+		{
+			glm::vec3 centroid{ 0.0f };
+			glm::vec3 normal{ 0.0f };
+			float area = 0.0f;
+
+			for(std::size_t t = clusters[c]; t < clusters[c + 1]; ++t)
+			{
+				const glm::vec3& p0 = positions[indices[t * VERTICES_PER_FACE]];
+				const glm::vec3& p1 = positions[indices[t * VERTICES_PER_FACE + 1]];
+				const glm::vec3& p2 = positions[indices[t * VERTICES_PER_FACE + 2]];
+
+				// The length of the cross product is twice the area, which weights each triangle
+				const glm::vec3 areaNormal = glm::cross(p1 - p0, p2 - p0);
+				const float triangleArea = glm::length(areaNormal);
+
+				centroid += (p0 + p1 + p2) * (triangleArea / 3.0f);
+				normal += areaNormal;
+				area += triangleArea;
+			}
+
+			const float normalLength = glm::length(normal);
+			if(area > 0.0f && normalLength > 0.0f)
+			{
+				sortKeys[c] = glm::dot(centroid / area - meshCentroid, normal / normalLength);
+			}
+			else
+			{
+				sortKeys[c] = 0.0f;
+			}
+		}
+
+		std::vector<std::size_t> order(numClusters);
+		std::iota(order.begin(), order.end(), 0);
+		std::stable_sort(order.begin(), order.end(),
+			[&sortKeys](std::size_t a, std::size_t b) { return sortKeys[a] > sortKeys[b]; });
+
+		std::vector<GLuint> result;
+		result.reserve(indices.size());
+		for(std::size_t c : order)
+		{
+			result.insert(result.end(), indices.begin() + clusters[c] * VERTICES_PER_FACE,
+				indices.begin() + clusters[c + 1] * VERTICES_PER_FACE);
+		}
+
+		indices.swap(result);
+	}
+
+	void OptimiseVertexFetch(MeshData* pMeshData)
+	{
+		std::vector<GLuint> remap(pMeshData->positions.size(), UNUSED_VERTEX);
+
+		GLuint numUsedVertices = 0;
+		for(GLuint& index : pMeshData->indices)
+		{
+			if(remap[index] == UNUSED_VERTEX)
+			{
+				remap[index] = numUsedVertices++;
+			}
+			index = remap[index];
+		}
+
+		RemapVertices(&pMeshData->positions, remap, numUsedVertices);
+		RemapVertices(&pMeshData->texCoords, remap, numUsedVertices);
+		RemapVertices(&pMeshData->normals, remap, numUsedVertices);
+	}
+
+	void Optimise(MeshData* pMeshData)
+	{
+		const VertexCacheStats before = AnalyseVertexCache(pMeshData->indices, pMeshData->positions.size());
+
+		OptimiseVertexCache(&pMeshData->indices, pMeshData->positions.size());
+		OptimiseOverdraw(pMeshData->positions, &pMeshData->indices, OVERDRAW_THRESHOLD);
+		OptimiseVertexFetch(pMeshData);
+
+		const VertexCacheStats after = AnalyseVertexCache(pMeshData->indices, pMeshData->positions.size());
+
+		printf("Optimised mesh: ACMR %.3f -> %.3f, ATVR %.3f -> %.3f\n",
+			before.acmr, after.acmr, before.atvr, after.atvr);
+	}
+}
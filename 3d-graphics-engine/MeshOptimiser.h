@@ -0,0 +1,48 @@
+#ifndef MESH_OPTIMISER_H
+#define MESH_OPTIMISER_H
+
+#include <GL\glew.h>
+#include <glm\glm.hpp>
+#include <cstddef>
+#include <vector>
+
+struct MeshData;
+
+// Reorders the triangles and vertices of a mesh so that it is cheaper for the GPU to draw,
+// without changing what is drawn
+namespace MeshOptimiser
+{
+	// Describes how well an index buffer uses a simulated FIFO post-transform vertex cache
+	struct VertexCacheStats
+	{
+		// Average cache miss ratio, the number of vertices transformed per triangle.
+		// Ranges from 3.0 in the worst case down to around 0.5 for a regular grid.
+		float acmr;
+
+		// Average transformed vertex ratio, the number of times each vertex is transformed.
+		// 1.0 is the best possible value.
+		float atvr;
+	};
+
+	VertexCacheStats AnalyseVertexCache(const std::vector<GLuint>& indices, std::size_t numVertices);
+
+	// Reorders triangles so that vertices are reused while they are still in the
+	// vertex cache, using Tom Forsyth's linear-speed vertex cache optimisation
+	void OptimiseVertexCache(std::vector<GLuint>* pIndices, std::size_t numVertices);
+
+	// Reorders clusters of triangles so that the outward facing clusters are drawn first,
+	// reducing overdraw without undoing much of the vertex cache optimisation (Sander et al.).
+	// The indices must already be optimised for the vertex cache. 'threshold' is how much
+	// the ACMR may degrade by, e.g. 1.05 allows it to become 5% worse.
+	void OptimiseOverdraw(const std::vector<glm::vec3>& positions, std::vector<GLuint>* pIndices,
+		float threshold);
+
+	// Reorders vertices in the order they are first referenced by the indices,
+	// so vertex fetches read memory sequentially. Unreferenced vertices are removed.
+	void OptimiseVertexFetch(MeshData* pMeshData);
+
+	// Runs every optimisation in the right order and logs the improvement
+	void Optimise(MeshData* pMeshData);
+}
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef PARALLEL_FOR_H
+#define PARALLEL_FOR_H
+
+#include <thread>
+#include <vector>
+
+// Calls func(i) for every i in [0, count) on its own thread, the calling thread takes i = 0
+template <typename Func>
+void ParallelFor(int count, const Func& func)
+{
+	std::vector<std::thread> threads;
+	threads.reserve(count);
+
+	for(int i = 1; i < count; ++i)
+	{
+		threads.emplace_back(func, i);
+	}
+
+	func(0);
+
+	for(std::thread& thread : threads)
+	{
+		thread.join();
+	}
+}
+
+#endif
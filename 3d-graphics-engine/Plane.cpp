@@ -1,3 +1,4 @@
+#include "GLState.h"
 #include "Mesh.h"
 #include "Plane.h"
 #include "ShaderProgram.h"
@@ -15,10 +16,10 @@ Plane::Plane(int size, const glm::vec3& position)
 
 void Plane::Render()
 {
-	glEnable(GL_PRIMITIVE_RESTART);
+	GLState::SetEnabled(GL_PRIMITIVE_RESTART, true);
 	glPrimitiveRestartIndex(0xFFFF);
 
 	m_mesh->Render(GL_TRIANGLE_STRIP);
 
-	glDisable(GL_PRIMITIVE_RESTART);
+	GLState::SetEnabled(GL_PRIMITIVE_RESTART, false);
 }
\ No newline at end of file
@@ -1,7 +1,9 @@
 #include "PointLight.h"
-#include "ShaderProgram.h"
+#include "UniformBlocks.h"
 #include <glm/gtc/matrix_transform.hpp>
-#include <string>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
 
 int PointLight::s_count = 0;
 
@@ -15,6 +17,11 @@ namespace
 	constexpr float LIGHT_MATRIX_POINT_FAR_PLANE = 10.0f;
 
 	constexpr float POINT_SHADOW_BIAS = 0.000075f;
+
+	// The attenuated brightness of the light's brightest channel below which a fragment is
+	// considered unlit, about one step of an 8-bit colour channel. It is absolute rather than
+	// relative to the light, so brighter lights reach further.
+	constexpr float LIGHT_CUTOFF = 1.0f / 256.0f;
 }
 
 PointLight::PointLight(const glm::vec3& position, const glm::vec3& color, float intensity,
@@ -32,20 +39,44 @@ PointLight::~PointLight()
 	std::cout << "PointLight [" << m_id << "] destroyed\n";
 }
 
-void PointLight::SetUniforms(ShaderProgram* pShader, int shadowIndex)
+void PointLight::WriteUniforms(PointLightUniforms* pUniforms) const
+{
+	PointLightUniforms& uniforms = *pUniforms;
+	uniforms.light.shadowIndex = m_shadowIndex;
+
+	uniforms.light.ambient  = GetAmbient();
+	uniforms.light.diffuse  = GetDiffuse();
+	uniforms.light.specular = GetSpecular();
+	uniforms.position = m_position;
+	uniforms.radius   = CalculateRadius();
+
+	uniforms.quadratic = m_attenuation.quadratic;
+	uniforms.linear    = m_attenuation.linear;
+	uniforms.constant  = m_attenuation.constant;
+}
+
+float PointLight::CalculateRadius() const
 {
-	std::string idStr = std::to_string(m_id);
+	const glm::vec3 colour = GetAmbient() + GetDiffuse() + GetSpecular();
+	const float brightness = std::max({ colour.r, colour.g, colour.b });
+
+	// Solve quadratic * d^2 + linear * d + constant = brightness / cutoff for the distance d
+	const float a = m_attenuation.quadratic;
+	const float b = m_attenuation.linear;
+	const float c = m_attenuation.constant - brightness / LIGHT_CUTOFF;
 
-	pShader->SetUniform("pointLights[" + idStr + "].light.shadowIndex", shadowIndex);
+	if(c >= 0.0f)
+	{
+		// Too dim to be seen at any distance
+		return 0.0f;
+	}
 
-	pShader->SetUniform("pointLights[" + idStr + "].light.ambient",  GetAmbient());
-	pShader->SetUniform("pointLights[" + idStr + "].light.diffuse",  GetDiffuse());
-	pShader->SetUniform("pointLights[" + idStr + "].light.specular", GetSpecular());
-	pShader->SetUniform("pointLights[" + idStr + "].position", m_position);
+	if(a <= 0.0f)
+	{
+		return b > 0.0f ? -c / b : FLT_MAX;
+	}
 
-	pShader->SetUniform("pointLights[" + idStr + "].attenuation.quadratic", m_attenuation.quadratic);
-	pShader->SetUniform("pointLights[" + idStr + "].attenuation.linear",    m_attenuation.linear);
-	pShader->SetUniform("pointLights[" + idStr + "].attenuation.constant",  m_attenuation.constant);
+	return (-b + std::sqrt(b * b - 4.0f * a * c)) / (2.0f * a);
 }
 
 void PointLight::CreateShadowData(float aspectRatio)
@@ -61,11 +92,18 @@ void PointLight::CreateShadowData(float aspectRatio)
 	m_shadowData = new ShadowData(lightProjectionMatrix, lightViewMatrix,
 		LIGHT_MATRIX_POINT_NEAR_PLANE, LIGHT_MATRIX_POINT_FAR_PLANE, POINT_SHADOW_BIAS
 	, false);
+	m_shadowDirty = true;
 }
 
 void PointLight::SetPosition(const glm::vec3& position)
 {
+	if(position == m_position)
+	{
+		return;
+	}
+
 	m_position = position;
+	m_shadowDirty = true;
 
 	// Create a new view matrix with the new position
 	glm::mat4 lightViewMatrix = glm::lookAt(m_position, glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
@@ -4,7 +4,7 @@
 #include "Light.h"
 #include <glm/glm.hpp>
 
-class ShaderProgram;
+struct PointLightUniforms;
 
 class PointLight : public Light
 {
@@ -29,7 +29,12 @@ public:
 
 	~PointLight();
 
-	virtual void SetUniforms(ShaderProgram* pShader, int shadowIndex) override;
+	// Writes the light's attributes to its element of the point light buffer
+	void WriteUniforms(PointLightUniforms* pUniforms) const;
+
+	// The distance at which the attenuated light falls below a visible level,
+	// FLT_MAX if the light never attenuates
+	float CalculateRadius() const;
 
 	void CreateShadowData(float aspectRatio);
 	void SetPosition(const glm::vec3& position);
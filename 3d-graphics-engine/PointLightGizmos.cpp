@@ -0,0 +1,79 @@
+#include "GLState.h"
+#include "Mesh.h"
+#include "PointLight.h"
+#include "PointLightGizmos.h"
+#include "ShaderProgram.h"
+#include <GL\glew.h>
+#include <glm\glm.hpp>
+#include <glm\gtc\matrix_transform.hpp>
+#include <vector>
+
+namespace
+{
+	constexpr UniformHandle UNIFORM_VIEW_PROJ_MATRIX("viewProjMatrix");
+	constexpr UniformHandle UNIFORM_MESH_MATRIX("meshMatrix");
+	constexpr UniformHandle UNIFORM_OVERRIDE_COLOUR("overrideColour");
+	constexpr UniformHandle UNIFORM_DIFFUSE_COLOUR("diffuseColour");
+}
+
+PointLightGizmos::PointLightGizmos()
+	: m_pShader(nullptr)
+	, m_pMesh(nullptr)
+	, m_bufferID(0)
+{
+	glGenBuffers(1, &m_bufferID);
+}
+
+PointLightGizmos::~PointLightGizmos()
+{
+	GLState::DeleteBuffers(1, &m_bufferID);
+}
+
+void PointLightGizmos::Initialise(ShaderProgram* pShader, const Mesh* pMesh)
+{
+	m_pShader = pShader;
+	m_pMesh = pMesh;
+}
+
+void PointLightGizmos::Update(const std::vector<PointLight*>& pointLights)
+{
+	m_updatedGizmos.clear();
+	for(const PointLight* pLight : pointLights)
+	{
+		m_updatedGizmos.push_back(Gizmo{ glm::vec4(pLight->GetPosition(), 1.0f), glm::vec4(pLight->GetDiffuse(), 1.0f) });
+	}
+
+	if(m_updatedGizmos == m_gizmos)
+	{
+		return;
+	}
+
+	m_gizmos.swap(m_updatedGizmos);
+
+	GLState::BindBuffer(GL_SHADER_STORAGE_BUFFER, m_bufferID);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(Gizmo) * m_gizmos.size(), m_gizmos.data(), GL_DYNAMIC_DRAW);
+}
+
+bool PointLightGizmos::Render(const glm::mat4& viewProjection, const glm::vec3* pColourOverride) const
+{
+	if(m_gizmos.empty() || !m_pMesh->IsLoaded())
+	{
+		return false;
+	}
+
+	m_pShader->Bind();
+	m_pShader->SetUniform(UNIFORM_VIEW_PROJ_MATRIX, viewProjection);
+	m_pShader->SetUniform(UNIFORM_MESH_MATRIX,
+		glm::scale(glm::mat4(1.0f), glm::vec3(GIZMO_SCALE)) * m_pMesh->GetDequantisationMatrix());
+
+	m_pShader->SetUniform(UNIFORM_OVERRIDE_COLOUR, pColourOverride != nullptr);
+	if(pColourOverride)
+	{
+		m_pShader->SetUniform(UNIFORM_DIFFUSE_COLOUR, *pColourOverride);
+	}
+
+	GLState::BindBufferBase(GL_SHADER_STORAGE_BUFFER, BINDING_POINT, m_bufferID);
+
+	m_pMesh->RenderInstanced(static_cast<GLsizei>(m_gizmos.size()));
+	return true;
+}
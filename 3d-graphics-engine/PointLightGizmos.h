@@ -0,0 +1,58 @@
+#ifndef POINT_LIGHT_GIZMOS_H
+#define POINT_LIGHT_GIZMOS_H
+
+#include <GL\glew.h>
+#include <glm\glm.hpp>
+#include <cstddef>
+#include <vector>
+
+class Mesh;
+class PointLight;
+class ShaderProgram;
+
+// Draws a small mesh at the position of every point light, in the light's colour,
+// with a single instanced draw call
+class PointLightGizmos
+{
+	// The per-light data, laid out to match the std430 Gizmo struct in the shader
+	struct Gizmo
+	{
+		glm::vec4 position;
+		glm::vec4 colour;
+
+		bool operator==(const Gizmo& other) const { return position == other.position && colour == other.colour; }
+	};
+
+	ShaderProgram* m_pShader;
+	const Mesh* m_pMesh;
+
+	GLuint m_bufferID;
+
+	// The gizmos currently in the buffer, and the ones built from the lights this frame
+	std::vector<Gizmo> m_gizmos;
+	std::vector<Gizmo> m_updatedGizmos;
+
+	// The size of each gizmo relative to the mesh
+	static constexpr float GIZMO_SCALE = 0.1f;
+
+public:
+	// The binding point the shader reads the gizmos from
+	static constexpr GLuint BINDING_POINT = 1;
+
+	PointLightGizmos();
+	~PointLightGizmos();
+
+	PointLightGizmos(const PointLightGizmos&) = delete;
+	PointLightGizmos& operator=(const PointLightGizmos&) = delete;
+
+	void Initialise(ShaderProgram* pShader, const Mesh* pMesh);
+
+	// Uploads the gizmos only if a light has been added, removed, moved or recoloured since the last update
+	void Update(const std::vector<PointLight*>& pointLights);
+
+	// Draws every gizmo, in pColourOverride if it is given rather than in each light's colour.
+	// Returns false if nothing was drawn.
+	bool Render(const glm::mat4& viewProjection, const glm::vec3* pColourOverride = nullptr) const;
+};
+
+#endif
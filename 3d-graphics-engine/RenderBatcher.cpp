@@ -0,0 +1,101 @@
+#include "Entity.h"
+#include "Material.h"
+#include "Mesh.h"
+#include "RenderBatcher.h"
+#include "RenderQueue.h"
+#include "ShaderProgram.h"
+#include "Texture.h"
+#include <glm\glm.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+	// All entities are currently drawn in the same layer
+	constexpr std::uint32_t ENTITY_LAYER = 0;
+}
+
+void RenderBatcher::Build(const std::vector<const Entity*>& entities, BatchGrouping grouping,
+	const glm::vec3& eyePosition)
+{
+	const bool groupByShaderAndMaterial = grouping == BatchGrouping::BY_MESH_SHADER_AND_MATERIAL;
+
+	m_queue.clear();
+	m_instances.clear();
+	m_batches.clear();
+	m_instanceEntities.clear();
+
+	for(std::size_t i = 0; i < entities.size(); ++i)
+	{
+		const Entity* entity = entities[i];
+		const Material* pMaterial = entity->GetMaterial();
+
+		// Passes that ignore materials leave the shader and texture out, so only the mesh is sorted on
+		GLuint shaderID = 0;
+		GLuint textureID = 0;
+		if(groupByShaderAndMaterial)
+		{
+			shaderID = entity->GetShader()->GetProgramID();
+			textureID = pMaterial->HasTexture() ? pMaterial->GetDiffuseMap()->GetTextureID() : 0;
+		}
+
+		const float depth = glm::distance(eyePosition, entity->GetPosition());
+		const std::uint64_t key = RenderQueue::MakeKey(ENTITY_LAYER, shaderID, textureID,
+			entity->GetMesh()->GetVertexArrayID(), depth);
+
+		m_queue.push_back(RenderQueue::Item{ key, static_cast<std::uint32_t>(i) });
+	}
+
+	RenderQueue::Sort(&m_queue, &m_sortScratch);
+
+	auto runBegin = m_queue.begin();
+	while(runBegin != m_queue.end())
+	{
+		const Entity* first = entities[runBegin->index];
+
+		// The run of entities with the same state. The pointers are compared too, since a GL name
+		// that does not fit in its key field can give different objects the same key.
+		auto runEnd = std::find_if(runBegin, m_queue.end(), [&](const RenderQueue::Item& item)
+		{
+			const Entity* entity = entities[item.index];
+			return RenderQueue::GetStateKey(item.key) != RenderQueue::GetStateKey(runBegin->key)
+				|| entity->GetMesh() != first->GetMesh()
+				|| (groupByShaderAndMaterial && entity->GetShader() != first->GetShader());
+		});
+
+		// Split the run into groups of equal materials, there are usually only a few per mesh.
+		// The partition is stable, so each group stays sorted front to back.
+		while(runBegin != runEnd)
+		{
+			const Entity* groupFirst = entities[runBegin->index];
+			const Material* pMaterial = groupFirst->GetMaterial();
+
+			auto groupEnd = runEnd;
+			if(groupByShaderAndMaterial)
+			{
+				groupEnd = std::stable_partition(runBegin, runEnd, [&](const RenderQueue::Item& item)
+				{
+					return *entities[item.index]->GetMaterial() == *pMaterial;
+				});
+			}
+
+			RenderBatch batch;
+			batch.pMesh = groupFirst->GetMesh();
+			batch.pShader = groupFirst->GetShader();
+			batch.pMaterial = pMaterial;
+			batch.firstInstance = static_cast<GLint>(m_instances.size());
+			batch.numInstances = static_cast<GLsizei>(groupEnd - runBegin);
+
+			for(auto it = runBegin; it != groupEnd; ++it)
+			{
+				const Entity* entity = entities[it->index];
+				m_instances.push_back(InstanceData{ entity->CalculateModelMatrix(), entity->CalculateNormalMatrix() });
+				m_instanceEntities.push_back(it->index);
+			}
+
+			m_batches.push_back(batch);
+			runBegin = groupEnd;
+		}
+	}
+}
@@ -0,0 +1,62 @@
+#ifndef RENDER_BATCHER_H
+#define RENDER_BATCHER_H
+
+#include "InstanceBuffer.h"
+#include "RenderQueue.h"
+#include <GL\glew.h>
+#include <glm\glm.hpp>
+#include <cstdint>
+#include <vector>
+
+class Entity;
+class Material;
+class Mesh;
+class ShaderProgram;
+
+// A group of entities that are drawn with a single instanced draw call
+struct RenderBatch
+{
+	const Mesh* pMesh;
+	ShaderProgram* pShader;
+	const Material* pMaterial;
+
+	// The range of the batch's instances in the instance buffer
+	GLint firstInstance;
+	GLsizei numInstances;
+};
+
+// Which properties of an entity must match for it to share a batch
+enum class BatchGrouping
+{
+	// For passes that draw every entity with the same shader and ignore materials
+	BY_MESH,
+
+	BY_MESH_SHADER_AND_MATERIAL
+};
+
+// Groups entities into batches and builds the instance data for them
+class RenderBatcher
+{
+	// The entities sorted by their RenderQueue key
+	std::vector<RenderQueue::Item> m_queue;
+	std::vector<RenderQueue::Item> m_sortScratch;
+
+	std::vector<InstanceData> m_instances;
+	std::vector<RenderBatch> m_batches;
+
+	// The index in the entities passed to Build of the entity each instance was made from
+	std::vector<std::uint32_t> m_instanceEntities;
+
+public:
+	// Replaces the batches with ones for the given entities, every entity's mesh must be loaded.
+	// Batches are ordered by shader, then texture, then mesh, so that consecutive batches share as
+	// much state as possible. The instances of each batch are stored together, nearest to the eye
+	// first, ready to be uploaded to an InstanceBuffer.
+	void Build(const std::vector<const Entity*>& entities, BatchGrouping grouping, const glm::vec3& eyePosition);
+
+	const std::vector<RenderBatch>& GetBatches() const { return m_batches; }
+	const std::vector<InstanceData>& GetInstances() const { return m_instances; }
+	const std::vector<std::uint32_t>& GetInstanceEntities() const { return m_instanceEntities; }
+};
+
+#endif
@@ -0,0 +1,95 @@
+#include "RenderQueue.h"
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	// Sorting a byte at a time keeps the histograms small enough to stay in the L1 cache
+	constexpr int RADIX_BITS = 8;
+	constexpr int RADIX_SIZE = 1 << RADIX_BITS;
+	constexpr int NUM_DIGITS = 64 / RADIX_BITS;
+
+	std::uint64_t PackField(std::uint64_t value, int bits, int shift)
+	{
+		return (value & ((std::uint64_t(1) << bits) - 1)) << shift;
+	}
+}
+
+namespace RenderQueue
+{
+	std::uint64_t MakeKey(std::uint32_t layer, GLuint shader, GLuint texture, GLuint mesh, float depth)
+	{
+		// The bits of a non-negative float sort in the same order as its value. Dropping the low bits
+		// of the mantissa keeps 11 bits of precision, which is plenty for ordering draws.
+		std::uint32_t depthBits;
+		std::memcpy(&depthBits, &depth, sizeof(depthBits));
+		depthBits = (depth > 0.0f) ? depthBits >> (32 - DEPTH_BITS) : 0;
+
+		return PackField(layer, LAYER_BITS, LAYER_SHIFT)
+			| PackField(shader, SHADER_BITS, SHADER_SHIFT)
+			| PackField(texture, TEXTURE_BITS, TEXTURE_SHIFT)
+			| PackField(mesh, MESH_BITS, MESH_SHIFT)
+			| PackField(depthBits, DEPTH_BITS, DEPTH_SHIFT);
+	}
+
+	void Sort(std::vector<Item>* pItems, std::vector<Item>* pScratch)
+	{
+		const std::size_t count = pItems->size();
+		if(count < 2)
+		{
+			return;
+		}
+
+		pScratch->resize(count);
+
+		// Count every digit in a single pass over the keys
+		std::array<std::array<std::uint32_t, RADIX_SIZE>, NUM_DIGITS> histograms{};
+		for(const Item& item : *pItems)
+		{
+			for(int digit = 0; digit < NUM_DIGITS; ++digit)
+			{
+				++histograms[digit][(item.key >> (digit * RADIX_BITS)) & (RADIX_SIZE - 1)];
+			}
+		}
+
+		std::vector<Item>* pSource = pItems;
+		std::vector<Item>* pDest = pScratch;
+
+		for(int digit = 0; digit < NUM_DIGITS; ++digit)
+		{
+			std::array<std::uint32_t, RADIX_SIZE>& histogram = histograms[digit];
+
+			// Most keys share their upper digits, such as the layer, so these passes are skipped
+			const std::uint8_t firstValue = (pSource->front().key >> (digit * RADIX_BITS)) & (RADIX_SIZE - 1);
+			if(histogram[firstValue] == count)
+			{
+				continue;
+			}
+
+			// Turn the counts into the position of the first item with each value
+			std::uint32_t offset = 0;
+			for(std::uint32_t& bucket : histogram)
+			{
+				const std::uint32_t bucketCount = bucket;
+				bucket = offset;
+				offset += bucketCount;
+			}
+
+			for(const Item& item : *pSource)
+			{
+				(*pDest)[histogram[(item.key >> (digit * RADIX_BITS)) & (RADIX_SIZE - 1)]++] = item;
+			}
+
+			std::swap(pSource, pDest);
+		}
+
+		// An odd number of passes leaves the result in the scratch buffer
+		if(pSource != pItems)
+		{
+			pItems->swap(*pScratch);
+		}
+	}
+}
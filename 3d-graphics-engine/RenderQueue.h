@@ -0,0 +1,56 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <GL\glew.h>
+#include <cstdint>
+#include <vector>
+
+// Orders draws by a packed 64-bit key, so that draws sharing GL state end up next to each other.
+// From the most to the least significant bits a key holds:
+//
+//   layer (4) | shader (12) | texture (12) | mesh (16) | depth (20)
+//
+// Layers are drawn in increasing order, everything is currently drawn in layer 0. The shader,
+// texture and mesh fields are the GL names of the program, diffuse map and vertex array, which
+// are small integers. Names that do not fit are wrapped, which only costs some state changes.
+// Depth is the distance from the eye, so that draws sharing state are drawn front to back.
+namespace RenderQueue
+{
+	struct Item
+	{
+		std::uint64_t key;
+
+		// The index of whatever is being drawn in the caller's array
+		std::uint32_t index;
+	};
+
+	constexpr int LAYER_BITS   = 4;
+	constexpr int SHADER_BITS  = 12;
+	constexpr int TEXTURE_BITS = 12;
+	constexpr int MESH_BITS    = 16;
+	constexpr int DEPTH_BITS   = 20;
+
+	constexpr int DEPTH_SHIFT   = 0;
+	constexpr int MESH_SHIFT    = DEPTH_SHIFT + DEPTH_BITS;
+	constexpr int TEXTURE_SHIFT = MESH_SHIFT + MESH_BITS;
+	constexpr int SHADER_SHIFT  = TEXTURE_SHIFT + TEXTURE_BITS;
+	constexpr int LAYER_SHIFT   = SHADER_SHIFT + SHADER_BITS;
+
+	static_assert(LAYER_SHIFT + LAYER_BITS == 64, "The key fields must fill 64 bits");
+
+	// Depth must not be negative, it is quantised keeping its order
+	std::uint64_t MakeKey(std::uint32_t layer, GLuint shader, GLuint texture, GLuint mesh, float depth);
+
+	// The key with the depth removed, equal for draws that share all of their state
+	inline std::uint64_t GetStateKey(std::uint64_t key)
+	{
+		return key >> MESH_SHIFT;
+	}
+
+	// Sorts the items by key with a least significant digit radix sort, which keeps items with equal
+	// keys in their original order. pScratch is used as a second buffer, so that sorting does not
+	// allocate once both vectors have grown to the number of items.
+	void Sort(std::vector<Item>* pItems, std::vector<Item>* pScratch);
+}
+
+#endif
@@ -1,19 +1,29 @@
+#include "BoundingVolume.h"
 #include "Camera.h"
 #include "Constants.h"
+#include "DirectionalLight.h"
 #include "GraphicsEngine.h"
 #include "Entity.h"
+#include "GLState.h"
 #include "Light.h"
+#include "Material.h"
 #include "Mesh.h"
 #include "MeshCreator.h"
 #include "Model.h"
+#include "PointLight.h"
 #include "Renderer.h"
+#include "ShaderProgram.h"
 #include "ShaderUtil.h"
 #include "Skybox.h"
 #include "Texture.h"
+#include "UniformBlocks.h"
 #include <GL\glew.h>
 #include <glm\glm.hpp>
 #include <glm\gtc\matrix_transform.hpp>
+#include <algorithm>
+#include <chrono>
 #include <array>
+#include <optional>
 
 namespace
 {
@@ -22,10 +32,28 @@ namespace
 		0.0f, 0.5f, 0.0f, 0.0f,
 		0.0f, 0.0f, 0.5f, 0.0f,
 		0.5f, 0.5f, 0.5f, 1.0f);
+
+	// The automatic depth pre-pass is enabled once the overdraw reaches the first ratio and disabled
+	// once it falls below the second, the gap keeps it from switching back and forth. While it is
+	// disabled the pre-pass still runs every OVERDRAW_PROBE_INTERVAL frames to measure the overdraw.
+	constexpr float DEPTH_PRE_PASS_ENABLE_OVERDRAW = 1.3f;
+	constexpr float DEPTH_PRE_PASS_DISABLE_OVERDRAW = 1.15f;
+	constexpr int OVERDRAW_PROBE_INTERVAL = 60;
+
+	constexpr UniformHandle UNIFORM_INSTANCE_OFFSET("instanceOffset");
+	constexpr UniformHandle UNIFORM_OCTAHEDRAL_NORMALS("octahedralNormals");
+	constexpr UniformHandle UNIFORM_LIGHT_MATRIX("lightMatrix");
+	constexpr UniformHandle UNIFORM_VIEW_PROJ_MATRIX("viewProjMatrix");
+	constexpr UniformHandle UNIFORM_DIFFUSE_COLOUR("diffuseColour");
+	constexpr UniformHandle UNIFORM_IS_ORTHO("isOrtho");
+	constexpr UniformHandle UNIFORM_NEAR_Z("nearZ");
+	constexpr UniformHandle UNIFORM_FAR_Z("farZ");
+	constexpr UniformHandle UNIFORM_MESH_MATRIX("meshMatrix");
+	constexpr UniformHandle UNIFORM_FAR_PLANE("farPlane");
 }
 
 Renderer::Renderer(GraphicsEngine* pEngine, const Camera& cam,
-	const std::array<Light*, Constants::MAX_LIGHTS>& lights,
+	const std::vector<Light*>& lights,
 	const glm::vec3& globalAmbientLight)
 	: m_pGraphicsEngine(pEngine)
 	, m_camera(cam)
@@ -38,7 +66,45 @@ Renderer::Renderer(GraphicsEngine* pEngine, const Camera& cam,
 	, m_renderPointLights(false)
 	, m_wireframeModeEnabled(false)
 	, m_shadowMapViewIndex(0)
+	, m_cameraBuffer(sizeof(CameraUniformBlock), UniformBlocks::CAMERA_BINDING)
+	, m_lightBuffer(sizeof(LightUniformBlock), UniformBlocks::LIGHT_BINDING)
+	, m_shadowBuffer(sizeof(ShadowUniformBlock), UniformBlocks::SHADOW_BINDING)
+	, m_pointLightBuffer(sizeof(PointLightUniforms), UniformBlocks::POINT_LIGHT_BUFFER_BINDING)
+	, m_directionalLightBuffer(sizeof(DirectionalLightUniforms), UniformBlocks::DIRECTIONAL_LIGHT_BUFFER_BINDING)
+	, m_lightAssignment(LightAssignment::CLUSTERED)
+	, m_shadingPath(ShadingPath::FORWARD)
+	, m_emptyVertexArrayID(0)
+	, m_pLightVolumeMesh(nullptr)
+	, m_depthPrePassMode(DepthPrePassMode::AUTOMATIC)
+	, m_autoDepthPrePass(false)
+	, m_framesSinceOverdrawMeasured(OVERDRAW_PROBE_INTERVAL)
+	, m_prePassSamplesQuery(0)
+	, m_renderPassSamplesQuery(0)
+	, m_overdrawQueryActive(false)
+	, m_clusterUniformBuffer(sizeof(ClusterUniformBlock), UniformBlocks::CLUSTER_BINDING)
+	, m_clusterBuffer(sizeof(LightClusters::Cluster), UniformBlocks::CLUSTER_BUFFER_BINDING)
+	, m_clusterLightIndexBuffer(sizeof(std::uint32_t), UniformBlocks::CLUSTER_LIGHT_INDEX_BUFFER_BINDING)
+	, m_instanceLightBuffer(sizeof(InstanceLights), UniformBlocks::INSTANCE_LIGHT_BUFFER_BINDING)
+	, m_entityLightIndexBuffer(sizeof(std::uint32_t), UniformBlocks::ENTITY_LIGHT_INDEX_BUFFER_BINDING)
+	, m_stats{}
+	, m_shadowMapLights{}
+	, m_shadowCameraViewProjection(1.0f)
+	, m_numShadowedEntities(0)
+	, m_shadowUpdateMode(ShadowUpdateMode::ALL)
+	, m_maxShadowUpdatesPerFrame(Constants::DEFAULT_SHADOW_UPDATES_PER_FRAME)
+	, m_shadowBudgetMs(Constants::DEFAULT_SHADOW_BUDGET_MS)
+	, m_shadowMapPending{}
+	, m_shadowMapStaleFrames{}
+	, m_shadowMapMatrices{}
+	, m_shadowTimerQueries{}
+	, m_shadowTimerActive{}
+	, m_shadowPassMs{}
 {
+	glGenQueries(Constants::MAX_SHADOW_MAPS, m_shadowTimerQueries.data());
+	glGenVertexArrays(1, &m_emptyVertexArrayID);
+	glGenQueries(1, &m_prePassSamplesQuery);
+	glGenQueries(1, &m_renderPassSamplesQuery);
+
 	// Store the clear colour
 	GLfloat clearCol[4];
 	glGetFloatv(GL_COLOR_CLEAR_VALUE, clearCol);
@@ -49,17 +115,12 @@ Renderer::Renderer(GraphicsEngine* pEngine, const Camera& cam,
 	m_defaultClearColour.a = clearCol[3];
 }
 
-void Renderer::UpdateAmbientLight() const
+Renderer::~Renderer()
 {
-	if(m_defaultShader && m_defaultShaderTextureless)
-	{
-		m_defaultShader->SetUniform("globalAmbientLight", m_globalAmbientLight);
-		m_defaultShaderTextureless->SetUniform("globalAmbientLight", m_globalAmbientLight);
-	}
-	else
-	{
-		printf("Cannot update ambient light! Default shaders have not been assigned yet!\n");
-	}
+	glDeleteQueries(Constants::MAX_SHADOW_MAPS, m_shadowTimerQueries.data());
+	GLState::DeleteVertexArrays(1, &m_emptyVertexArrayID);
+	glDeleteQueries(1, &m_prePassSamplesQuery);
+	glDeleteQueries(1, &m_renderPassSamplesQuery);
 }
 
 void Renderer::ToggleRenderShadowMapView()
@@ -76,7 +137,7 @@ void Renderer::ToggleWireframeRendering()
 	if(m_wireframeModeEnabled)
 	{
 		printf("Wireframe rendering enabled\n");
-		glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+		GLState::PolygonMode(GL_LINE);
 
 		const glm::vec3& wfCol = WIREFRAME_CLEAR_COLOUR;
 		glClearColor(wfCol.r, wfCol.g, wfCol.b, 1.0f);
@@ -84,7 +145,7 @@ void Renderer::ToggleWireframeRendering()
 	else
 	{
 		printf("Wireframe rendering disabled\n");
-		glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+		GLState::PolygonMode(GL_FILL);
 
 		// Set the clear colour back
 		glClearColor(m_defaultClearColour.r, m_defaultClearColour.g, m_defaultClearColour.b,
@@ -106,6 +167,9 @@ void Renderer::BeforeFirstRender()
 	}
 
 	m_debugQuad.Initialise(m_pGraphicsEngine->GetShader("debug-quad"));
+	m_pointLightGizmos.Initialise(m_pGraphicsEngine->GetShader("point-light-gizmo"),
+		m_pGraphicsEngine->GetMesh("sphere.obj"));
+	m_pLightVolumeMesh = m_pGraphicsEngine->GetMesh("sphere.obj");
 
 	// Assign default shaders
 	printf("Default shader name: %s\n",
@@ -116,23 +180,12 @@ void Renderer::BeforeFirstRender()
 	m_defaultShaderTextureless
 		= m_pGraphicsEngine->GetShader(Constants::DEFAULT_SHADER_NAME_TEXTURELESS);
 
-	// Assign 'constant' uniforms to both default shaders
-	m_defaultShader->SetUniform("globalAmbientLight", m_globalAmbientLight);
-	m_defaultShaderTextureless->SetUniform("globalAmbientLight", m_globalAmbientLight);
-
-	int pLights = m_pGraphicsEngine->GetPointLightCount();
-	int dLights = m_pGraphicsEngine->GetDirectionalLightCount();
-	m_defaultShader->SetUniform("dirLightCount", dLights);
-	m_defaultShader->SetUniform("pointLightCount", pLights);
-	m_defaultShaderTextureless->SetUniform("dirLightCount", dLights);
-	m_defaultShaderTextureless->SetUniform("pointLightCount", pLights);
-
 	// Print out the number of directional and point lights
-	printf("dirLightCount: %d\n", m_defaultShader->GetUniformiValue("dirLightCount"));
-	printf("pointLightCount: %d\n", m_defaultShader->GetUniformiValue("pointLightCount"));
+	printf("dirLightCount: %d\n", m_pGraphicsEngine->GetDirectionalLightCount());
+	printf("pointLightCount: %d\n", m_pGraphicsEngine->GetPointLightCount());
 
 	// Bind the shadow maps to the correct slots
-	for(int i = 0; i < m_pGraphicsEngine->GetLightCount(); i++)
+	for(int i = 0; i < m_pGraphicsEngine->GetShadowedLightCount(); i++)
 	{
 		m_defaultShader->SetUniform("shadowMaps[" + std::to_string(i) + "]",
 			i + 1);
@@ -144,40 +197,293 @@ void Renderer::BeforeFirstRender()
 void Renderer::NextShadowMapView()
 {
 	// Increment the index with cycling
-	m_shadowMapViewIndex = (m_shadowMapViewIndex + 1) % m_pGraphicsEngine->GetLightCount();
+	m_shadowMapViewIndex = (m_shadowMapViewIndex + 1) % m_pGraphicsEngine->GetShadowedLightCount();
 	printf("m_shadowMapViewIndex: %d\n", m_shadowMapViewIndex);
 }
 
-void Renderer::ShadowPass(const glm::mat4& lightMatrix) const
+void Renderer::CullEntities(const Frustum& cameraFrustum) const
+{
+	m_loadedEntities.clear();
+	m_cullingBounds.Clear();
+	m_visibleEntities.clear();
+
+	// Entities whose mesh is still loading have no bounds yet and are never drawn
+	const auto& entities = m_pGraphicsEngine->GetEntities();
+	for(const Entity* entity : entities)
+	{
+		if(entity->IsMeshLoaded())
+		{
+			m_loadedEntities.push_back(entity);
+			m_cullingBounds.Add(entity->CalculateWorldBounds(), entity->CalculateWorldBoundingSphere());
+		}
+	}
+
+	cameraFrustum.TestVisibility(m_cullingBounds, &m_entityVisibility);
+
+	// Keep only the visible entities, in their original order
+	for(std::size_t i = 0; i < m_loadedEntities.size(); ++i)
+	{
+		if(m_entityVisibility[i])
+		{
+			m_visibleEntities.push_back(m_loadedEntities[i]);
+		}
+	}
+
+	m_stats.numVisibleEntities = static_cast<int>(m_visibleEntities.size());
+	m_stats.numCulledEntities = static_cast<int>(m_loadedEntities.size() - m_visibleEntities.size());
+	m_stats.numShadowCasters = 0;
+	m_stats.numCulledShadowCasters = 0;
+	m_stats.numSkippedShadowPasses = 0;
+	m_stats.numDelayedShadowPasses = 0;
+	m_stats.numDrawCalls = 0;
+	m_stats.numShaderBinds = 0;
+	m_stats.numTextureBinds = 0;
+	m_stats.numVertexArrayBinds = 0;
+	m_stats.depthPrePass = false;
+}
+
+void Renderer::FindDirtyShadowMaps(const glm::mat4& cameraViewProjection,
+	std::array<bool, Constants::MAX_SHADOW_MAPS>* pDirty) const
+{
+	const int lightCount = m_pGraphicsEngine->GetShadowedLightCount();
+
+	// Any entity that finishes loading could cast a shadow into any of the maps
+	const bool entitiesChanged = m_loadedEntities.size() != m_numShadowedEntities;
+	const bool cameraChanged = cameraViewProjection != m_shadowCameraViewProjection;
+
+	std::array<std::optional<Frustum>, Constants::MAX_SHADOW_MAPS> lightFrustums;
+	pDirty->fill(false);
+
+	for(int i = 0; i < lightCount; ++i)
+	{
+		const ShadowData* pShadowData = m_lights[i]->GetShadowData();
+		if(!pShadowData)
+		{
+			continue;
+		}
+
+		lightFrustums[i].emplace(pShadowData->GetLightMatrix());
+
+		(*pDirty)[i] = m_lights[i]->IsShadowDirty() || m_shadowMapLights[i] != m_lights[i] || entitiesChanged
+			|| (pShadowData->IsOrthographic() && cameraChanged);
+	}
+
+	// A moved entity changes a shadow map if it was or is now inside the light's volume
+	for(Entity* entity : m_pGraphicsEngine->GetEntities())
+	{
+		if(!entity->IsTransformDirty())
+		{
+			continue;
+		}
+
+		if(entity->IsMeshLoaded())
+		{
+			const AABB bounds = entity->CalculateWorldBounds();
+
+			for(int i = 0; i < lightCount; ++i)
+			{
+				if(!(*pDirty)[i] && lightFrustums[i]
+					&& (lightFrustums[i]->IsVisible(bounds) || lightFrustums[i]->IsVisible(entity->GetPreviousWorldBounds())))
+				{
+					(*pDirty)[i] = true;
+				}
+			}
+		}
+
+		entity->ClearTransformDirty();
+	}
+
+	for(int i = 0; i < lightCount; ++i)
+	{
+		if((*pDirty)[i])
+		{
+			m_lights[i]->ClearShadowDirty();
+			m_shadowMapLights[i] = m_lights[i];
+		}
+	}
+
+	m_numShadowedEntities = m_loadedEntities.size();
+	m_shadowCameraViewProjection = cameraViewProjection;
+}
+
+void Renderer::ScheduleShadowUpdates(const Frustum& cameraFrustum,
+	std::array<bool, Constants::MAX_SHADOW_MAPS>* pUpdate) const
+{
+	const int lightCount = m_pGraphicsEngine->GetShadowedLightCount();
+
+	if(m_shadowUpdateMode == ShadowUpdateMode::ALL)
+	{
+		*pUpdate = m_shadowMapPending;
+		return;
+	}
+
+	pUpdate->fill(false);
+
+	std::array<int, Constants::MAX_SHADOW_MAPS> candidates;
+	std::array<float, Constants::MAX_SHADOW_MAPS> priorities;
+	int numCandidates = 0;
+
+	for(int i = 0; i < lightCount; ++i)
+	{
+		if(m_shadowMapPending[i])
+		{
+			priorities[i] = CalculateShadowPriority(i, cameraFrustum);
+			candidates[numCandidates++] = i;
+		}
+	}
+
+	std::sort(candidates.begin(), candidates.begin() + numCandidates,
+		[&priorities](int a, int b) { return priorities[a] > priorities[b]; });
+
+	// The first map is always redrawn, so that every map is eventually redrawn however small the budget
+	int numUpdates = 0;
+	float estimatedMs = 0.0f;
+
+	for(int c = 0; c < numCandidates; ++c)
+	{
+		const int i = candidates[c];
+
+		if(numUpdates > 0)
+		{
+			if(m_shadowUpdateMode == ShadowUpdateMode::TIME_SLICED_BY_COUNT && numUpdates >= m_maxShadowUpdatesPerFrame)
+			{
+				break;
+			}
+
+			// A cheaper map further down the list may still fit
+			if(m_shadowUpdateMode == ShadowUpdateMode::TIME_SLICED_BY_GPU_TIME
+				&& estimatedMs + m_shadowPassMs[i] > m_shadowBudgetMs)
+			{
+				continue;
+			}
+		}
+
+		(*pUpdate)[i] = true;
+		++numUpdates;
+		estimatedMs += m_shadowPassMs[i];
+	}
+}
+
+float Renderer::CalculateShadowPriority(int lightIndex, const Frustum& cameraFrustum) const
 {
+	// Lights that are off screen still get a little priority, so that their maps do not wait forever
+	constexpr float MIN_INFLUENCE = 0.1f;
+
+	const ShadowData* pShadowData = m_lights[lightIndex]->GetShadowData();
+
+	// An orthographic light reaches everything the camera sees
+	float influence = 1.0f;
+
+	if(!pShadowData->IsOrthographic())
+	{
+		// The light can only cast shadows as far as the far plane of its projection
+		const glm::vec3 position = pShadowData->GetViewPosition();
+		const float range = pShadowData->GetFarPlane();
+
+		if(!cameraFrustum.IsVisible(BoundingSphere{ position, range }))
+		{
+			influence = MIN_INFLUENCE;
+		}
+		else
+		{
+			const float distance = glm::distance(m_camera.GetPosition(), position);
+			influence = glm::clamp(range / std::max(distance, range), MIN_INFLUENCE, 1.0f);
+		}
+	}
+
+	return influence * (1 + m_shadowMapStaleFrames[lightIndex]);
+}
+
+void Renderer::ReadShadowTimers() const
+{
+	for(int i = 0; i < Constants::MAX_SHADOW_MAPS; ++i)
+	{
+		if(!m_shadowTimerActive[i])
+		{
+			continue;
+		}
+
+		GLint available = GL_FALSE;
+		glGetQueryObjectiv(m_shadowTimerQueries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+
+		if(available)
+		{
+			GLuint64 elapsedNs = 0;
+			glGetQueryObjectui64v(m_shadowTimerQueries[i], GL_QUERY_RESULT, &elapsedNs);
+
+			// Smooth the measurements, since the cost of a pass changes with what is culled
+			const float ms = static_cast<float>(elapsedNs / 1e6);
+			m_shadowPassMs[i] = (m_shadowPassMs[i] == 0.0f) ? ms : m_shadowPassMs[i] * 0.8f + ms * 0.2f;
+			m_shadowTimerActive[i] = false;
+		}
+	}
+}
+
+void Renderer::ShadowPass(const ShadowData& shadowData, const Frustum& cameraFrustum,
+	const BoundingSphere* pLightRange) const
+{
+	const glm::mat4 lightMatrix = shadowData.GetLightMatrix();
+
+	// The light matrix maps the light's volume to clip space, whether it is a box or a frustum
+	const Frustum lightFrustum(lightMatrix);
+	lightFrustum.TestVisibility(m_cullingBounds, &m_shadowCasterVisibility);
+
+	if(shadowData.IsOrthographic())
+	{
+		cameraFrustum.TestSweptVisibility(m_cullingBounds, shadowData.GetViewDirection(), &m_sweptVisibility);
+
+		for(std::size_t i = 0; i < m_shadowCasterVisibility.size(); ++i)
+		{
+			m_shadowCasterVisibility[i] &= m_sweptVisibility[i];
+		}
+	}
+
+	if(pLightRange)
+	{
+		for(std::size_t i = 0; i < m_shadowCasterVisibility.size(); ++i)
+		{
+			m_shadowCasterVisibility[i] &= BoundingVolume::Intersects(*pLightRange, m_cullingBounds.GetAABB(i));
+		}
+	}
+
 	// Reduces the visiblity of shadow acne
-	glEnable(GL_POLYGON_OFFSET_FILL);
-	glPolygonOffset(1.1f, 4.0f);
+	GLState::SetEnabled(GL_POLYGON_OFFSET_FILL, true);
+	GLState::PolygonOffset(1.1f, 4.0f);
 
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+	m_shadowCasters.clear();
+	for(std::size_t i = 0; i < m_loadedEntities.size(); ++i)
+	{
+		if(m_shadowCasterVisibility[i])
+		{
+			m_shadowCasters.push_back(m_loadedEntities[i]);
+		}
+	}
+
+	m_stats.numShadowCasters += static_cast<int>(m_shadowCasters.size());
+	m_stats.numCulledShadowCasters += static_cast<int>(m_loadedEntities.size() - m_shadowCasters.size());
+
+	// Only depth is written, so casters that share a mesh are drawn together whatever their material
+	PrepareBatches(m_shadowCasters, BatchGrouping::BY_MESH, shadowData.GetViewPosition());
+
 	ShaderProgram* pCurShader = m_pGraphicsEngine->GetShader("shadow-map");
 	pCurShader->Bind();
+	++m_stats.numShaderBinds;
+	pCurShader->SetUniform(UNIFORM_LIGHT_MATRIX, lightMatrix);
 
-	const auto& entities = m_pGraphicsEngine->GetEntities();
-	for(const auto& entity : entities)
-	{
-		glm::mat4 modelMatrix = entity->CalculateModelMatrix();
+	RenderBatches(pCurShader);
 
-		pCurShader->SetUniform("lightMatrix", lightMatrix * modelMatrix);
-
-		entity->Render();
-	}
-	glDisable(GL_POLYGON_OFFSET_FILL);
+	GLState::SetEnabled(GL_POLYGON_OFFSET_FILL, false);
 }
 
 void Renderer::RenderPass(const glm::mat4& projection, const glm::mat4& view,
 	const tLightMatrixArray& lightMatrices) const
 {
 	// Bind back to the default framebuffer
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	GLState::BindFramebuffer(0);
 
-	glViewport(0, 0, m_pGraphicsEngine->GetWindowWidth(), m_pGraphicsEngine->GetWindowHeight());
+	GLState::Viewport(0, 0, m_pGraphicsEngine->GetWindowWidth(), m_pGraphicsEngine->GetWindowHeight());
 
 	// Clear its colour buffer and depth buffer
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -189,33 +495,454 @@ void Renderer::RenderPass(const glm::mat4& projection, const glm::mat4& view,
 		m_skybox->Render();
 	}
 
-	// Get the entities
-	const auto& entities = m_pGraphicsEngine->GetEntities();
+	PrepareBatches(m_visibleEntities, BatchGrouping::BY_MESH_SHADER_AND_MATERIAL, m_camera.GetPosition());
+	UpdateShadowBlock(lightMatrices);
 
-	for(const auto& entity : entities)
+	if(m_lightAssignment == LightAssignment::PER_ENTITY)
 	{
-		ShaderProgram* pCurShader = entity->GetShader();
-		pCurShader->Bind();
+		UploadInstanceLights();
+	}
+
+	++m_framesSinceOverdrawMeasured;
+	const bool prePass = ShouldRunDepthPrePass();
+	const bool measureOverdraw = prePass && !m_overdrawQueryActive;
+	m_stats.depthPrePass = prePass;
 
-		entity->Bind(pCurShader);
+	if(measureOverdraw)
+	{
+		glBeginQuery(GL_SAMPLES_PASSED, m_prePassSamplesQuery);
+	}
+
+	if(prePass)
+	{
+		DepthPrePass();
+
+		// Every visible fragment already has its depth, so each pixel is only shaded once
+		GLState::DepthFunc(GL_EQUAL);
+		GLState::DepthMask(false);
+	}
 
-		glm::mat4 modelMatrix = entity->CalculateModelMatrix();
+	if(measureOverdraw)
+	{
+		glEndQuery(GL_SAMPLES_PASSED);
+		glBeginQuery(GL_SAMPLES_PASSED, m_renderPassSamplesQuery);
+	}
+
+	RenderMaterialBatches();
+
+	if(measureOverdraw)
+	{
+		glEndQuery(GL_SAMPLES_PASSED);
+		m_overdrawQueryActive = true;
+		m_framesSinceOverdrawMeasured = 0;
+	}
+
+	if(prePass)
+	{
+		GLState::DepthMask(true);
+		GLState::DepthFunc(GL_LEQUAL);
+	}
+}
+
+bool Renderer::ShouldRunDepthPrePass() const
+{
+	switch(m_depthPrePassMode)
+	{
+		case DepthPrePassMode::ON:
+			return true;
+
+		case DepthPrePassMode::AUTOMATIC:
+			return m_autoDepthPrePass || m_framesSinceOverdrawMeasured >= OVERDRAW_PROBE_INTERVAL;
+
+		default:
+			return false;
+	}
+}
+
+void Renderer::ReadOverdrawQueries() const
+{
+	if(!m_overdrawQueryActive)
+	{
+		return;
+	}
+
+	// The render pass ends the measurement, so its result is the last to become available
+	GLint available = GL_FALSE;
+	glGetQueryObjectiv(m_renderPassSamplesQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+
+	if(!available)
+	{
+		return;
+	}
+
+	GLuint64 prePassSamples = 0;
+	GLuint64 visibleSamples = 0;
+	glGetQueryObjectui64v(m_prePassSamplesQuery, GL_QUERY_RESULT, &prePassSamples);
+	glGetQueryObjectui64v(m_renderPassSamplesQuery, GL_QUERY_RESULT, &visibleSamples);
+	m_overdrawQueryActive = false;
+
+	// The pre-pass draws the batches in the order the render pass would without it, so the
+	// samples that pass its depth test are the ones the render pass would have shaded
+	if(visibleSamples > 0)
+	{
+		m_stats.overdrawRatio = static_cast<float>(prePassSamples) / static_cast<float>(visibleSamples);
 
-		// Get the light count
-		int lightCount = m_pGraphicsEngine->GetLightCount();
-		for(int i = 0; i < lightCount; ++i)
+		if(m_stats.overdrawRatio >= DEPTH_PRE_PASS_ENABLE_OVERDRAW)
 		{
-			ShadowData* shadowData = m_lights[i]->GetShadowData();
-			pCurShader->SetUniform("shadowBiases[" + std::to_string(i) + "]",
-				shadowData->GetShadowBias());
-			pCurShader->SetUniform("lightMatrices[" + std::to_string(i) + "]",
-				lightMatrices[i] * modelMatrix);
+			m_autoDepthPrePass = true;
 		}
+		else if(m_stats.overdrawRatio < DEPTH_PRE_PASS_DISABLE_OVERDRAW)
+		{
+			m_autoDepthPrePass = false;
+		}
+	}
+}
+
+void Renderer::DepthPrePass() const
+{
+	// The pre-pass shader only reads the position of each vertex and writes no colour
+	ShaderProgram* pShader = m_pGraphicsEngine->GetShader("depth-prepass");
+	pShader->Bind();
+	++m_stats.numShaderBinds;
+
+	GLState::ColourMask(false);
+	RenderBatches(pShader);
+	GLState::ColourMask(true);
+}
+
+void Renderer::DeferredRenderPass(const glm::mat4& projection, const glm::mat4& view,
+	const tLightMatrixArray& lightMatrices) const
+{
+	const int width = m_pGraphicsEngine->GetWindowWidth();
+	const int height = m_pGraphicsEngine->GetWindowHeight();
+
+	// A minimised window has no pixels to shade, and the G-buffer cannot be empty
+	if(width == 0 || height == 0)
+	{
+		return;
+	}
+
+	// Geometry pass, every visible surface is written to the G-buffer without being lit
+	m_gBuffer.Resize(width, height);
+	m_gBuffer.Write();
+	m_gBuffer.Clear();
+
+	PrepareBatches(m_visibleEntities, BatchGrouping::BY_MESH_SHADER_AND_MATERIAL, m_camera.GetPosition());
+	UpdateShadowBlock(lightMatrices);
+	RenderMaterialBatches(m_pGraphicsEngine->GetShader("deferred-geometry"));
+
+	// Lighting passes, drawn over the skybox in the default framebuffer
+	GLState::BindFramebuffer(0);
+	GLState::Viewport(0, 0, width, height);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+	if(m_skybox)
+	{
+		m_skybox->PreRender(projection, view);
+		m_skybox->Render();
+	}
+
+	m_gBuffer.Read();
+
+	// The directional lights are applied to every pixel that was drawn to, which also copies the
+	// G-buffer's depth so that the light volumes and the gizmos are hidden by the scene
+	ShaderProgram* pShader = m_pGraphicsEngine->GetShader("deferred-directional");
+	pShader->Bind();
+	++m_stats.numShaderBinds;
+
+	GLState::DepthFunc(GL_ALWAYS);
+	GLState::BindVertexArray(m_emptyVertexArrayID);
+	++m_stats.numVertexArrayBinds;
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	++m_stats.numDrawCalls;
+	GLState::DepthFunc(GL_LEQUAL);
+
+	const int pointLightCount = m_pGraphicsEngine->GetPointLightCount();
+	if(pointLightCount == 0 || !m_pLightVolumeMesh->IsLoaded())
+	{
+		return;
+	}
+
+	// Each point light adds to the pixels inside its sphere. Only the back faces are drawn, and
+	// only where they are behind the scene, so a pixel is lit once whether or not the camera is
+	// inside the sphere. Depth clamping keeps the back faces that are beyond the far plane.
+	pShader = m_pGraphicsEngine->GetShader("deferred-point");
+	pShader->Bind();
+	++m_stats.numShaderBinds;
+	pShader->SetUniform(UNIFORM_MESH_MATRIX, m_pLightVolumeMesh->GetDequantisationMatrix());
+	pShader->SetUniform(UNIFORM_FAR_PLANE, Constants::FAR_PLANE);
+
+	GLState::SetEnabled(GL_CULL_FACE, true);
+	GLState::CullFace(GL_FRONT);
+	GLState::SetEnabled(GL_DEPTH_CLAMP, true);
+	GLState::DepthFunc(GL_GREATER);
+	GLState::DepthMask(false);
+	GLState::SetEnabled(GL_BLEND, true);
+	GLState::BlendFunc(GL_ONE, GL_ONE);
+
+	m_pLightVolumeMesh->RenderInstanced(pointLightCount);
+	++m_stats.numVertexArrayBinds;
+	++m_stats.numDrawCalls;
+
+	GLState::SetEnabled(GL_BLEND, false);
+	GLState::DepthMask(true);
+	GLState::DepthFunc(GL_LEQUAL);
+	GLState::SetEnabled(GL_DEPTH_CLAMP, false);
+	GLState::CullFace(GL_BACK);
+	GLState::SetEnabled(GL_CULL_FACE, m_pGraphicsEngine->m_enableBackfaceCulling);
+}
+
+void Renderer::RenderMaterialBatches(ShaderProgram* pOverrideShader) const
+{
+	// The state set by the previous batch, GL is only told about the parts that change
+	ShaderProgram* pCurShader = nullptr;
+	const Material* pCurMaterial = nullptr;
+	const Texture* pCurTexture = nullptr;
+	const Mesh* pCurMesh = nullptr;
+	int curOctahedralNormals = -1;
+
+	for(const RenderBatch& batch : m_batcher.GetBatches())
+	{
+		// The camera, light and shadow uniforms are read from the shared uniform blocks,
+		// so changing shader only resets the per-batch uniforms
+		ShaderProgram* pShader = pOverrideShader ? pOverrideShader : batch.pShader;
+		if(pShader != pCurShader)
+		{
+			pCurShader = pShader;
+			pCurShader->Bind();
+			++m_stats.numShaderBinds;
+
+			// Uniforms belong to the program, so the per-batch ones must be set again
+			pCurMaterial = nullptr;
+			curOctahedralNormals = -1;
+		}
+
+		// The texture unit is shared by every program, so it is not reset with the shader
+		if(batch.pMaterial->HasTexture() && batch.pMaterial->GetDiffuseMap() != pCurTexture)
+		{
+			pCurTexture = batch.pMaterial->GetDiffuseMap();
+			GLState::ActiveTexture(GL_TEXTURE0);
+			batch.pMaterial->GetDiffuseMap()->Bind();
+			++m_stats.numTextureBinds;
+		}
+
+		if(!pCurMaterial || !(*batch.pMaterial == *pCurMaterial))
+		{
+			pCurMaterial = batch.pMaterial;
+			pCurMaterial->SetUniforms(pCurShader);
+		}
+
+		const int octahedralNormals = batch.pMesh->HasOctahedralNormals();
+		if(octahedralNormals != curOctahedralNormals)
+		{
+			curOctahedralNormals = octahedralNormals;
+			pCurShader->SetUniform(UNIFORM_OCTAHEDRAL_NORMALS, octahedralNormals);
+		}
+
+		pCurShader->SetUniform(UNIFORM_INSTANCE_OFFSET, batch.firstInstance);
+
+		if(batch.pMesh != pCurMesh)
+		{
+			pCurMesh = batch.pMesh;
+			pCurMesh->Bind();
+			++m_stats.numVertexArrayBinds;
+		}
+
+		batch.pMesh->DrawInstanced(batch.numInstances);
+		++m_stats.numDrawCalls;
+	}
+}
+
+void Renderer::UpdateCameraAndLightBlocks(const glm::mat4& viewProjection) const
+{
+	CameraUniformBlock camera{};
+	camera.viewProjMatrix = viewProjection;
+	camera.eyePositionWorld = m_camera.GetPosition();
+	camera.globalAmbientLight = m_globalAmbientLight;
+
+	if(m_cameraBuffer.Update(camera))
+	{
+		++m_stats.numUniformBufferUploads;
+	}
+
+	// Value initialised so that the padding compares equal between frames
+	LightUniformBlock lights{};
+	lights.pointLightCount = m_pGraphicsEngine->GetPointLightCount();
+	lights.dirLightCount = m_pGraphicsEngine->GetDirectionalLightCount();
+	lights.lightAssignment = static_cast<GLint>(m_lightAssignment);
+
+	if(m_lightBuffer.Update(lights))
+	{
+		++m_stats.numUniformBufferUploads;
+	}
+
+	// Every light is written each frame, but only the ones that changed are sent
+	const std::vector<PointLight*>& pointLights = m_pGraphicsEngine->GetPointLights();
+	m_pointLightBuffer.Resize(pointLights.size());
+	m_lightRanges.resize(pointLights.size());
+	for(std::size_t i = 0; i < pointLights.size(); ++i)
+	{
+		PointLightUniforms uniforms{};
+		pointLights[i]->WriteUniforms(&uniforms);
+		m_pointLightBuffer.Set(i, &uniforms);
+
+		m_lightRanges[i] = BoundingSphere{ uniforms.position, uniforms.radius };
+	}
+
+	const std::vector<DirectionalLight*>& directionalLights = m_pGraphicsEngine->GetDirectionalLights();
+	m_directionalLightBuffer.Resize(directionalLights.size());
+	for(std::size_t i = 0; i < directionalLights.size(); ++i)
+	{
+		DirectionalLightUniforms uniforms{};
+		directionalLights[i]->WriteUniforms(&uniforms);
+		m_directionalLightBuffer.Set(i, &uniforms);
+	}
+
+	m_stats.numLightsUploaded = static_cast<int>(m_pointLightBuffer.Upload() + m_directionalLightBuffer.Upload());
+}
+
+void Renderer::UpdateLightClusters(const glm::mat4& view, const glm::mat4& projection) const
+{
+	ClusterUniformBlock cluster{};
+	cluster.clusterGrid = glm::uvec4(LightClusters::GRID_SIZE_X, LightClusters::GRID_SIZE_Y,
+		LightClusters::GRID_SIZE_Z, 0);
+
+	m_stats.clusterBuildMs = 0.0f;
+	m_stats.numClusterLightIndices = 0;
+
+	// The deferred path finds the pixels each light reaches itself
+	if(m_shadingPath == ShadingPath::FORWARD && m_lightAssignment == LightAssignment::CLUSTERED)
+	{
+		using Clock = std::chrono::steady_clock;
+		const Clock::time_point start = Clock::now();
+
+		m_lightClusters.Build(view, projection, Constants::NEAR_PLANE, Constants::FAR_PLANE, m_lightRanges);
+
+		m_stats.clusterBuildMs = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+		m_stats.numClusterLightIndices = static_cast<int>(m_lightClusters.GetLightIndices().size());
+
+		const std::vector<LightClusters::Cluster>& clusters = m_lightClusters.GetClusters();
+		const std::vector<std::uint32_t>& lightIndices = m_lightClusters.GetLightIndices();
+		m_clusterBuffer.Assign(clusters.data(), clusters.size());
+		m_clusterLightIndexBuffer.Assign(lightIndices.data(), lightIndices.size());
+		m_clusterBuffer.Upload();
+		m_clusterLightIndexBuffer.Upload();
+
+		cluster.clusterScale = glm::vec4(
+			static_cast<float>(LightClusters::GRID_SIZE_X) / m_pGraphicsEngine->GetWindowWidth(),
+			static_cast<float>(LightClusters::GRID_SIZE_Y) / m_pGraphicsEngine->GetWindowHeight(),
+			m_lightClusters.GetSliceScale(),
+			m_lightClusters.GetSliceBias());
+		cluster.clusterDepth = glm::vec4(Constants::NEAR_PLANE, Constants::FAR_PLANE, 0.0f, 0.0f);
+	}
 
-		pCurShader->SetUniform("modelToWorldMatrix", modelMatrix);
-		pCurShader->SetUniform("modelViewProjMatrix", projection * view * modelMatrix);
+	if(m_clusterUniformBuffer.Update(cluster))
+	{
+		++m_stats.numUniformBufferUploads;
+	}
+}
+
+void Renderer::AssignEntityLights() const
+{
+	m_entityLights.clear();
+	m_entityLightIndices.clear();
+
+	// The bounds of the visible entities are found from the culling bounds, which are in the
+	// same order but also hold the entities outside of the frustum
+	for(std::size_t i = 0; i < m_loadedEntities.size(); ++i)
+	{
+		if(!m_entityVisibility[i])
+		{
+			continue;
+		}
+
+		const AABB bounds = m_cullingBounds.GetAABB(i);
+		InstanceLights lights{ static_cast<GLuint>(m_entityLightIndices.size()), 0 };
+
+		for(std::size_t light = 0; light < m_lightRanges.size(); ++light)
+		{
+			if(BoundingVolume::Intersects(m_lightRanges[light], bounds))
+			{
+				m_entityLightIndices.push_back(static_cast<std::uint32_t>(light));
+			}
+		}
+
+		lights.count = static_cast<GLuint>(m_entityLightIndices.size()) - lights.offset;
+		m_entityLights.push_back(lights);
+	}
+
+	m_stats.numEntityLightIndices = static_cast<int>(m_entityLightIndices.size());
+
+	m_entityLightIndexBuffer.Assign(m_entityLightIndices.data(), m_entityLightIndices.size());
+	m_entityLightIndexBuffer.Upload();
+}
+
+void Renderer::UploadInstanceLights() const
+{
+	const std::vector<std::uint32_t>& instanceEntities = m_batcher.GetInstanceEntities();
+
+	m_instanceLights.resize(instanceEntities.size());
+	for(std::size_t i = 0; i < instanceEntities.size(); ++i)
+	{
+		m_instanceLights[i] = m_entityLights[instanceEntities[i]];
+	}
+
+	m_instanceLightBuffer.Assign(m_instanceLights.data(), m_instanceLights.size());
+	m_instanceLightBuffer.Upload();
+}
+
+void Renderer::UpdateShadowBlock(const tLightMatrixArray& lightMatrices) const
+{
+	ShadowUniformBlock shadows{};
 
-		entity->Render();
+	// The light matrices are in world space, each instance's model matrix is applied in the shader
+	shadows.lightMatrices = lightMatrices;
+
+	for(int i = 0, n = m_pGraphicsEngine->GetShadowedLightCount(); i < n; ++i)
+	{
+		if(const ShadowData* pShadowData = m_lights[i]->GetShadowData())
+		{
+			shadows.shadowBiases[i].x = pShadowData->GetShadowBias();
+		}
+	}
+
+	if(m_shadowBuffer.Update(shadows))
+	{
+		++m_stats.numUniformBufferUploads;
+	}
+}
+
+void Renderer::PrepareBatches(const std::vector<const Entity*>& entities, BatchGrouping grouping,
+	const glm::vec3& eyePosition) const
+{
+	m_batcher.Build(entities, grouping, eyePosition);
+
+	const std::vector<InstanceData>& instances = m_batcher.GetInstances();
+	if(!instances.empty())
+	{
+		m_instanceBuffer.Upload(instances.data(), instances.size());
+	}
+}
+
+void Renderer::RenderBatches(ShaderProgram* pShader) const
+{
+	// Batches grouped by material may share a mesh with the batch before them,
+	// so the vertex array is only bound when the mesh changes
+	const Mesh* pCurMesh = nullptr;
+
+	for(const RenderBatch& batch : m_batcher.GetBatches())
+	{
+		pShader->SetUniform(UNIFORM_INSTANCE_OFFSET, batch.firstInstance);
+
+		if(batch.pMesh != pCurMesh)
+		{
+			pCurMesh = batch.pMesh;
+			pCurMesh->Bind();
+			++m_stats.numVertexArrayBinds;
+		}
+
+		batch.pMesh->DrawInstanced(batch.numInstances);
+		++m_stats.numDrawCalls;
 	}
 }
 
@@ -223,17 +950,19 @@ void Renderer::Render() const
 {
 	const glm::mat4& viewMatrix = m_camera.GetViewMatrix();
 	const glm::mat4& projectionMatrix = m_camera.GetProjectionMatrix();
-	const glm::vec3& camPos = m_camera.GetPosition();
 
-	// Update uniforms that change every frame
-	m_defaultShader->SetUniform("eyePositionWorld", camPos);
-	m_defaultShaderTextureless->SetUniform("eyePositionWorld", camPos);
+	// Upload the uniforms shared by every phong shader, if they changed since the last frame
+	m_stats.numUniformBufferUploads = 0;
+	UpdateCameraAndLightBlocks(projectionMatrix * viewMatrix);
+	UpdateLightClusters(viewMatrix, projectionMatrix);
+
+	const Frustum cameraFrustum(projectionMatrix * viewMatrix);
+	CullEntities(cameraFrustum);
 
-	// Set light uniforms
-	for(int i = 0, n = m_pGraphicsEngine->GetLightCount(); i < n; ++i)
+	m_stats.numEntityLightIndices = 0;
+	if(m_shadingPath == ShadingPath::FORWARD && m_lightAssignment == LightAssignment::PER_ENTITY)
 	{
-		m_lights[i]->SetUniforms(m_defaultShader, i);
-		m_lights[i]->SetUniforms(m_defaultShaderTextureless, i);
+		AssignEntityLights();
 	}
 
 	if(m_wireframeModeEnabled)
@@ -243,13 +972,24 @@ void Renderer::Render() const
 		return;
 	}
 
-	// Stores each computed light matrix
-	std::array<glm::mat4, Constants::MAX_LIGHTS> lightMatrices;
-	
 	const auto& shadowMaps = m_pGraphicsEngine->GetShadowMaps();
 
+	std::array<bool, Constants::MAX_SHADOW_MAPS> shadowMapDirty;
+	FindDirtyShadowMaps(projectionMatrix * viewMatrix, &shadowMapDirty);
+
+	for(int i = 0; i < Constants::MAX_SHADOW_MAPS; ++i)
+	{
+		m_shadowMapPending[i] = m_shadowMapPending[i] || shadowMapDirty[i];
+	}
+
+	ReadShadowTimers();
+	ReadOverdrawQueries();
+
+	std::array<bool, Constants::MAX_SHADOW_MAPS> shadowMapUpdates;
+	ScheduleShadowUpdates(cameraFrustum, &shadowMapUpdates);
+
 	// Get the number of active lights 
-	const int lightCount = m_pGraphicsEngine->GetLightCount();
+	const int lightCount = m_pGraphicsEngine->GetShadowedLightCount();
 	for(int i = 0; i < lightCount; ++i)
 	{
 		ShadowData* shadowData = m_lights[i]->GetShadowData();
@@ -257,25 +997,66 @@ void Renderer::Render() const
 		// Can this light support shadows?
 		if(shadowData)
 		{
-			glm::mat4 lightMatrix = shadowData->GetLightMatrix();
 			const ShadowMap* pShadowMap = &shadowMaps[i];
 
-			// Enable for writing
-			pShadowMap->Write();
-
-			// Do the shadow pass, updating the shadow map texture
-			ShadowPass(lightMatrix);
+			if(shadowMapUpdates[i])
+			{
+				// Enable for writing
+				pShadowMap->Write();
+
+				// Only one measurement of each map can be in flight
+				const bool timed = !m_shadowTimerActive[i];
+				if(timed)
+				{
+					glBeginQuery(GL_TIME_ELAPSED, m_shadowTimerQueries[i]);
+				}
+
+				// Do the shadow pass, updating the shadow map texture
+				const PointLight* pPointLight = dynamic_cast<const PointLight*>(m_lights[i]);
+				if(pPointLight)
+				{
+					const BoundingSphere range{ pPointLight->GetPosition(), pPointLight->CalculateRadius() };
+					ShadowPass(*shadowData, cameraFrustum, &range);
+				}
+				else
+				{
+					ShadowPass(*shadowData, cameraFrustum, nullptr);
+				}
+
+				if(timed)
+				{
+					glEndQuery(GL_TIME_ELAPSED);
+					m_shadowTimerActive[i] = true;
+				}
+
+				m_shadowMapMatrices[i] = BIAS_MATRIX * shadowData->GetLightMatrix();
+				m_shadowMapPending[i] = false;
+				m_shadowMapStaleFrames[i] = 0;
+			}
+			else if(m_shadowMapPending[i])
+			{
+				++m_stats.numDelayedShadowPasses;
+				++m_shadowMapStaleFrames[i];
+			}
+			else
+			{
+				++m_stats.numSkippedShadowPasses;
+			}
 
 			// Bind the map to the correct texture slot
 			pShadowMap->Read(GL_TEXTURE0 + ShadowMap::START_TEXTURE_SLOT + i);
-
-			lightMatrix = BIAS_MATRIX * lightMatrix;
-			lightMatrices[i] = lightMatrix;
 		}
 	}
 
-	// Do the render pass
-	RenderPass(projectionMatrix, viewMatrix, lightMatrices);
+	// Do the render pass, using the light matrices the shadow maps were drawn with
+	if(m_shadingPath == ShadingPath::DEFERRED)
+	{
+		DeferredRenderPass(projectionMatrix, viewMatrix, m_shadowMapMatrices);
+	}
+	else
+	{
+		RenderPass(projectionMatrix, viewMatrix, m_shadowMapMatrices);
+	}
 
 	if(m_renderShadowMap)
 	{
@@ -298,44 +1079,31 @@ void Renderer::RenderWireframeMode(const glm::mat4& projectionMatrix, const glm:
 
 	ShaderProgram* pShader = m_pGraphicsEngine->GetShader("flat-colour");
 	pShader->Bind();
+	++m_stats.numShaderBinds;
 
 	// NOTE: Can be made a constant
 	// Set colour to white
-	pShader->SetUniform("diffuseColour", WIREFRAME_COLOUR);
-
-	const auto& entities = m_pGraphicsEngine->GetEntities();
-
-	for(const auto& entity : entities)
-	{
-		glm::mat4 modelMatrix = entity->CalculateModelMatrix();
-		pShader->SetUniform("modelViewProjMatrix", projectionMatrix * viewMatrix * modelMatrix);
+	pShader->SetUniform(UNIFORM_DIFFUSE_COLOUR, WIREFRAME_COLOUR);
+	pShader->SetUniform(UNIFORM_VIEW_PROJ_MATRIX, projectionMatrix * viewMatrix);
 
-		entity->Render();
-	}
+	PrepareBatches(m_visibleEntities, BatchGrouping::BY_MESH, m_camera.GetPosition());
+	RenderBatches(pShader);
 
 	// Draw point lights too
-	auto pointLights = m_pGraphicsEngine->GetPointLights();
-	Mesh* pLightMesh = m_pGraphicsEngine->GetMesh("sphere.obj");
-	const glm::vec3 POINT_LIGHT_MESH_SCALE{ 0.1f, 0.1f, 0.1f };
-
-	for(int i = 0, total = pointLights.size(); i < total; ++i)
-	{
-		RenderPointLight(pLightMesh, pShader, pointLights[i]->GetPosition(),
-			POINT_LIGHT_MESH_SCALE, WIREFRAME_COLOUR);
-	}
+	RenderPointLights(&WIREFRAME_COLOUR);
 }
 
 void Renderer::RenderShadowMapView(const ShadowMap& shadowMap, const ShadowData& shadowData) const
 {
 	// Draw to the default framebuffer
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	GLState::BindFramebuffer(0);
 
 	m_debugQuad.Bind();
 	bool isLightMatrixOrthographic = shadowData.IsOrthographic();
 
 	// Send uniforms to the quad debug shader
 	ShaderProgram* pShader = m_debugQuad.GetShader();
-	pShader->SetUniform("isOrtho", isLightMatrixOrthographic);
+	pShader->SetUniform(UNIFORM_IS_ORTHO, isLightMatrixOrthographic);
 
 	//std::cout << "isOrtho: " << pShader->GetUniformValue("isOrtho") << std::endl;
 
@@ -343,8 +1111,8 @@ void Renderer::RenderShadowMapView(const ShadowMap& shadowMap, const ShadowData&
 	// so we need to pass in its near and far plane values.
 	if(!isLightMatrixOrthographic)
 	{
-		pShader->SetUniform("nearZ", shadowData.GetNearPlane());
-		pShader->SetUniform("farZ", shadowData.GetFarPlane());
+		pShader->SetUniform(UNIFORM_NEAR_Z, shadowData.GetNearPlane());
+		pShader->SetUniform(UNIFORM_FAR_Z, shadowData.GetFarPlane());
 	}
 
 	// Allow the red channel to be assigned the depth values
@@ -356,42 +1124,14 @@ void Renderer::RenderShadowMapView(const ShadowMap& shadowMap, const ShadowData&
 	shadowMap.SetTextureCompareMode(GL_COMPARE_REF_TO_TEXTURE);
 }
 
-void Renderer::RenderPointLight(Mesh* pMesh, ShaderProgram* pShader,
-	const glm::vec3& position, const glm::vec3& scale, const glm::vec3& colour) const
-{
-	const auto& viewMatrix = m_camera.GetViewMatrix();
-	const auto& projMatrix = m_camera.GetProjectionMatrix();
-
-	// Create the model transformation matrix
-	glm::mat4 translation = glm::translate(glm::mat4(1.0f), position);
-	glm::mat4 model = glm::scale(translation, scale);
-
-	// Send uniforms
-	pShader->SetUniform("diffuseColour", colour);
-	pShader->SetUniform("modelViewProjMatrix", projMatrix * viewMatrix * model);
-
-	pMesh->Render();
-}
-
-// TODO: Make this more efficient
-void Renderer::RenderPointLights() const
+void Renderer::RenderPointLights(const glm::vec3* pColourOverride) const
 {
-	auto pointLights = m_pGraphicsEngine->GetPointLights();
+	m_pointLightGizmos.Update(m_pGraphicsEngine->GetPointLights());
 
-	// Render light meshes
-	ShaderProgram* pFlatColourShader = m_pGraphicsEngine->GetShader("flat-colour");
-
-	// Bind the shader
-	pFlatColourShader->Bind();
-
-	// Get the mesh that the lights use
-	Mesh* pLightMesh = m_pGraphicsEngine->GetMesh("sphere.obj");
-
-	const glm::vec3 POINT_LIGHT_MESH_SCALE{ 0.1f, 0.1f, 0.1f };
-
-	for(int i = 0, total = pointLights.size(); i < total; ++i)
+	if(m_pointLightGizmos.Render(m_camera.GetProjectionMatrix() * m_camera.GetViewMatrix(), pColourOverride))
 	{
-		RenderPointLight(pLightMesh, pFlatColourShader, pointLights[i]->GetPosition(),
-			POINT_LIGHT_MESH_SCALE, pointLights[i]->GetDiffuse());
+		++m_stats.numShaderBinds;
+		++m_stats.numVertexArrayBinds;
+		++m_stats.numDrawCalls;
 	}
-}
\ No newline at end of file
+}
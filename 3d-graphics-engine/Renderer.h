@@ -4,9 +4,19 @@
 #include "Camera.h"
 #include "Constants.h"
 #include "DebugQuad.h"
+#include "Frustum.h"
+#include "GBuffer.h"
+#include "InstanceBuffer.h"
 #include "Light.h"
+#include "LightClusters.h"
+#include "PointLightGizmos.h"
+#include "RenderBatcher.h"
+#include "StorageArray.h"
+#include "UniformBuffer.h"
 #include <glm\glm.hpp>
+#include <cstdint>
 #include <unordered_map>
+#include <vector>
 
 class Entity;
 class GraphicsEngine;
@@ -17,7 +27,102 @@ class ShadowData;
 class ShadowMap;
 class Skybox;
 
-typedef std::array<glm::mat4, Constants::MAX_LIGHTS> tLightMatrixArray;
+typedef std::array<glm::mat4, Constants::MAX_SHADOW_MAPS> tLightMatrixArray;
+
+// How the shadow maps that need to be redrawn are scheduled
+enum class ShadowUpdateMode
+{
+	// Every shadow map that needs to be redrawn is redrawn in the same frame
+	ALL,
+
+	// At most a fixed number of shadow maps are redrawn each frame
+	TIME_SLICED_BY_COUNT,
+
+	// Shadow maps are redrawn each frame until their measured GPU time reaches a budget
+	TIME_SLICED_BY_GPU_TIME
+};
+
+// How the point lights that can affect a fragment are found
+enum class LightAssignment
+{
+	// Every fragment applies every point light
+	EVERY_LIGHT,
+
+	// Each entity is given the lights whose radius reaches its bounds
+	PER_ENTITY,
+
+	// Each cluster of the camera's frustum is given the lights whose radius reaches it
+	CLUSTERED
+};
+
+// How the visible surfaces are lit
+enum class ShadingPath
+{
+	// Each entity is lit as it is drawn, by the lights the light assignment gives it
+	FORWARD,
+
+	// The entities' surfaces are drawn into a G-buffer, then each light is applied only to the
+	// pixels it covers. The light assignment is not used.
+	DEFERRED
+};
+
+// Whether the forward path draws the depth of the visible entities before shading them, so that
+// the phong shaders only run for the closest fragment of each pixel
+enum class DepthPrePassMode
+{
+	OFF,
+	ON,
+
+	// The pre-pass is used while the measured overdraw is high enough to pay for it
+	AUTOMATIC
+};
+
+// Describes the work done to render the last frame
+struct RenderStats
+{
+	// Entities with a loaded mesh that are inside or outside of the camera's frustum
+	int numVisibleEntities;
+	int numCulledEntities;
+
+	// The number of entities drawn into or skipped by the shadow maps, summed over every light
+	int numShadowCasters;
+	int numCulledShadowCasters;
+
+	// Shadow maps that were not redrawn because nothing affecting them had changed
+	int numSkippedShadowPasses;
+
+	// Shadow maps that needed redrawing but were delayed to a later frame by time slicing
+	int numDelayedShadowPasses;
+
+	// The draw calls made for entities and point lights over every pass, and the
+	// state changes made for them
+	int numDrawCalls;
+	int numShaderBinds;
+	int numTextureBinds;
+	int numVertexArrayBinds;
+
+	// The camera, light and shadow uniform blocks that changed and were uploaded
+	int numUniformBufferUploads;
+
+	// The lights whose parameters changed and were sent to the light buffers
+	int numLightsUploaded;
+
+	// The time taken to assign the point lights to clusters on the CPU, and the number of
+	// cluster light indices it produced
+	float clusterBuildMs;
+	int numClusterLightIndices;
+
+	// The number of lights given to the visible entities, summed over every entity
+	int numEntityLightIndices;
+
+	// Whether the depth pre-pass ran in the last frame
+	bool depthPrePass;
+
+	// The fragments that passed the depth test for each visible fragment, which is how many times
+	// each visible pixel is shaded without the pre-pass. Measured whenever the pre-pass runs, so
+	// this is the last measurement rather than the last frame's.
+	float overdrawRatio;
+};
 
 class Renderer
 {
@@ -31,7 +136,7 @@ class Renderer
 	const Camera& m_camera;
 
 	const glm::vec3& m_globalAmbientLight;
-	const std::array<Light*, Constants::MAX_LIGHTS>& m_lights;
+	const std::vector<Light*>& m_lights;
 
 	// A pointer to the skybox
 	Skybox* m_skybox;
@@ -40,6 +145,7 @@ class Renderer
 	GraphicsEngine* m_pGraphicsEngine;
 
 	DebugQuad m_debugQuad;
+	mutable PointLightGizmos m_pointLightGizmos;
 
 	bool m_renderPointLights;
 	bool m_renderShadowMap;
@@ -55,17 +161,103 @@ class Renderer
 	// Stores the default clear colour
 	glm::vec4 m_defaultClearColour;
 
+	// The entities with a loaded mesh and their world space bounds, and the entities that passed
+	// frustum culling this frame. The containers are kept between frames so culling does not allocate.
+	mutable std::vector<const Entity*> m_loadedEntities;
+	mutable CullingBounds m_cullingBounds;
+	mutable std::vector<const Entity*> m_visibleEntities;
+	mutable std::vector<std::uint8_t> m_entityVisibility;
+	mutable std::vector<std::uint8_t> m_shadowCasterVisibility;
+	mutable std::vector<std::uint8_t> m_sweptVisibility;
+	mutable std::vector<const Entity*> m_shadowCasters;
+
+	// Groups the entities drawn by each pass into instanced draw calls, the instances of
+	// the current pass are uploaded to the instance buffer before it draws
+	mutable RenderBatcher m_batcher;
+	InstanceBuffer m_instanceBuffer;
+
+	// The uniform blocks shared by the phong shaders. Each is uploaded at most once a frame,
+	// and only if its contents changed, rather than setting the uniforms of every shader.
+	mutable UniformBuffer m_cameraBuffer;
+	mutable UniformBuffer m_lightBuffer;
+	mutable UniformBuffer m_shadowBuffer;
+
+	// The parameters of every light, the buffers grow with the number of lights
+	mutable StorageArray m_pointLightBuffer;
+	mutable StorageArray m_directionalLightBuffer;
+
+	// The world space sphere each point light reaches, found from its attenuation every frame
+	mutable std::vector<BoundingSphere> m_lightRanges;
+
+	LightAssignment m_lightAssignment;
+	ShadingPath m_shadingPath;
+
+	// Whether the automatic mode uses the depth pre-pass, and the frames since it last ran the
+	// pre-pass to measure the overdraw
+	DepthPrePassMode m_depthPrePassMode;
+	mutable bool m_autoDepthPrePass;
+	mutable int m_framesSinceOverdrawMeasured;
+
+	// Count the samples that pass the depth test in the pre-pass and in the render pass. A new
+	// measurement is only started once the result of the previous one has been read.
+	GLuint m_prePassSamplesQuery;
+	GLuint m_renderPassSamplesQuery;
+	mutable bool m_overdrawQueryActive;
+
+	// Deferred shading. The full screen lighting pass draws without vertex buffers, but a vertex
+	// array must still be bound, and each point light is drawn as a sphere around the light.
+	mutable GBuffer m_gBuffer;
+	GLuint m_emptyVertexArrayID;
+	const Mesh* m_pLightVolumeMesh;
+
+	// Clustered shading, each fragment only applies the point lights that reach its cluster.
+	// The clusters are rebuilt every frame, since the lights are in view space.
+	mutable LightClusters m_lightClusters;
+	mutable UniformBuffer m_clusterUniformBuffer;
+	mutable StorageArray m_clusterBuffer;
+	mutable StorageArray m_clusterLightIndexBuffer;
+
+	// Per entity lights, each visible entity's range of lights in m_entityLightIndices, in the
+	// order of m_visibleEntities. Each instance of the render pass is given its entity's range.
+	mutable std::vector<InstanceLights> m_entityLights;
+	mutable std::vector<std::uint32_t> m_entityLightIndices;
+	mutable std::vector<InstanceLights> m_instanceLights;
+	mutable StorageArray m_instanceLightBuffer;
+	mutable StorageArray m_entityLightIndexBuffer;
+
+	// What each shadow map was last drawn with, a map is redrawn when any of these change.
+	// The camera matters because casters of orthographic lights are culled against it.
+	mutable std::array<const Light*, Constants::MAX_SHADOW_MAPS> m_shadowMapLights;
+	mutable glm::mat4 m_shadowCameraViewProjection;
+	mutable std::size_t m_numShadowedEntities;
+
+	ShadowUpdateMode m_shadowUpdateMode;
+	int m_maxShadowUpdatesPerFrame;
+	float m_shadowBudgetMs;
+
+	// The shadow maps that are waiting to be redrawn, and for how many frames they have waited.
+	// Until a map is redrawn it is used with the light matrix it was drawn with.
+	mutable std::array<bool, Constants::MAX_SHADOW_MAPS> m_shadowMapPending;
+	mutable std::array<int, Constants::MAX_SHADOW_MAPS> m_shadowMapStaleFrames;
+	mutable tLightMatrixArray m_shadowMapMatrices;
+
+	// Measures the GPU time of each shadow map's pass, a new measurement is only started
+	// once the result of the previous one has been read
+	std::array<GLuint, Constants::MAX_SHADOW_MAPS> m_shadowTimerQueries;
+	mutable std::array<bool, Constants::MAX_SHADOW_MAPS> m_shadowTimerActive;
+	mutable std::array<float, Constants::MAX_SHADOW_MAPS> m_shadowPassMs;
+
+	mutable RenderStats m_stats;
+
 public:
 	Renderer(GraphicsEngine* pEngine, const Camera& cam,
-		const std::array<Light*, Constants::MAX_LIGHTS>& lights,
+		const std::vector<Light*>& lights,
 		const glm::vec3& globalAmbientLight);
+	~Renderer();
 
 	//void AddToRenderList(Entity* pEntity, ShaderProgram* pShader);
 	void SetSkybox(Skybox* pSkybox) { m_skybox = pSkybox; }
 
-	// Updates the shader uniforms with the current ambient light values
-	void UpdateAmbientLight() const;
-
 	// Handles any processing that needs to be done before anything is rendered for the first time
 	void BeforeFirstRender();
 	void Render() const;
@@ -77,19 +269,99 @@ public:
 
 	void NextShadowMapView();
 
+	void SetShadowUpdateMode(ShadowUpdateMode mode) { m_shadowUpdateMode = mode; }
+	void SetMaxShadowUpdatesPerFrame(int maxUpdates) { m_maxShadowUpdatesPerFrame = maxUpdates; }
+	void SetShadowBudgetMs(float budgetMs) { m_shadowBudgetMs = budgetMs; }
+
+	ShadowUpdateMode GetShadowUpdateMode() const { return m_shadowUpdateMode; }
+	int GetMaxShadowUpdatesPerFrame()      const { return m_maxShadowUpdatesPerFrame; }
+	float GetShadowBudgetMs()              const { return m_shadowBudgetMs; }
+
+	void SetLightAssignment(LightAssignment assignment) { m_lightAssignment = assignment; }
+	LightAssignment GetLightAssignment() const { return m_lightAssignment; }
+
+	void SetShadingPath(ShadingPath path) { m_shadingPath = path; }
+	ShadingPath GetShadingPath() const { return m_shadingPath; }
+
+	void SetDepthPrePassMode(DepthPrePassMode mode) { m_depthPrePassMode = mode; }
+	DepthPrePassMode GetDepthPrePassMode() const { return m_depthPrePassMode; }
+
 	const glm::vec3& GetGlobalAmbientLight()        const { return m_globalAmbientLight; }
 	const Camera& GetCamera()                       const { return m_camera; }
 	const glm::mat4& GetProjectionMatrix()          const { return m_camera.GetProjectionMatrix(); }
 	const glm::mat4& GetViewMatrix()                const { return m_camera.GetViewMatrix(); }
+	const RenderStats& GetStats()                   const { return m_stats; }
 
 private:
-	void ShadowPass(const glm::mat4& lightMatrix) const;
+	// Fills the camera and light uniform blocks and the light buffers, uploading what changed,
+	// and finds the range of every point light
+	void UpdateCameraAndLightBlocks(const glm::mat4& viewProjection) const;
+
+	// Assigns the point lights to the camera's clusters and uploads the cluster light lists
+	void UpdateLightClusters(const glm::mat4& view, const glm::mat4& projection) const;
+
+	// Finds the point lights that reach each visible entity and uploads the light lists
+	void AssignEntityLights() const;
+
+	// Gives each instance of the current batches the lights of the entity it was made from
+	void UploadInstanceLights() const;
+
+	// Fills the shadow uniform block with the matrices the shadow maps were drawn with
+	void UpdateShadowBlock(const tLightMatrixArray& lightMatrices) const;
+
+	// Finds the entities that are inside the camera's frustum
+	void CullEntities(const Frustum& cameraFrustum) const;
+
+	// Finds the shadow maps that must be redrawn because their light, or an entity inside the
+	// light's volume, has changed since the map was drawn. Clears the dirty state it consumes.
+	void FindDirtyShadowMaps(const glm::mat4& cameraViewProjection,
+		std::array<bool, Constants::MAX_SHADOW_MAPS>* pDirty) const;
+
+	// Chooses which of the pending shadow maps are redrawn this frame
+	void ScheduleShadowUpdates(const Frustum& cameraFrustum, std::array<bool, Constants::MAX_SHADOW_MAPS>* pUpdate) const;
+
+	// Lights that influence more of the screen, and whose maps have waited longer, are redrawn first
+	float CalculateShadowPriority(int lightIndex, const Frustum& cameraFrustum) const;
+
+	// Reads the shadow pass GPU times that have become available, without waiting for any
+	void ReadShadowTimers() const;
+
+	// Draws the entities that are inside the light's volume. Entities lit by an orthographic,
+	// directional light are also skipped if their shadow cannot fall into the camera's frustum.
+	// If the light has a range, entities outside of it are skipped too, since the light cannot
+	// reach them to cast a shadow.
+	void ShadowPass(const ShadowData& shadowData, const Frustum& cameraFrustum,
+		const BoundingSphere* pLightRange) const;
 	void RenderPass(const glm::mat4& projection, const glm::mat4& view,
 		const tLightMatrixArray& lightMatrices) const;
 
-	void RenderPointLight(Mesh* pModel, ShaderProgram* pShader,
-		const glm::vec3& position, const glm::vec3& scale, const glm::vec3& colour) const;
-	void RenderPointLights() const;
+	// Whether this frame's render pass starts with a depth pre-pass
+	bool ShouldRunDepthPrePass() const;
+
+	// Reads the samples counted by the last overdraw measurement once they are available, without
+	// waiting, and lets the automatic mode decide whether the pre-pass is worthwhile
+	void ReadOverdrawQueries() const;
+
+	// Draws the depth of the current batches, with colour writes disabled
+	void DepthPrePass() const;
+
+	// Draws the visible entities into the G-buffer, then lights the screen from it with a full
+	// screen pass for the directional lights and a light volume for each point light
+	void DeferredRenderPass(const glm::mat4& projection, const glm::mat4& view,
+		const tLightMatrixArray& lightMatrices) const;
+
+	// Draws every batch with its material, using pOverrideShader rather than each batch's shader if there is one
+	void RenderMaterialBatches(ShaderProgram* pOverrideShader = nullptr) const;
+
+	// Builds the batches for the entities, sorted front to back from the eye, and uploads their instances
+	void PrepareBatches(const std::vector<const Entity*>& entities, BatchGrouping grouping,
+		const glm::vec3& eyePosition) const;
+
+	// Draws every batch with the bound shader, for passes that do not use materials
+	void RenderBatches(ShaderProgram* pShader) const;
+
+	// Draws every point light's gizmo, in the given colour rather than the lights' colours if there is one
+	void RenderPointLights(const glm::vec3* pColourOverride = nullptr) const;
 	void RenderWireframeMode(const glm::mat4& projectionMatrix, const glm::mat4& viewMatrix) const;
 	void RenderShadowMapView(const ShadowMap& shadowMap, const ShadowData& shadowData) const;
 };
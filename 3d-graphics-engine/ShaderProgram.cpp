@@ -1,52 +1,82 @@
+#include "GLState.h"
 #include "ShaderProgram.h"
 #include "ShaderUtil.h"
 #include <GL\glew.h>
 #include <glm\gtc\type_ptr.hpp>
 #include <iostream>
+#include <vector>
 
 ShaderProgram::ShaderProgram(const char* vertPath, const char* fragPath)
 {
 	m_programID = ShaderUtil::CreateShaderProgram(vertPath, fragPath);
+
+	if(m_programID != 0)
+	{
+		ReflectUniforms();
+	}
+}
+
+void ShaderProgram::ReflectUniforms()
+{
+	GLint numUniforms = 0;
+	glGetProgramInterfaceiv(m_programID, GL_UNIFORM, GL_ACTIVE_RESOURCES, &numUniforms);
+
+	GLint maxNameLength = 0;
+	glGetProgramInterfaceiv(m_programID, GL_UNIFORM, GL_MAX_NAME_LENGTH, &maxNameLength);
+
+	const GLenum PROPERTIES[] = { GL_BLOCK_INDEX, GL_LOCATION, GL_ARRAY_SIZE };
+	std::vector<GLchar> name(maxNameLength);
+	std::vector<UniformInfo> uniforms;
+	uniforms.reserve(numUniforms);
+
+	for(GLint i = 0; i < numUniforms; ++i)
+	{
+		GLint values[3];
+		glGetProgramResourceiv(m_programID, GL_UNIFORM, i, 3, PROPERTIES, 3, nullptr, values);
+
+		// Members of uniform blocks have no location, they are set through the block's buffer
+		if(values[0] != -1)
+		{
+			continue;
+		}
+
+		GLsizei nameLength = 0;
+		glGetProgramResourceName(m_programID, GL_UNIFORM, i, maxNameLength, &nameLength, name.data());
+
+		uniforms.push_back(UniformInfo{ std::string(name.data(), nameLength), values[1], values[2] });
+	}
+
+	m_uniforms.Build(uniforms);
 }
 
 void ShaderProgram::Bind() const
 {
-	glUseProgram(m_programID);
+	GLState::UseProgram(m_programID);
 }
 
 GLint ShaderProgram::GetUniformLocation(const std::string& uniformName) const
 {
-	return glGetUniformLocation(m_programID, uniformName.c_str());
+	return m_uniforms.Find(UniformHandle(uniformName));
 }
 
 void ShaderProgram::SetUniform(const std::string& name, const glm::mat4& mat4) const
 {
-	SetUniform(GetUniformLocation(name), mat4);
+	SetUniform(UniformHandle(name), mat4);
 }
 
 void ShaderProgram::SetUniform(const std::string& name, const glm::vec3& vec3) const
 {
-	GLint loc = GetUniformLocation(name);
-	//assert(loc != -1, "Uniform location value is -1");
-	
-	if(loc == -1)
-	{	
-		/*
-		std::cout << "Warning: Uniform location value for uniform '" << name
-			<< "' in program [" << m_programID << "] is -1\n";
-		*/
-	}
-	SetUniform(loc, vec3);
+	SetUniform(UniformHandle(name), vec3);
 }
 
 void ShaderProgram::SetUniform(const std::string& name, float f) const
 {
-	SetUniform(GetUniformLocation(name), f);
+	SetUniform(UniformHandle(name), f);
 }
 
 void ShaderProgram::SetUniform(const std::string& name, int i) const
 {
-	SetUniform(GetUniformLocation(name), i);
+	SetUniform(UniformHandle(name), i);
 }
 
 void ShaderProgram::SetUniform(GLint uniformLocation, const glm::mat4& mat4) const
@@ -1,6 +1,7 @@
 #ifndef SHADER_PROGRAM_H
 #define SHADER_PROGRAM_H
 
+#include "UniformTable.h"
 #include <GL\glew.h>
 #include <glm\glm.hpp>
 #include <string>
@@ -14,17 +15,25 @@ class ShaderProgram
 
 	GLuint m_programID;
 
+	// The locations of the active uniforms, reflected once the program is linked
+	UniformTable m_uniforms;
+
 	void SetUniform(GLint uniformLocation, const glm::mat4& mat4) const;
 	void SetUniform(GLint uniformLocation, const glm::vec3& vec3) const;
 	void SetUniform(GLint uniformLocation, float f) const;
 	void SetUniform(GLint uniformLocation, int i) const;
 
 	GLint GetUniformLocation(const std::string& uniformName) const;
+
+	// Fills the uniform table with every active uniform outside of a uniform block
+	void ReflectUniforms();
 public:
 	ShaderProgram(const char* vertPath, const char* fragPath);
 
 	void Bind() const;
 
+	GLuint GetProgramID() const { return m_programID; }
+
 	// Returns the uniform value, assuming the uniform is of type int
 	int GetUniformiValue(const char* uniformName)
 	{
@@ -33,6 +42,16 @@ public:
 		return result;
 	}
 
+	const UniformTable& GetUniforms() const { return m_uniforms; }
+
+	// Each of these is a table lookup and one GL call, uniforms the program does not
+	// use are ignored as they would be by glUniform
+	void SetUniform(UniformHandle handle, const glm::mat4& mat4) const { SetUniform(m_uniforms.Find(handle), mat4); }
+	void SetUniform(UniformHandle handle, const glm::vec3& vec3) const { SetUniform(m_uniforms.Find(handle), vec3); }
+	void SetUniform(UniformHandle handle, float f) const { SetUniform(m_uniforms.Find(handle), f); }
+	void SetUniform(UniformHandle handle, int i) const { SetUniform(m_uniforms.Find(handle), i); }
+
+	// Hash the name each call, prefer a constexpr UniformHandle for uniforms set every frame
 	void SetUniform(const std::string& name, const glm::mat4& mat4) const;
 	void SetUniform(const std::string& name, const glm::vec3& vec3) const;
 	void SetUniform(const std::string& name, float f) const;
@@ -1,3 +1,4 @@
+#include "GLState.h"
 #include "ShadowMap.h"
 #include <GL\glew.h>
 
@@ -18,7 +19,7 @@ ShadowMap::~ShadowMap()
 	}
 
 	// Delete the framebuffer
-	glDeleteFramebuffers(1, &m_shadowFrameBufferID);
+	GLState::DeleteFramebuffers(1, &m_shadowFrameBufferID);
 }
 
 void ShadowMap::Init()
@@ -50,7 +51,7 @@ void ShadowMap::Init()
 
 	// Create the framebuffer and bind
 	glGenFramebuffers(1, &m_shadowFrameBufferID);
-	glBindFramebuffer(GL_FRAMEBUFFER, m_shadowFrameBufferID);
+	GLState::BindFramebuffer(m_shadowFrameBufferID);
 
 	// Disable drawing to the colour buffer
 	glDrawBuffer(GL_NONE);
@@ -60,19 +61,19 @@ void ShadowMap::Init()
 	glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_texture->GetTextureID(), 0);
 
 	// Bind back to the default framebuffer
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	GLState::BindFramebuffer(0);
 }
 
 void ShadowMap::Write() const
 {
 	// Resize the viewport, since the shadow map may be larger or smaller than the window
-	glViewport(0, 0, m_width, m_height);
-	glBindFramebuffer(GL_FRAMEBUFFER, m_shadowFrameBufferID);
+	GLState::Viewport(0, 0, m_width, m_height);
+	GLState::BindFramebuffer(m_shadowFrameBufferID);
 }
 
 void ShadowMap::Read(GLenum texture) const
 {
-	glActiveTexture(texture);
+	GLState::ActiveTexture(texture);
 	m_texture->Bind();
 }
 
@@ -1,9 +1,16 @@
 #include "Skybox.h"
+#include "GLState.h"
 #include "Mesh.h"
 #include "MeshCreator.h"
 #include "Texture.h"
 #include "ShaderProgram.h"
 
+namespace
+{
+	constexpr UniformHandle UNIFORM_PROJECTION("projection");
+	constexpr UniformHandle UNIFORM_VIEW("view");
+}
+
 Skybox::Skybox(const std::string& cubemapDir, const Mesh& cube, ShaderProgram& shader)
 	: m_mesh(cube)
 	, m_shaderProgram(shader)
@@ -15,23 +22,23 @@ void Skybox::PreRender(const glm::mat4& projectionMatrix, const glm::mat4& viewM
 {
 	m_shaderProgram.Bind();
 
-	m_shaderProgram.SetUniform("projection", projectionMatrix);
-	m_shaderProgram.SetUniform("view", viewMatrix);
+	m_shaderProgram.SetUniform(UNIFORM_PROJECTION, projectionMatrix);
+	m_shaderProgram.SetUniform(UNIFORM_VIEW, viewMatrix);
 }
 
 void Skybox::Render() const
 {
 	// Since we want to see the inside faces of the cube change the winding order
 	// temporarily when drawing the skybox
-	glFrontFace(GL_CW);
+	GLState::FrontFace(GL_CW);
 
 	// Disable writing to the depth buffer since we want the skybox to appear
 	// behind everything else
-	glDepthMask(GL_FALSE);
+	GLState::DepthMask(false);
 
 	m_mesh.Render();
 
 	// Revert changes in order to draw everything else
-	glFrontFace(GL_CCW);
-	glDepthMask(GL_TRUE);
+	GLState::FrontFace(GL_CCW);
+	GLState::DepthMask(true);
 }
\ No newline at end of file
@@ -0,0 +1,125 @@
+#include "GLState.h"
+#include "StorageArray.h"
+#include <GL\glew.h>
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+
+namespace
+{
+	// The buffer always has room for some elements, so that it can be bound before any are added
+	constexpr std::size_t MIN_CAPACITY = 16;
+}
+
+StorageArray::StorageArray(std::size_t elementSize, GLuint bindingPoint)
+	: m_bufferID{ 0 }
+	, m_bindingPoint{ bindingPoint }
+	, m_elementSize{ elementSize }
+	, m_capacity{ MIN_CAPACITY }
+	, m_anyDirty{ false }
+{
+	glGenBuffers(1, &m_bufferID);
+
+	GLState::BindBuffer(GL_SHADER_STORAGE_BUFFER, m_bufferID);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, m_capacity * m_elementSize, nullptr, GL_DYNAMIC_DRAW);
+
+	// Growing the buffer keeps its name, so the binding stays in place
+	GLState::BindBufferBase(GL_SHADER_STORAGE_BUFFER, m_bindingPoint, m_bufferID);
+}
+
+StorageArray::~StorageArray()
+{
+	GLState::DeleteBuffers(1, &m_bufferID);
+}
+
+void StorageArray::Resize(std::size_t numElements)
+{
+	const std::size_t oldSize = GetSize();
+
+	m_contents.resize(numElements * m_elementSize, 0);
+	m_dirty.resize(numElements, true);
+	m_anyDirty = m_anyDirty || numElements > oldSize;
+}
+
+void StorageArray::Set(std::size_t index, const void* pElement)
+{
+	assert(index < GetSize() && "The element is outside of the array");
+
+	unsigned char* pDest = &m_contents[index * m_elementSize];
+	if(std::memcmp(pDest, pElement, m_elementSize) == 0)
+	{
+		return;
+	}
+
+	std::memcpy(pDest, pElement, m_elementSize);
+	m_dirty[index] = true;
+	m_anyDirty = true;
+}
+
+void StorageArray::Assign(const void* pElements, std::size_t numElements)
+{
+	const std::size_t numBytes = numElements * m_elementSize;
+	if(numElements == GetSize() && (numBytes == 0 || std::memcmp(m_contents.data(), pElements, numBytes) == 0))
+	{
+		return;
+	}
+
+	m_contents.resize(numBytes);
+	if(numBytes > 0)
+	{
+		std::memcpy(m_contents.data(), pElements, numBytes);
+	}
+
+	m_dirty.assign(numElements, true);
+	m_anyDirty = true;
+}
+
+std::size_t StorageArray::Upload()
+{
+	if(!m_anyDirty)
+	{
+		return 0;
+	}
+
+	m_anyDirty = false;
+	GLState::BindBuffer(GL_SHADER_STORAGE_BUFFER, m_bufferID);
+
+	const std::size_t size = GetSize();
+	if(size > m_capacity)
+	{
+		// Doubling keeps the number of reallocations low as lights are added one at a time,
+		// the new storage is filled with every element at once
+		m_capacity = std::max(size, m_capacity * 2);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, m_capacity * m_elementSize, nullptr, GL_DYNAMIC_DRAW);
+		glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, size * m_elementSize, m_contents.data());
+
+		std::fill(m_dirty.begin(), m_dirty.end(), false);
+		return size;
+	}
+
+	std::size_t numUploaded = 0;
+	for(std::size_t first = 0; first < size; )
+	{
+		if(!m_dirty[first])
+		{
+			++first;
+			continue;
+		}
+
+		std::size_t last = first;
+		while(last < size && m_dirty[last])
+		{
+			m_dirty[last] = false;
+			++last;
+		}
+
+		glBufferSubData(GL_SHADER_STORAGE_BUFFER, first * m_elementSize, (last - first) * m_elementSize,
+			&m_contents[first * m_elementSize]);
+
+		numUploaded += last - first;
+		first = last;
+	}
+
+	return numUploaded;
+}
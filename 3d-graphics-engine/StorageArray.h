@@ -0,0 +1,50 @@
+#ifndef STORAGE_ARRAY_H
+#define STORAGE_ARRAY_H
+
+#include <GL\glew.h>
+#include <cstddef>
+#include <vector>
+
+// A shader storage buffer holding an array that shaders read as an unsized std430 array. The
+// buffer grows with the number of elements, and only the elements that changed since the last
+// upload are sent to it.
+class StorageArray
+{
+	GLuint m_bufferID;
+	GLuint m_bindingPoint;
+	std::size_t m_elementSize;
+
+	// The number of elements the buffer has room for
+	std::size_t m_capacity;
+
+	// The elements as they will be after the next upload
+	std::vector<unsigned char> m_contents;
+	std::vector<bool> m_dirty;
+	bool m_anyDirty;
+
+public:
+	StorageArray(std::size_t elementSize, GLuint bindingPoint);
+	~StorageArray();
+
+	StorageArray(const StorageArray&) = delete;
+	StorageArray& operator=(const StorageArray&) = delete;
+
+	// Sets the number of elements. New elements are zeroed and uploaded with the next Upload.
+	void Resize(std::size_t numElements);
+
+	// Copies the element in, it is only uploaded if it differs from what the buffer holds
+	void Set(std::size_t index, const void* pElement);
+
+	// Replaces every element, for contents that are rebuilt as a whole each frame. If anything
+	// differs the whole array is sent with one glBufferSubData, rather than one per changed run.
+	void Assign(const void* pElements, std::size_t numElements);
+
+	// Sends every changed element, each run of consecutive changed elements with one
+	// glBufferSubData. Returns the number of elements that were sent.
+	std::size_t Upload();
+
+	std::size_t GetSize()     const { return m_dirty.size(); }
+	std::size_t GetCapacity() const { return m_capacity; }
+};
+
+#endif
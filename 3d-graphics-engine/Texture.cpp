@@ -1,5 +1,6 @@
 #include "Texture.h"
 #include "Constants.h"
+#include "GLState.h"
 #include <SOIL2\SOIL2.h>
 #include <algorithm>
 #include <iostream>
@@ -16,8 +17,8 @@ GLuint LoadTexture(const std::string& filepath, GLfloat filter)
 		std::cerr << "Failed to load texture '" << filepath << "' from file\n";
 	}
 
-	// Bind texture to set parameters
-	glBindTexture(GL_TEXTURE_2D, textureID);
+	// Bind texture to set parameters. SOIL binds it too, which this also records in the state cache.
+	GLState::BindTexture(GL_TEXTURE_2D, textureID);
 
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
@@ -88,6 +89,9 @@ GLuint LoadCubemap(const std::string& cubemapDir)
 		std::cerr << "Failed to load cubemap at directory '" << fullDirPath << "' from file!\n";
 	}
 
+	// SOIL leaves the cubemap bound without going through the state cache
+	GLState::BindTexture(GL_TEXTURE_CUBE_MAP, textureID);
+
 	return textureID;
 }
 
@@ -98,17 +102,17 @@ Texture::Texture()
 
 void Texture::Bind()
 {
-	glBindTexture(GL_TEXTURE_2D, m_textureID);
+	GLState::BindTexture(GL_TEXTURE_2D, m_textureID);
 }
 
 void Texture::Unbind()
 {
-	glBindTexture(GL_TEXTURE_2D, 0);
+	GLState::BindTexture(GL_TEXTURE_2D, 0);
 }
 
 void Texture::SetCompareMode(GLint compareMode)
 {
-	glBindTexture(GL_TEXTURE_2D, m_textureID);
+	GLState::BindTexture(GL_TEXTURE_2D, m_textureID);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, compareMode);
-	glBindTexture(GL_TEXTURE_2D, 0);
+	GLState::BindTexture(GL_TEXTURE_2D, 0);
 }
\ No newline at end of file
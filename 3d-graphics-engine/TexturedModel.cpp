@@ -1,3 +1,4 @@
+#include "GLState.h"
 #include "Mesh.h"
 #include "Texture.h"
 #include "TexturedModel.h"
@@ -14,8 +15,8 @@ TexturedModel::TexturedModel(Mesh* pMesh, Texture* pTexture)
 void TexturedModel::Render()
 {
 	// Assign a texture unit first before binding
-	glActiveTexture(GL_TEXTURE0);
+	GLState::ActiveTexture(GL_TEXTURE0);
 
-	glBindTexture(GL_TEXTURE_2D, m_pTexture->GetTextureID());
+	GLState::BindTexture(GL_TEXTURE_2D, m_pTexture->GetTextureID());
 	m_pMesh->Render(GL_TRIANGLES);
 }
\ No newline at end of file
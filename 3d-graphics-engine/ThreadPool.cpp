@@ -0,0 +1,101 @@
+#include "ThreadPool.h"
+#include <cassert>
+
+ThreadPool::ThreadPool()
+	: m_pFunc(nullptr)
+	, m_count(0)
+	, m_nextIndex(0)
+	, m_numRemaining(0)
+	, m_generation(0)
+	, m_stopWorkers(false)
+{
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopWorkers = true;
+	}
+	m_workCondition.notify_all();
+
+	for(std::thread& worker : m_workers)
+	{
+		worker.join();
+	}
+}
+
+void ThreadPool::Run(int count, const std::function<void(int)>& func)
+{
+	if(count <= 0)
+	{
+		return;
+	}
+
+	// The calling thread takes part, so one index needs no worker
+	if(count > GetNumWorkers() + 1)
+	{
+		StartWorkers(count - 1 - GetNumWorkers());
+	}
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	assert(m_numRemaining == 0 && "ThreadPool::Run() was called from more than one thread");
+
+	m_pFunc = &func;
+	m_count = count;
+	m_nextIndex = 0;
+	m_numRemaining = count;
+	++m_generation;
+
+	m_workCondition.notify_all();
+
+	RunIndices(lock);
+
+	m_doneCondition.wait(lock, [this] { return m_numRemaining == 0; });
+	m_pFunc = nullptr;
+}
+
+void ThreadPool::StartWorkers(int numWorkers)
+{
+	for(int i = 0; i < numWorkers; ++i)
+	{
+		m_workers.emplace_back(&ThreadPool::WorkerMain, this);
+	}
+}
+
+void ThreadPool::WorkerMain()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	std::uint64_t lastGeneration = m_generation;
+
+	while(true)
+	{
+		m_workCondition.wait(lock, [this, lastGeneration] { return m_stopWorkers || m_generation != lastGeneration; });
+
+		if(m_stopWorkers)
+		{
+			return;
+		}
+
+		lastGeneration = m_generation;
+		RunIndices(lock);
+	}
+}
+
+void ThreadPool::RunIndices(std::unique_lock<std::mutex>& lock)
+{
+	while(m_nextIndex < m_count)
+	{
+		const std::function<void(int)>& func = *m_pFunc;
+		const int index = m_nextIndex++;
+
+		lock.unlock();
+		func(index);
+		lock.lock();
+
+		if(--m_numRemaining == 0)
+		{
+			m_doneCondition.notify_one();
+		}
+	}
+}
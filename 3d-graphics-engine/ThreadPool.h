@@ -0,0 +1,54 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Runs work that is repeated every frame on threads that are kept alive between calls, so that
+// only the work itself is paid for each frame. Work that is only done once, such as loading,
+// can use ParallelFor instead. Run() must not be called from more than one thread at a time.
+class ThreadPool
+{
+private:
+	std::vector<std::thread> m_workers;
+
+	std::mutex m_mutex;
+	std::condition_variable m_workCondition;
+	std::condition_variable m_doneCondition;
+
+	// The work of the current call to Run(), indices are handed out one at a time
+	const std::function<void(int)>* m_pFunc;
+	int m_count;
+	int m_nextIndex;
+	int m_numRemaining;
+
+	// Incremented for every call to Run(), so that waiting workers can tell there is new work
+	std::uint64_t m_generation;
+	bool m_stopWorkers;
+
+	void StartWorkers(int numWorkers);
+	void WorkerMain();
+
+	// Calls the function for indices that have not been handed out yet, until there are none left
+	void RunIndices(std::unique_lock<std::mutex>& lock);
+
+public:
+	ThreadPool();
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	// Calls func(i) for every i in [0, count), spread over the workers and the calling thread,
+	// and returns once every call has returned. Workers are only started the first time
+	// a call needs them.
+	void Run(int count, const std::function<void(int)>& func);
+
+	int GetNumWorkers() const { return static_cast<int>(m_workers.size()); }
+};
+
+#endif
@@ -4,6 +4,7 @@
 
 #include "UIController.h"
 #include "GraphicsEngine.h"
+#include "GLState.h"
 #include "Entity.h"
 #include "Light.h"
 #include "PointLight.h"
@@ -119,6 +120,85 @@ void UIController::DrawUI(GraphicsEngine* pEngine) const
 		// Display average frame time and framerate
 		ImGui::Text("Application average %.3f ms/frame (%.1f FPS)",
 			1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+
+		ImGui::Text("Meshes loading: %d", pEngine->GetMeshLoadsInFlight());
+
+		const RenderStats& stats = pEngine->GetRenderStats();
+		ImGui::Text("Entities visible: %d, culled: %d", stats.numVisibleEntities, stats.numCulledEntities);
+		ImGui::Text("Shadow casters drawn: %d, culled: %d", stats.numShadowCasters, stats.numCulledShadowCasters);
+		ImGui::Text("Shadow passes skipped: %d, delayed: %d", stats.numSkippedShadowPasses,
+			stats.numDelayedShadowPasses);
+		ImGui::Text("Draw calls: %d", stats.numDrawCalls);
+		ImGui::Text("Binds: %d shader, %d texture, %d vertex array", stats.numShaderBinds,
+			stats.numTextureBinds, stats.numVertexArrayBinds);
+		ImGui::Text("Uniform buffer uploads: %d, lights uploaded: %d", stats.numUniformBufferUploads,
+			stats.numLightsUploaded);
+
+		const GLState::Stats& glStats = GLState::GetStats();
+		ImGui::Text("GL state calls: %d sent, %d elided", glStats.numCalls, glStats.numElidedCalls);
+
+		// Shadow update scheduling
+		ImGui::Separator();
+		Renderer& renderer = pEngine->GetRenderer();
+
+		const char* shadowUpdateModes[] = { "All", "Time sliced by count", "Time sliced by GPU time" };
+		int shadowUpdateMode = static_cast<int>(renderer.GetShadowUpdateMode());
+		if(ImGui::Combo("Shadow updates", &shadowUpdateMode, shadowUpdateModes, IM_ARRAYSIZE(shadowUpdateModes)))
+		{
+			renderer.SetShadowUpdateMode(static_cast<ShadowUpdateMode>(shadowUpdateMode));
+		}
+
+		if(renderer.GetShadowUpdateMode() == ShadowUpdateMode::TIME_SLICED_BY_COUNT)
+		{
+			int maxUpdates = renderer.GetMaxShadowUpdatesPerFrame();
+			ImGui::SliderInt("Maps per frame", &maxUpdates, 1, Constants::MAX_SHADOW_MAPS);
+			renderer.SetMaxShadowUpdatesPerFrame(maxUpdates);
+		}
+		else if(renderer.GetShadowUpdateMode() == ShadowUpdateMode::TIME_SLICED_BY_GPU_TIME)
+		{
+			float budgetMs = renderer.GetShadowBudgetMs();
+			ImGui::SliderFloat("Budget (ms)", &budgetMs, 0.1f, 8.0f);
+			renderer.SetShadowBudgetMs(budgetMs);
+		}
+
+		// Shading path, and the point light assignment of the forward path
+		ImGui::Separator();
+		const char* shadingPaths[] = { "Forward", "Deferred" };
+		int shadingPath = static_cast<int>(renderer.GetShadingPath());
+		if(ImGui::Combo("Shading", &shadingPath, shadingPaths, IM_ARRAYSIZE(shadingPaths)))
+		{
+			renderer.SetShadingPath(static_cast<ShadingPath>(shadingPath));
+		}
+
+		if(renderer.GetShadingPath() == ShadingPath::FORWARD)
+		{
+			const char* lightAssignments[] = { "Every light", "Per entity", "Clustered" };
+			int lightAssignment = static_cast<int>(renderer.GetLightAssignment());
+			if(ImGui::Combo("Point lights", &lightAssignment, lightAssignments, IM_ARRAYSIZE(lightAssignments)))
+			{
+				renderer.SetLightAssignment(static_cast<LightAssignment>(lightAssignment));
+			}
+
+			if(renderer.GetLightAssignment() == LightAssignment::CLUSTERED)
+			{
+				ImGui::Text("Cluster build: %.3f ms, %d light indices", stats.clusterBuildMs,
+					stats.numClusterLightIndices);
+			}
+			else if(renderer.GetLightAssignment() == LightAssignment::PER_ENTITY)
+			{
+				ImGui::Text("Entity lights: %d over %d entities", stats.numEntityLightIndices,
+					stats.numVisibleEntities);
+			}
+
+			const char* depthPrePassModes[] = { "Off", "On", "Automatic" };
+			int depthPrePassMode = static_cast<int>(renderer.GetDepthPrePassMode());
+			if(ImGui::Combo("Depth pre-pass", &depthPrePassMode, depthPrePassModes, IM_ARRAYSIZE(depthPrePassModes)))
+			{
+				renderer.SetDepthPrePassMode(static_cast<DepthPrePassMode>(depthPrePassMode));
+			}
+
+			ImGui::Text("Overdraw: %.2fx, pre-pass %s", stats.overdrawRatio, stats.depthPrePass ? "on" : "off");
+		}
 	}
 	ImGui::End();
 
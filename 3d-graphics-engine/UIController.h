@@ -71,7 +71,7 @@ public:
 class UIController
 {
 	const std::vector<Entity*>* m_pEntities;
-	const std::array<Light*, Constants::MAX_LIGHTS>* m_pLights;
+	const std::vector<Light*>* m_pLights;
 	const SystemData& m_systemData;
 
 	// Stores names of all entities and lights, allowing duplicates
@@ -0,0 +1,121 @@
+#ifndef UNIFORM_BLOCKS_H
+#define UNIFORM_BLOCKS_H
+
+#include "Constants.h"
+#include <GL\glew.h>
+#include <glm\glm.hpp>
+#include <array>
+#include <cstddef>
+
+// The data of the std140 uniform blocks and std430 light buffers that the phong shaders share.
+// Each struct is laid out to match its block in the shaders, both layouts align a vec3 to 16
+// bytes, so padding members are added where GLSL would leave a gap.
+
+// The binding points of the blocks, these match the bindings in the shaders
+namespace UniformBlocks
+{
+	inline constexpr GLuint CAMERA_BINDING = 0;
+	inline constexpr GLuint LIGHT_BINDING  = 1;
+	inline constexpr GLuint SHADOW_BINDING = 2;
+	inline constexpr GLuint CLUSTER_BINDING = 3;
+
+	// Shader storage buffer binding points, these are separate from the uniform block bindings
+	inline constexpr GLuint POINT_LIGHT_BUFFER_BINDING = 2;
+	inline constexpr GLuint DIRECTIONAL_LIGHT_BUFFER_BINDING = 3;
+	inline constexpr GLuint CLUSTER_BUFFER_BINDING = 4;
+	inline constexpr GLuint CLUSTER_LIGHT_INDEX_BUFFER_BINDING = 5;
+	inline constexpr GLuint INSTANCE_LIGHT_BUFFER_BINDING = 6;
+	inline constexpr GLuint ENTITY_LIGHT_INDEX_BUFFER_BINDING = 7;
+}
+
+// The CameraBlock, which changes whenever the camera moves
+struct CameraUniformBlock
+{
+	glm::mat4 viewProjMatrix;
+	glm::vec3 eyePositionWorld;
+	float padding0;
+	glm::vec3 globalAmbientLight;
+	float padding1;
+};
+
+// The Light struct in the shaders
+struct LightUniforms
+{
+	glm::vec3 ambient;
+	float padding0;
+	glm::vec3 diffuse;
+	float padding1;
+	glm::vec3 specular;
+
+	// The index of the light's shadow map in the shadow map array, -1 if it has none
+	GLint shadowIndex;
+};
+
+// An element of the point light buffer
+struct PointLightUniforms
+{
+	LightUniforms light;
+	glm::vec3 position;
+
+	// The distance beyond which the light has no visible effect
+	float radius;
+
+	// The attenuation terms are read as a vec3
+	float quadratic;
+	float linear;
+	float constant;
+	float padding1;
+};
+
+// An element of the directional light buffer
+struct DirectionalLightUniforms
+{
+	LightUniforms light;
+	glm::vec3 direction;
+	float padding0;
+};
+
+// The LightBlock, which changes whenever a light is added. The buffers may have room for
+// more lights than there are, so the shaders read the counts from here.
+struct LightUniformBlock
+{
+	GLint pointLightCount;
+	GLint dirLightCount;
+
+	// Which point lights each fragment applies, a LightAssignment value
+	GLint lightAssignment;
+	float padding;
+};
+
+// The ShadowBlock, which changes whenever a shadow map is redrawn
+struct ShadowUniformBlock
+{
+	// Transforms world space positions to each light's shadow map
+	std::array<glm::mat4, Constants::MAX_SHADOW_MAPS> lightMatrices;
+
+	// Only x is used, since std140 pads every element of a float array to 16 bytes
+	std::array<glm::vec4, Constants::MAX_SHADOW_MAPS> shadowBiases;
+};
+
+// The ClusterBlock, which changes when the window is resized
+struct ClusterUniformBlock
+{
+	// The number of clusters along each axis, w is unused
+	glm::uvec4 clusterGrid;
+
+	// Pixels to tiles in xy, and the slice scale and bias in zw
+	glm::vec4 clusterScale;
+
+	// The near and far planes in xy
+	glm::vec4 clusterDepth;
+};
+
+static_assert(sizeof(CameraUniformBlock) == 96, "CameraUniformBlock does not match std140");
+static_assert(sizeof(LightUniforms) == 48, "LightUniforms does not match std430");
+static_assert(sizeof(PointLightUniforms) == 80, "PointLightUniforms does not match std430");
+static_assert(sizeof(DirectionalLightUniforms) == 64, "DirectionalLightUniforms does not match std430");
+static_assert(sizeof(LightUniformBlock) == 16, "LightUniformBlock does not match std140");
+static_assert(sizeof(ClusterUniformBlock) == 48, "ClusterUniformBlock does not match std140");
+static_assert(offsetof(ShadowUniformBlock, shadowBiases) == 256, "ShadowUniformBlock does not match std140");
+
+#endif
@@ -0,0 +1,41 @@
+#include "GLState.h"
+#include "UniformBuffer.h"
+#include <GL\glew.h>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+
+UniformBuffer::UniformBuffer(std::size_t size, GLuint bindingPoint)
+	: m_bufferID{ 0 }
+	, m_bindingPoint{ bindingPoint }
+	, m_contents(size)
+{
+	glGenBuffers(1, &m_bufferID);
+
+	GLState::BindBuffer(GL_UNIFORM_BUFFER, m_bufferID);
+	glBufferData(GL_UNIFORM_BUFFER, size, m_contents.data(), GL_DYNAMIC_DRAW);
+
+	// The binding stays in place, so shaders can read the block without it being bound again
+	GLState::BindBufferBase(GL_UNIFORM_BUFFER, m_bindingPoint, m_bufferID);
+}
+
+UniformBuffer::~UniformBuffer()
+{
+	GLState::DeleteBuffers(1, &m_bufferID);
+}
+
+bool UniformBuffer::Update(const void* pData, std::size_t size)
+{
+	assert(size == m_contents.size() && "The block does not match the size of the buffer");
+
+	if(std::memcmp(m_contents.data(), pData, size) == 0)
+	{
+		return false;
+	}
+
+	std::memcpy(m_contents.data(), pData, size);
+
+	GLState::BindBuffer(GL_UNIFORM_BUFFER, m_bufferID);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, size, pData);
+	return true;
+}
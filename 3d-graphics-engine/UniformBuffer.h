@@ -0,0 +1,33 @@
+#ifndef UNIFORM_BUFFER_H
+#define UNIFORM_BUFFER_H
+
+#include <GL\glew.h>
+#include <cstddef>
+#include <vector>
+
+// A uniform buffer bound to a fixed binding point, holding one std140 block that is shared by
+// every shader declaring the block with that binding
+class UniformBuffer
+{
+	GLuint m_bufferID;
+	GLuint m_bindingPoint;
+
+	// The contents of the buffer, so that updates that change nothing are never uploaded
+	std::vector<unsigned char> m_contents;
+
+public:
+	UniformBuffer(std::size_t size, GLuint bindingPoint);
+	~UniformBuffer();
+
+	UniformBuffer(const UniformBuffer&) = delete;
+	UniformBuffer& operator=(const UniformBuffer&) = delete;
+
+	// Replaces the contents with a single glBufferSubData, if they have changed.
+	// The size must be the one the buffer was created with. Returns true if the data was uploaded.
+	bool Update(const void* pData, std::size_t size);
+
+	template <typename T>
+	bool Update(const T& block) { return Update(&block, sizeof(T)); }
+};
+
+#endif
@@ -0,0 +1,114 @@
+#include "UniformTable.h"
+#include <GL\glew.h>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	// The table stops growing at this size and relies on probing for any remaining collisions
+	constexpr std::size_t MAX_SLOTS = 4096;
+
+	// Returns the hash and location of every name a uniform can be found by
+	void ExpandNames(const std::vector<UniformInfo>& uniforms, std::vector<std::pair<std::uint32_t, GLint>>* pEntries)
+	{
+		for(const UniformInfo& uniform : uniforms)
+		{
+			// GL names an array after its first element. Members of arrays of structs, such as
+			// "lights[1].colour", are reported separately and are not arrays themselves.
+			const std::size_t subscript = uniform.name.rfind('[');
+			const bool isArray = subscript != std::string::npos && uniform.name.compare(subscript, std::string::npos, "[0]") == 0;
+			if(!isArray)
+			{
+				pEntries->emplace_back(UniformHandle::Hash(uniform.name), uniform.location);
+				continue;
+			}
+
+			// The name without the subscript also finds the first element, the other elements follow it
+			const std::string baseName = uniform.name.substr(0, subscript);
+			pEntries->emplace_back(UniformHandle::Hash(baseName), uniform.location);
+
+			for(GLint i = 0; i < uniform.arraySize; ++i)
+			{
+				const std::string elementName = baseName + "[" + std::to_string(i) + "]";
+				pEntries->emplace_back(UniformHandle::Hash(elementName), uniform.location + i);
+			}
+		}
+	}
+
+	bool HasCollisions(const std::vector<std::pair<std::uint32_t, GLint>>& entries, std::size_t numSlots)
+	{
+		std::vector<bool> used(numSlots, false);
+		for(const auto& [hash, location] : entries)
+		{
+			const std::size_t slot = hash & (numSlots - 1);
+			if(used[slot])
+			{
+				return true;
+			}
+
+			used[slot] = true;
+		}
+
+		return false;
+	}
+}
+
+UniformTable::UniformTable()
+	: m_mask{ 0 }
+	, m_numUniforms{ 0 }
+{
+}
+
+void UniformTable::Build(const std::vector<UniformInfo>& uniforms)
+{
+	std::vector<std::pair<std::uint32_t, GLint>> entries;
+	ExpandNames(uniforms, &entries);
+
+	m_slots.clear();
+	m_mask = 0;
+	m_numUniforms = entries.size();
+
+	if(entries.empty())
+	{
+		return;
+	}
+
+	// At least twice the number of entries, so that probing ends quickly
+	std::size_t numSlots = 1;
+	while(numSlots < entries.size() * 2)
+	{
+		numSlots *= 2;
+	}
+
+	while(numSlots < MAX_SLOTS && HasCollisions(entries, numSlots))
+	{
+		numSlots *= 2;
+	}
+
+	m_slots.assign(numSlots, Slot{ 0, -1 });
+	m_mask = static_cast<std::uint32_t>(numSlots - 1);
+
+	for(const auto& [hash, location] : entries)
+	{
+		Insert(hash, location);
+	}
+}
+
+void UniformTable::Insert(std::uint32_t hash, GLint location)
+{
+	for(std::uint32_t i = hash & m_mask; ; i = (i + 1) & m_mask)
+	{
+		Slot& slot = m_slots[i];
+		if(slot.location == -1)
+		{
+			slot = Slot{ hash, location };
+			return;
+		}
+
+		assert(slot.hash != hash && "Two uniform names have the same hash");
+	}
+}
@@ -0,0 +1,99 @@
+#ifndef UNIFORM_TABLE_H
+#define UNIFORM_TABLE_H
+
+#include <GL\glew.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Identifies a uniform by a hash of its name. A handle declared constexpr is hashed at
+// compile time, so setting a uniform through it involves no string operations.
+class UniformHandle
+{
+	std::uint32_t m_hash;
+
+public:
+	constexpr explicit UniformHandle(std::string_view name)
+		: m_hash{ Hash(name) }
+	{
+	}
+
+	constexpr std::uint32_t GetHash() const { return m_hash; }
+
+	// 32-bit FNV-1a
+	static constexpr std::uint32_t Hash(std::string_view name)
+	{
+		std::uint32_t hash = 2166136261u;
+		for(char c : name)
+		{
+			hash = (hash ^ static_cast<std::uint8_t>(c)) * 16777619u;
+		}
+
+		return hash;
+	}
+};
+
+// An active uniform of a program, as reflected after linking
+struct UniformInfo
+{
+	std::string name;
+	GLint location;
+
+	// The number of elements if the uniform is an array, otherwise 1
+	GLint arraySize;
+};
+
+// Maps the handles of a program's uniforms to their locations. The table is grown until
+// no two uniforms share a slot, so a lookup is usually a single array index.
+class UniformTable
+{
+	struct Slot
+	{
+		std::uint32_t hash;
+
+		// -1 if the slot is empty
+		GLint location;
+	};
+
+	std::vector<Slot> m_slots;
+	std::uint32_t m_mask;
+	std::size_t m_numUniforms;
+
+	void Insert(std::uint32_t hash, GLint location);
+
+public:
+	UniformTable();
+
+	// Replaces the contents of the table. Arrays can be found both by their name and by the
+	// name of each element, e.g. "lights" and "lights[2]", as glGetUniformLocation allows.
+	void Build(const std::vector<UniformInfo>& uniforms);
+
+	// Returns -1 if the program has no active uniform with the handle's name
+	GLint Find(UniformHandle handle) const
+	{
+		if(m_slots.empty())
+		{
+			return -1;
+		}
+
+		// The table is never more than half full, so the probe always reaches an empty slot
+		for(std::uint32_t i = handle.GetHash() & m_mask; ; i = (i + 1) & m_mask)
+		{
+			const Slot& slot = m_slots[i];
+			if(slot.location == -1 || slot.hash == handle.GetHash())
+			{
+				return slot.location;
+			}
+		}
+	}
+
+	// The number of names that can be found, including each element of an array
+	std::size_t GetNumUniforms() const { return m_numUniforms; }
+
+	// The number of slots, which is a power of two
+	std::size_t GetNumSlots() const { return m_slots.size(); }
+};
+
+#endif
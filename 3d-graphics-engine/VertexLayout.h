@@ -0,0 +1,268 @@
+#ifndef VERTEX_LAYOUT_H
+#define VERTEX_LAYOUT_H
+
+#include "BoundingVolume.h"
+#include <GL\glew.h>
+#include <glm\glm.hpp>
+#include <glm\gtc\packing.hpp>
+#include <glm\gtc\type_precision.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+
+// Points to the vertex attributes and indices of a mesh that are stored elsewhere,
+// such as in system memory or in a memory-mapped mesh cache
+struct MeshView
+{
+	const glm::vec3* pPositions;
+	const glm::vec2* pTexCoords;
+	const glm::vec3* pNormals;
+	GLsizei numVertices;
+
+	const GLuint* pIndices;
+	GLsizei numIndices;
+
+	// The bounds of the positions, quantised positions are stored relative to the box
+	AABB bounds;
+	BoundingSphere boundingSphere;
+};
+
+// How the vertex attributes of a mesh are stored on the GPU
+enum class VertexFormat
+{
+	// Each attribute is stored in its own buffer
+	SPLIT,
+
+	// Every attribute of a vertex is stored next to each other in a single buffer
+	INTERLEAVED,
+
+	// Interleaved and compressed to half the size, see QuantisedVertexLayout
+	QUANTISED
+};
+
+// Each vertex attribute describes where it is read from, how it is stored in a vertex
+// and which shader input location it is bound to. An attribute that depends on the whole mesh
+// works that out once in a static Prepare(view), whose result is passed to every Read().
+
+struct PositionAttrib
+{
+	using Type = glm::vec3;
+	static constexpr GLuint LOCATION = 0;
+	static constexpr GLint NUM_COMPONENTS = 3;
+	static constexpr GLenum COMPONENT_TYPE = GL_FLOAT;
+	static constexpr GLboolean NORMALISED = GL_FALSE;
+
+	static Type Read(const MeshView& view, GLsizei vertex) { return view.pPositions[vertex]; }
+};
+
+struct NormalAttrib
+{
+	using Type = glm::vec3;
+	static constexpr GLuint LOCATION = 1;
+	static constexpr GLint NUM_COMPONENTS = 3;
+	static constexpr GLenum COMPONENT_TYPE = GL_FLOAT;
+	static constexpr GLboolean NORMALISED = GL_FALSE;
+
+	static Type Read(const MeshView& view, GLsizei vertex) { return view.pNormals[vertex]; }
+};
+
+struct TexCoordAttrib
+{
+	using Type = glm::vec2;
+	static constexpr GLuint LOCATION = 2;
+	static constexpr GLint NUM_COMPONENTS = 2;
+	static constexpr GLenum COMPONENT_TYPE = GL_FLOAT;
+	static constexpr GLboolean NORMALISED = GL_FALSE;
+
+	static Type Read(const MeshView& view, GLsizei vertex) { return view.pTexCoords[vertex]; }
+};
+
+// The position as a 16-bit unsigned normalised value per axis, relative to the bounding box.
+// The fourth component only pads the attribute to 8 bytes.
+// The error is at most half a step, (bounds.max - bounds.min) / 65535 / 2 along each axis.
+struct QuantisedPositionAttrib
+{
+	using Type = glm::u16vec4;
+	static constexpr GLuint LOCATION = 0;
+	static constexpr GLint NUM_COMPONENTS = 3;
+	static constexpr GLenum COMPONENT_TYPE = GL_UNSIGNED_SHORT;
+	static constexpr GLboolean NORMALISED = GL_TRUE;
+
+	// Maps the bounding box of the mesh onto [0, 65535] along each axis
+	struct Quantiser
+	{
+		glm::vec3 min;
+		glm::vec3 scale;
+	};
+
+	static Quantiser Prepare(const MeshView& view)
+	{
+		const glm::vec3 extent = view.bounds.max - view.bounds.min;
+
+		// Flat axes have no extent, every position on them is stored as 0
+		Quantiser quantiser{ view.bounds.min, glm::vec3(0.0f) };
+		for(int axis = 0; axis < 3; ++axis)
+		{
+			if(extent[axis] > 0.0f)
+			{
+				quantiser.scale[axis] = 65535.0f / extent[axis];
+			}
+		}
+
+		return quantiser;
+	}
+
+	static Type Read(const MeshView& view, const Quantiser& quantiser, GLsizei vertex)
+	{
+		const glm::vec3 quantised = glm::round((view.pPositions[vertex] - quantiser.min) * quantiser.scale);
+
+		return Type(glm::clamp(quantised, glm::vec3(0.0f), glm::vec3(65535.0f)), 0);
+	}
+};
+
+// The normal mapped onto an octahedron and unfolded into a square, stored as two
+// 16-bit signed normalised values. It is decoded in the vertex shader.
+// The angular error is below 0.01 degrees.
+struct OctahedralNormalAttrib
+{
+	using Type = std::uint32_t;
+	static constexpr GLuint LOCATION = 1;
+	static constexpr GLint NUM_COMPONENTS = 2;
+	static constexpr GLenum COMPONENT_TYPE = GL_SHORT;
+	static constexpr GLboolean NORMALISED = GL_TRUE;
+
+	static glm::vec2 Encode(const glm::vec3& normal)
+	{
+		const glm::vec3 n = normal / (glm::abs(normal.x) + glm::abs(normal.y) + glm::abs(normal.z));
+		if(n.z >= 0.0f)
+		{
+			return glm::vec2(n.x, n.y);
+		}
+
+		// Fold the lower half of the octahedron over the upper half
+		const glm::vec2 sign(n.x >= 0.0f ? 1.0f : -1.0f, n.y >= 0.0f ? 1.0f : -1.0f);
+		return (1.0f - glm::abs(glm::vec2(n.y, n.x))) * sign;
+	}
+
+	static glm::vec3 Decode(const glm::vec2& encoded)
+	{
+		glm::vec3 n(encoded.x, encoded.y, 1.0f - glm::abs(encoded.x) - glm::abs(encoded.y));
+		if(n.z < 0.0f)
+		{
+			const glm::vec2 sign(n.x >= 0.0f ? 1.0f : -1.0f, n.y >= 0.0f ? 1.0f : -1.0f);
+			const glm::vec2 unfolded = (1.0f - glm::abs(glm::vec2(n.y, n.x))) * sign;
+			n.x = unfolded.x;
+			n.y = unfolded.y;
+		}
+		return glm::normalize(n);
+	}
+
+	static Type Read(const MeshView& view, GLsizei vertex)
+	{
+		return glm::packSnorm2x16(Encode(view.pNormals[vertex]));
+	}
+};
+
+// The texture coordinate as two half floats. Coordinates in [-1, 1] have an error of at most
+// 1/4096, the error doubles with each power of two beyond that, so heavily tiled
+// coordinates lose texel accuracy.
+struct HalfTexCoordAttrib
+{
+	using Type = std::uint32_t;
+	static constexpr GLuint LOCATION = 2;
+	static constexpr GLint NUM_COMPONENTS = 2;
+	static constexpr GLenum COMPONENT_TYPE = GL_HALF_FLOAT;
+	static constexpr GLboolean NORMALISED = GL_FALSE;
+
+	static Type Read(const MeshView& view, GLsizei vertex)
+	{
+		return glm::packHalf2x16(view.pTexCoords[vertex]);
+	}
+};
+
+// An interleaved vertex made up of the attributes in the order they are listed.
+// New vertex formats only need a new combination of attributes.
+template <typename... Attribs>
+struct VertexLayout
+{
+	// The size of a single vertex in bytes
+	static constexpr GLsizei STRIDE = static_cast<GLsizei>((sizeof(typename Attribs::Type) + ...));
+
+	// Writes every vertex of the view to pDest, which must hold view.numVertices * STRIDE bytes
+	static void Interleave(const MeshView& view, unsigned char* pDest)
+	{
+		const std::tuple<decltype(Prepare<Attribs>(view))...> prepared{ Prepare<Attribs>(view)... };
+
+		std::apply([&view, pDest](const auto&... attribPrepared)
+		{
+			for(GLsizei vertex = 0; vertex < view.numVertices; ++vertex)
+			{
+				unsigned char* p = pDest + static_cast<std::size_t>(vertex) * STRIDE;
+				((p = WriteAttrib<Attribs>(view, attribPrepared, vertex, p)), ...);
+			}
+		}, prepared);
+	}
+
+	// Describes the layout to the currently bound vertex array,
+	// reading from the currently bound array buffer
+	static void SetAttribPointers()
+	{
+		std::size_t offset = 0;
+		((offset = SetAttribPointer<Attribs>(offset)), ...);
+	}
+
+private:
+	// Stands in for the result of Prepare() for attributes that do not have one
+	struct NotPrepared {};
+
+	template <typename Attrib>
+	static auto Prepare(const MeshView& view)
+	{
+		if constexpr(requires { Attrib::Prepare(view); })
+		{
+			return Attrib::Prepare(view);
+		}
+		else
+		{
+			return NotPrepared{};
+		}
+	}
+
+	template <typename Attrib, typename Prepared>
+	static unsigned char* WriteAttrib(const MeshView& view, const Prepared& prepared, GLsizei vertex, unsigned char* p)
+	{
+		typename Attrib::Type value;
+		if constexpr(std::is_same_v<Prepared, NotPrepared>)
+		{
+			value = Attrib::Read(view, vertex);
+		}
+		else
+		{
+			value = Attrib::Read(view, prepared, vertex);
+		}
+		std::memcpy(p, &value, sizeof(value));
+
+		return p + sizeof(value);
+	}
+
+	template <typename Attrib>
+	static std::size_t SetAttribPointer(std::size_t offset)
+	{
+		glEnableVertexAttribArray(Attrib::LOCATION);
+		glVertexAttribPointer(Attrib::LOCATION, Attrib::NUM_COMPONENTS, Attrib::COMPONENT_TYPE,
+			Attrib::NORMALISED, STRIDE, reinterpret_cast<const void*>(offset));
+
+		return offset + sizeof(typename Attrib::Type);
+	}
+};
+
+// 32 bytes per vertex, the same data as the split format
+using StandardVertexLayout = VertexLayout<PositionAttrib, NormalAttrib, TexCoordAttrib>;
+
+// 16 bytes per vertex. The positions must be transformed by the mesh's dequantisation
+// matrix and the normals must be decoded in the vertex shader.
+using QuantisedVertexLayout = VertexLayout<QuantisedPositionAttrib, OctahedralNormalAttrib, HalfTexCoordAttrib>;
+
+#endif
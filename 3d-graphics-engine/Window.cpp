@@ -3,6 +3,7 @@
 #include "imgui_impl_opengl3.h"
 
 #include "Window.h"
+#include "GLState.h"
 #include "GraphicsEngine.h"
 #include "Util.h"
 #include <iostream>
@@ -138,11 +139,11 @@ bool Window::Initialise()
 	} 
 
 	glClearColor(0.025f, 0.025f, 0.025f, 1.0f);
-	glEnable(GL_DEPTH_TEST);
+	GLState::SetEnabled(GL_DEPTH_TEST, true);
 
 	// Set the depth comparison function. Choosing GL_LEQUAL helped
 	// solve flickering issues around edges of polygons
-	glDepthFunc(GL_LEQUAL);
+	GLState::DepthFunc(GL_LEQUAL);
 
 	// Initialise Dear ImGui
 	IMGUI_CHECKVERSION();
@@ -1,7 +1,9 @@
+#include "Benchmark.h"
 #include "Entity.h"
 #include "GraphicsEngine.h"
 #include "Light.h"
 #include "Mesh.h"
+#include "MeshCache.h"
 #include "MeshCreator.h"
 #include "MeshManager.h"
 #include "MeshUtil.h"
@@ -11,11 +13,28 @@
 #include <glm\glm.hpp>
 #include <cstdlib>
 #include <iostream>
+#include <string>
 
 extern GLuint g_normalsVaoID;
 
+// Runs the performance benchmarks instead of the scene
+#define RUN_BENCHMARKS 0
+
 int main(int argc, char* argv[])
 {
+	// Cook the mesh caches of the given OBJ files without starting the engine,
+	// e.g. '3d-graphics-engine.exe --cook ../res/models/teapot2.obj'
+	if(argc > 1 && std::string(argv[1]) == "--cook")
+	{
+		bool cooked = true;
+		for(int i = 2; i < argc; ++i)
+		{
+			cooked = MeshCache::Cook(argv[i]) && cooked;
+		}
+
+		return cooked ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
 	Window window = Window("3D Graphics Engine",
 		Constants::DEFAULT_WINDOW_WIDTH, Constants::DEFAULT_WINDOW_HEIGHT);
 
@@ -27,6 +46,14 @@ int main(int argc, char* argv[])
 
 	GraphicsEngine graphicsEngine(&window);
 
+#if(RUN_BENCHMARKS)
+	Benchmark::MeshLoading();
+	Benchmark::VertexThroughput();
+	Benchmark::UniformUpdates();
+	Benchmark::ManyPointLights(graphicsEngine);
+	return EXIT_SUCCESS;
+#endif
+
 	// Create shaders
 	graphicsEngine.AddShader("flat-colour");
 	graphicsEngine.AddShader("phong");
@@ -34,6 +61,11 @@ int main(int argc, char* argv[])
 	graphicsEngine.AddShader("skybox");
 	graphicsEngine.AddShader("shadow-map");
 	graphicsEngine.AddShader("debug-quad");
+	graphicsEngine.AddShader("point-light-gizmo");
+	graphicsEngine.AddShader("deferred-geometry");
+	graphicsEngine.AddShader("deferred-directional");
+	graphicsEngine.AddShader("deferred-point");
+	graphicsEngine.AddShader("depth-prepass");
 
 	// Create meshes
 	graphicsEngine.AddMesh("teapot2.obj");
@@ -0,0 +1,170 @@
+#version 430
+
+#define MAX_LIGHT_MATRICES 4
+
+// Lights every pixel of the G-buffer with the directional lights, and writes the G-buffer's depth
+// so that the point light volumes and anything drawn afterwards are tested against the scene
+
+struct Light
+{
+	vec3 ambient;
+	vec3 diffuse;
+	vec3 specular;
+
+	// The index of the light's respective shadow map
+	// in the shadow map array
+	int shadowIndex;
+};
+
+struct DirectionalLight
+{
+	Light light;
+	vec3 direction;
+};
+
+out vec4 fragColour;
+
+// Laid out to match CameraUniformBlock
+layout (std140, binding=0) uniform CameraBlock
+{
+	mat4 viewProjMatrix;
+	vec3 eyePositionWorld;
+	vec3 globalAmbientLight;
+};
+
+// Laid out to match LightUniformBlock, the light buffers may be larger than these counts
+layout (std140, binding=1) uniform LightBlock
+{
+	int pointLightCount;
+	int dirLightCount;
+	int lightAssignment;
+};
+
+// Laid out to match DirectionalLightUniforms
+layout (std430, binding=3) readonly buffer DirectionalLightBuffer
+{
+	DirectionalLight directionalLights[];
+};
+
+// Laid out to match ShadowUniformBlock
+layout (std140, binding=2) uniform ShadowBlock
+{
+	mat4 lightMatrices[MAX_LIGHT_MATRICES];
+
+	// Only x is used
+	vec4 shadowBiases[MAX_LIGHT_MATRICES];
+};
+
+// The shadow maps and the G-buffer, bound from ShadowMap::START_TEXTURE_SLOT and GBuffer::START_TEXTURE_SLOT
+layout (binding=1) uniform sampler2DShadow shadowMaps[MAX_LIGHT_MATRICES];
+layout (binding=5) uniform sampler2D gPosition;
+layout (binding=6) uniform sampler2D gNormal;
+layout (binding=7) uniform sampler2D gAlbedo;
+layout (binding=8) uniform sampler2D gSpecular;
+layout (binding=9) uniform sampler2D gDepth;
+
+// The surface read from the G-buffer
+vec3 positionWorld;
+vec3 albedo;
+vec3 specularColour;
+float shininess;
+
+float CalculateShadowMapPCF(sampler2DShadow shadowMap, vec3 shadowCoordProj)
+{
+	// The size of the 'window' to sample around the fragment
+	const float WINDOW_SIZE = 5.0;
+
+	const float TOTAL_SAMPLES = WINDOW_SIZE*WINDOW_SIZE;
+
+	// How far to move to be centered around the current texel
+	const float OFFSET = (WINDOW_SIZE - 1) / 2.0;
+
+	float shadow = 0.0;
+
+	for(float x = -OFFSET; x <= OFFSET; x += 1.0)
+	{
+		for(float y = -OFFSET; y <= OFFSET; y += 1.0)
+		{
+			shadow += textureOffset(shadowMap, shadowCoordProj, ivec2(x, y));
+		}
+	}
+
+	return shadow / TOTAL_SAMPLES;
+}
+
+float CalculateShadow(sampler2DShadow shadowMap, vec3 N, vec3 L, int idx)
+{
+	vec4 shadowCoord = lightMatrices[idx] * vec4(positionWorld, 1.0);
+	vec3 shadowCoordProj = vec3(shadowCoord / shadowCoord.w);
+
+	// The bias grows with the angle to the light, as in the forward shaders
+	const float MIN_BIAS = shadowBiases[idx].x;
+	const float MAX_BIAS = shadowBiases[idx].x * 10.0;
+
+	float bias = max(MAX_BIAS * (1.0 - dot(N, L)), MIN_BIAS);
+	shadowCoordProj.z -= bias;
+
+	return CalculateShadowMapPCF(shadowMap, shadowCoordProj);
+}
+
+// Samplers may only be indexed by constant expressions here, so each shadow map is picked with a constant index
+float SelectShadow(vec3 N, vec3 L, int idx)
+{
+	switch(idx)
+	{
+		case 0: return CalculateShadow(shadowMaps[0], N, L, 0);
+		case 1: return CalculateShadow(shadowMaps[1], N, L, 1);
+		case 2: return CalculateShadow(shadowMaps[2], N, L, 2);
+		case 3: return CalculateShadow(shadowMaps[3], N, L, 3);
+		default: return 1.0;
+	}
+}
+
+vec3 CalculateLight(Light light, vec3 L, vec3 N, int idx)
+{
+	L = normalize(L);
+
+	float diffuseIntensity = max(dot(N, L), 0.0);
+
+	vec3 E = normalize(eyePositionWorld - positionWorld);
+	vec3 R = reflect(-L, N);
+	float specFactor = pow(max(dot(R, E), 0.0), shininess);
+
+	float shadow = SelectShadow(N, L, idx);
+
+	vec3 ambient  = albedo * (globalAmbientLight + light.ambient);
+	vec3 diffuse  = albedo * light.diffuse * diffuseIntensity;
+	vec3 specular = specularColour * light.specular * specFactor;
+
+	return (diffuse + specular) * shadow + ambient;
+}
+
+void main()
+{
+	ivec2 pixel = ivec2(gl_FragCoord.xy);
+
+	// Pixels that nothing was drawn to keep the skybox
+	vec3 normal = texelFetch(gNormal, pixel, 0).xyz;
+	if(normal == vec3(0.0))
+	{
+		discard;
+	}
+
+	vec4 position = texelFetch(gPosition, pixel, 0);
+	positionWorld = position.xyz;
+	shininess = position.w;
+	albedo = texelFetch(gAlbedo, pixel, 0).rgb;
+	specularColour = texelFetch(gSpecular, pixel, 0).rgb;
+
+	vec3 N = normalize(normal);
+	vec3 total = vec3(0.0);
+
+	for(int i = 0; i < dirLightCount; ++i)
+	{
+		DirectionalLight dirLight = directionalLights[i];
+		total += CalculateLight(dirLight.light, -dirLight.direction, N, dirLight.light.shadowIndex);
+	}
+
+	fragColour = vec4(total, 1.0);
+	gl_FragDepth = texelFetch(gDepth, pixel, 0).r;
+}
@@ -0,0 +1,9 @@
+#version 430
+
+// Draws a triangle that covers the whole screen from three vertices without any vertex buffers
+
+void main()
+{
+	vec2 corner = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+	gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);
+}
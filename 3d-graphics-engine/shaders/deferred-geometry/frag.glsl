@@ -0,0 +1,48 @@
+#version 430
+
+// Writes the surface of each pixel into the G-buffer, in the order of GBuffer::Target. Textured and
+// untextured materials share this shader, the lighting passes cannot tell them apart.
+
+struct Material
+{
+	vec3 ambient;
+	vec3 diffuse;
+	vec3 specular;
+	float shininess;
+
+	// When set the diffuse map is used for the diffuse and specular colours, as the phong shader does
+	bool hasDiffuseMap;
+};
+
+in vec2 textureCoord;
+in vec3 positionWorld;
+in vec3 normalWorld;
+
+layout (location=0) out vec4 gPosition;
+layout (location=1) out vec4 gNormal;
+layout (location=2) out vec4 gAlbedo;
+layout (location=3) out vec4 gSpecular;
+
+layout (binding=0) uniform sampler2D diffuseMap;
+uniform Material material;
+
+void main()
+{
+	gPosition = vec4(positionWorld, material.shininess);
+
+	// The normal is never zero, so pixels that are drawn to can be told apart from the cleared ones
+	gNormal = vec4(normalize(normalWorld), 1.0);
+
+	// The G-buffer has no room for the ambient colour, so the diffuse colour is used in its place
+	if(material.hasDiffuseMap)
+	{
+		vec3 diffuseColour = texture(diffuseMap, textureCoord).rgb;
+		gAlbedo = vec4(diffuseColour, 1.0);
+		gSpecular = vec4(diffuseColour, 1.0);
+	}
+	else
+	{
+		gAlbedo = vec4(material.diffuse, 1.0);
+		gSpecular = vec4(material.specular, 1.0);
+	}
+}
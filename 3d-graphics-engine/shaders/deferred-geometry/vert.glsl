@@ -0,0 +1,65 @@
+#version 430
+
+layout (location=0) in vec3 position;
+layout (location=1) in vec3 normal;
+layout (location=2) in vec2 texCoord;
+
+out vec2 textureCoord;
+out vec3 positionWorld;
+out vec3 normalWorld;
+
+// The per-instance data, laid out to match InstanceData
+struct Instance
+{
+	mat4 modelMatrix;
+	mat4 normalMatrix;
+};
+
+layout (std430, binding=0) readonly buffer InstanceBuffer
+{
+	Instance instances[];
+};
+
+// The index of the draw call's first instance in the buffer
+uniform int instanceOffset;
+
+// Laid out to match CameraUniformBlock
+layout (std140, binding=0) uniform CameraBlock
+{
+	mat4 viewProjMatrix;
+	vec3 eyePositionWorld;
+	vec3 globalAmbientLight;
+};
+
+// True if the normal is stored in its x and y components using octahedral encoding
+uniform bool octahedralNormals;
+
+vec3 DecodeOctahedral(vec2 encoded)
+{
+	vec3 n = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+
+	// Unfold the lower half of the octahedron
+	if(n.z < 0.0)
+	{
+		n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+	}
+
+	return normalize(n);
+}
+
+void main()
+{
+	Instance instance = instances[instanceOffset + gl_InstanceID];
+
+	vec4 worldPosition = instance.modelMatrix * vec4(position, 1.0);
+	positionWorld = vec3(worldPosition);
+
+	gl_Position = viewProjMatrix * worldPosition;
+
+	vec3 modelNormal = octahedralNormals ? DecodeOctahedral(normal.xy) : normal;
+
+	// Make the w component 0 to ignore translation
+	normalWorld = vec3(instance.normalMatrix * vec4(modelNormal, 0.0));
+
+	textureCoord = texCoord;
+}
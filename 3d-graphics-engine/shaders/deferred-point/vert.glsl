@@ -0,0 +1,58 @@
+#version 430
+
+// Draws a sphere around each point light that covers the pixels the light can reach
+
+layout (location=0) in vec3 position;
+
+struct Light
+{
+	vec3 ambient;
+	vec3 diffuse;
+	vec3 specular;
+	int shadowIndex;
+};
+
+struct PointLight
+{
+	Light light;
+	vec3 position;
+	float radius;
+	vec3 attenuation;
+};
+
+// Laid out to match PointLightUniforms, each instance is a light
+layout (std430, binding=2) readonly buffer PointLightBuffer
+{
+	PointLight pointLights[];
+};
+
+// Laid out to match CameraUniformBlock
+layout (std140, binding=0) uniform CameraBlock
+{
+	mat4 viewProjMatrix;
+	vec3 eyePositionWorld;
+	vec3 globalAmbientLight;
+};
+
+// Transforms the light mesh to a sphere of radius 1 centred on the origin
+uniform mat4 meshMatrix;
+
+// The camera's far plane, nothing further than this from the camera can be lit
+uniform float farPlane;
+
+flat out int lightIndex;
+
+void main()
+{
+	lightIndex = gl_InstanceID;
+	PointLight pointLight = pointLights[lightIndex];
+
+	// A light without attenuation reaches everything, so its sphere only needs to cover the
+	// camera's view. The mesh's faces lie inside the sphere through its vertices, so it is
+	// enlarged to keep them outside of the light's radius.
+	const float FACE_SCALE = 1.1;
+	float radius = min(pointLight.radius, distance(eyePositionWorld, pointLight.position) + farPlane);
+
+	vec3 positionWorld = vec3(meshMatrix * vec4(position, 1.0)) * radius * FACE_SCALE + pointLight.position;
+	gl_Position = viewProjMatrix * vec4(positionWorld, 1.0);
+}
@@ -0,0 +1,6 @@
+#version 430
+
+void main()
+{
+	// Colour writes are disabled during the pre-pass, only the depth is kept
+}
@@ -0,0 +1,38 @@
+#version 430
+
+// Only the position is read, so only the depth of each entity is drawn
+
+layout (location=0) in vec3 position;
+
+// The per-instance data, laid out to match InstanceData
+struct Instance
+{
+	mat4 modelMatrix;
+	mat4 normalMatrix;
+};
+
+layout (std430, binding=0) readonly buffer InstanceBuffer
+{
+	Instance instances[];
+};
+
+// The index of the draw call's first instance in the buffer
+uniform int instanceOffset;
+
+// Laid out to match CameraUniformBlock
+layout (std140, binding=0) uniform CameraBlock
+{
+	mat4 viewProjMatrix;
+	vec3 eyePositionWorld;
+	vec3 globalAmbientLight;
+};
+
+// The phong shaders test against this depth with GL_EQUAL, so the position must be calculated
+// exactly as they calculate it
+invariant gl_Position;
+
+void main()
+{
+	vec4 worldPosition = instances[instanceOffset + gl_InstanceID].modelMatrix * vec4(position, 1.0);
+	gl_Position = viewProjMatrix * worldPosition;
+}
@@ -2,9 +2,24 @@
 
 layout (location=0) in vec3 position;
 
-uniform mat4 modelViewProjMatrix;
+// The per-instance data, laid out to match InstanceData
+struct Instance
+{
+	mat4 modelMatrix;
+	mat4 normalMatrix;
+};
+
+layout (std430, binding=0) readonly buffer InstanceBuffer
+{
+	Instance instances[];
+};
+
+// The index of the draw call's first instance in the buffer
+uniform int instanceOffset;
+
+uniform mat4 viewProjMatrix;
 
 void main()
 {
-	gl_Position = modelViewProjMatrix * vec4(position.xyz, 1.0f);
+	gl_Position = viewProjMatrix * instances[instanceOffset + gl_InstanceID].modelMatrix * vec4(position.xyz, 1.0f);
 }
\ No newline at end of file
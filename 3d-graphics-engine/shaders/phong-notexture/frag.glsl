@@ -1,16 +1,11 @@
 #version 430
 
-#define MAX_POINT_LIGHTS 4
-#define MAX_DIR_LIGHTS   4
-
 #define MAX_LIGHT_MATRICES 4
 
-struct Attenuation
-{
-	float quadratic;
-	float linear;
-	float constant;
-};
+// The LightAssignment values
+#define EVERY_LIGHT 0
+#define PER_ENTITY 1
+#define CLUSTERED 2
 
 struct Light
 {
@@ -35,7 +30,12 @@ struct PointLight
 	Light light;
 
 	vec3 position;
-	Attenuation attenuation;
+
+	// The distance beyond which the light has no visible effect
+	float radius;
+
+	// The quadratic, linear and constant attenuation terms
+	vec3 attenuation;
 };
 
 struct Material
@@ -49,18 +49,83 @@ struct Material
 in vec3 positionWorld;
 in vec3 normalWorld;
 in vec4 shadowCoords[MAX_LIGHT_MATRICES];
+flat in int instanceIndex;
 
 out vec4 fragColour;
 
-uniform int pointLightCount;
-uniform int dirLightCount;
+// Laid out to match CameraUniformBlock
+layout (std140, binding=0) uniform CameraBlock
+{
+	mat4 viewProjMatrix;
+	vec3 eyePositionWorld;
+	vec3 globalAmbientLight;
+};
+
+// Laid out to match LightUniformBlock, the light buffers may be larger than these counts
+layout (std140, binding=1) uniform LightBlock
+{
+	int pointLightCount;
+	int dirLightCount;
+
+	// How the point lights that reach the fragment are found
+	int lightAssignment;
+};
+
+// Laid out to match PointLightUniforms and DirectionalLightUniforms
+layout (std430, binding=2) readonly buffer PointLightBuffer
+{
+	PointLight pointLights[];
+};
+
+layout (std430, binding=3) readonly buffer DirectionalLightBuffer
+{
+	DirectionalLight directionalLights[];
+};
+
+// Laid out to match ClusterUniformBlock. The camera's frustum is split into clusterGrid.xyz clusters.
+layout (std140, binding=3) uniform ClusterBlock
+{
+	uvec4 clusterGrid;
+
+	// Pixels to tiles in xy, and the scale and bias that take log(view depth) to a slice in zw
+	vec4 clusterScale;
+
+	// The near and far planes in xy
+	vec4 clusterDepth;
+};
+
+// The offset and count of each cluster's lights in clusterLightIndices
+layout (std430, binding=4) readonly buffer ClusterBuffer
+{
+	uvec2 clusters[];
+};
+
+layout (std430, binding=5) readonly buffer ClusterLightIndexBuffer
+{
+	uint clusterLightIndices[];
+};
+
+// The offset and count of each instance's lights in entityLightIndices
+layout (std430, binding=6) readonly buffer InstanceLightBuffer
+{
+	uvec2 instanceLights[];
+};
+
+layout (std430, binding=7) readonly buffer EntityLightIndexBuffer
+{
+	uint entityLightIndices[];
+};
+
+// Laid out to match ShadowUniformBlock
+layout (std140, binding=2) uniform ShadowBlock
+{
+	mat4 lightMatrices[MAX_LIGHT_MATRICES];
+
+	// Only x is used
+	vec4 shadowBiases[MAX_LIGHT_MATRICES];
+};
 
 uniform sampler2DShadow shadowMaps[MAX_LIGHT_MATRICES];
-uniform float shadowBiases[MAX_LIGHT_MATRICES];
-uniform vec3 globalAmbientLight;
-uniform vec3 eyePositionWorld;
-uniform PointLight pointLights[MAX_POINT_LIGHTS];
-uniform DirectionalLight directionalLights[MAX_DIR_LIGHTS];
 uniform Material material;
 
 float CalculateShadowMapPCF(sampler2DShadow shadowMap, vec3 shadowCoordProj)
@@ -97,8 +162,8 @@ vec3 N, vec3 L, int idx)
 	vec3 shadowCoordProj = vec3(shadowCoord / shadowCoord.w);
 	
 	// Calculate the min and maximum bias
-	const float MIN_BIAS = shadowBiases[idx];
-	const float MAX_BIAS = shadowBiases[idx] * 10.0;
+	const float MIN_BIAS = shadowBiases[idx].x;
+	const float MAX_BIAS = shadowBiases[idx].x * 10.0;
 
 	// The bias should change depending on the angle to the light
 	// instead of being constant.
@@ -111,6 +176,20 @@ vec3 N, vec3 L, int idx)
 	return CalculateShadowMapPCF(shadowMap, shadowCoordProj);
 }
 
+// Samplers may only be indexed by dynamically uniform values, which the shadow index of a light
+// from a cluster's list is not, so each shadow map is picked with a constant index
+float SelectShadow(vec3 N, vec3 L, int idx)
+{
+	switch(idx)
+	{
+		case 0: return CalculateShadow(shadowMaps[0], shadowCoords[0], N, L, 0);
+		case 1: return CalculateShadow(shadowMaps[1], shadowCoords[1], N, L, 1);
+		case 2: return CalculateShadow(shadowMaps[2], shadowCoords[2], N, L, 2);
+		case 3: return CalculateShadow(shadowMaps[3], shadowCoords[3], N, L, 3);
+		default: return 1.0;
+	}
+}
+
 vec3 CalculateLight(Light light, vec3 L, vec3 N, int idx)
 {
 	L = normalize(L);	
@@ -127,8 +206,8 @@ vec3 CalculateLight(Light light, vec3 L, vec3 N, int idx)
 	vec3 R = reflect(-L, N);
 	float specFactor = pow(max(dot(R, E), 0.0), material.shininess);
 	
-	// Calculate the shadow amount
-	float shadow = CalculateShadow(shadowMaps[idx], shadowCoords[idx], N, L, idx);
+	// Calculate the shadow amount, lights without a shadow map are never in shadow
+	float shadow = SelectShadow(N, L, idx);
 
 	vec3 ambient  = material.ambient * (globalAmbientLight + light.ambient);
 	vec3 diffuse  = light.diffuse  * material.diffuse  * diffuseIntensity;
@@ -145,12 +224,27 @@ vec3 CalculatePointLight(PointLight pointLight, vec3 N)
 	// Get the distance for attenuation calculations
 	float distance = length(L);
 	
-	float attenuation = 1.0f / (pointLight.attenuation.quadratic * (distance * distance) + 
-	pointLight.attenuation.linear * distance + pointLight.attenuation.constant);
+	float attenuation = 1.0f / (pointLight.attenuation.x * (distance * distance) + 
+	pointLight.attenuation.y * distance + pointLight.attenuation.z);
 
 	return attenuation * total;
 }
 
+// Finds the cluster that contains the fragment
+uint GetClusterIndex()
+{
+	// Convert the fragment's depth back to a view space distance
+	float near = clusterDepth.x;
+	float far = clusterDepth.y;
+	float ndcDepth = gl_FragCoord.z * 2.0 - 1.0;
+	float viewDepth = 2.0 * near * far / (far + near - ndcDepth * (far - near));
+
+	uint slice = uint(clamp(log(viewDepth) * clusterScale.z + clusterScale.w, 0.0, float(clusterGrid.z - 1u)));
+	uvec2 tile = min(uvec2(gl_FragCoord.xy * clusterScale.xy), clusterGrid.xy - 1u);
+
+	return (slice * clusterGrid.y + tile.y) * clusterGrid.x + tile.x;
+}
+
 vec3 CalculateDirectionalLight(DirectionalLight dirLight, vec3 N)
 {
 	vec3 L = -dirLight.direction;
@@ -160,7 +254,7 @@ vec3 CalculateDirectionalLight(DirectionalLight dirLight, vec3 N)
 void main()
 {	
 	vec3 N = normalize(normalWorld);
-	vec3 total;
+	vec3 total = vec3(0.0);
 
 	// Keeps track of the overall light count
 	int shadowIdx = 0;  
@@ -169,10 +263,31 @@ void main()
 	// This is reset when switching light types
 	int lightIdx = 0;
 
-	while(lightIdx < pointLightCount)
+	if(lightAssignment == CLUSTERED)
 	{
-		total += CalculatePointLight(pointLights[lightIdx], N);
-		lightIdx++;
+		// Only the point lights that reach the fragment's cluster
+		uvec2 cluster = clusters[GetClusterIndex()];
+		for(uint i = 0; i < cluster.y; ++i)
+		{
+			total += CalculatePointLight(pointLights[clusterLightIndices[cluster.x + i]], N);
+		}
+	}
+	else if(lightAssignment == PER_ENTITY)
+	{
+		// Only the point lights that reach the entity, the same for every fragment of an instance
+		uvec2 entityLights = instanceLights[instanceIndex];
+		for(uint i = 0; i < entityLights.y; ++i)
+		{
+			total += CalculatePointLight(pointLights[entityLightIndices[entityLights.x + i]], N);
+		}
+	}
+	else
+	{
+		while(lightIdx < pointLightCount)
+		{
+			total += CalculatePointLight(pointLights[lightIdx], N);
+			lightIdx++;
+		}
 	}
 
 	lightIdx = 0;
@@ -11,24 +11,81 @@ out vec3 positionWorld;
 out vec3 normalWorld;
 out vec4 shadowCoords[MAX_LIGHT_MATRICES];
 
-uniform mat4 modelViewProjMatrix;
-uniform mat4 modelToWorldMatrix;
-uniform mat4 lightMatrices[MAX_LIGHT_MATRICES];
+// The index of the vertex's instance, for finding the instance's lights
+flat out int instanceIndex;
+
+// The per-instance data, laid out to match InstanceData
+struct Instance
+{
+	mat4 modelMatrix;
+	mat4 normalMatrix;
+};
+
+layout (std430, binding=0) readonly buffer InstanceBuffer
+{
+	Instance instances[];
+};
+
+// The index of the draw call's first instance in the buffer
+uniform int instanceOffset;
+
+// Laid out to match CameraUniformBlock
+layout (std140, binding=0) uniform CameraBlock
+{
+	mat4 viewProjMatrix;
+	vec3 eyePositionWorld;
+	vec3 globalAmbientLight;
+};
+
+// Laid out to match ShadowUniformBlock
+layout (std140, binding=2) uniform ShadowBlock
+{
+	// Transform world space positions to each light's shadow map
+	mat4 lightMatrices[MAX_LIGHT_MATRICES];
+
+	// Only x is used
+	vec4 shadowBiases[MAX_LIGHT_MATRICES];
+};
+
+// Matches the depth pre-pass exactly, so that its depth can be tested with GL_EQUAL
+invariant gl_Position;
+
+// True if the normal is stored in its x and y components using octahedral encoding
+uniform bool octahedralNormals;
+
+vec3 DecodeOctahedral(vec2 encoded)
+{
+	vec3 n = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+
+	// Unfold the lower half of the octahedron
+	if(n.z < 0.0)
+	{
+		n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+	}
+
+	return normalize(n);
+}
 
 void main()
 {
-	gl_Position = modelViewProjMatrix * vec4(position, 1.0);
+	instanceIndex = instanceOffset + gl_InstanceID;
+	Instance instance = instances[instanceIndex];
 
 	// Transform the vertex position to world space for lighting calculations
-	positionWorld = vec3(modelToWorldMatrix * vec4(position, 1.0));
+	vec4 worldPosition = instance.modelMatrix * vec4(position, 1.0);
+	positionWorld = vec3(worldPosition);
+
+	gl_Position = viewProjMatrix * worldPosition;
+
+	vec3 modelNormal = octahedralNormals ? DecodeOctahedral(normal.xy) : normal;
 
 	// Make the w component 0 to ignore translation
-	normalWorld = vec3(modelToWorldMatrix * vec4(normal, 0.0));
+	normalWorld = vec3(instance.normalMatrix * vec4(modelNormal, 0.0));
 
 	textureCoord = texCoord;
 
 	for(int i = 0; i < MAX_LIGHT_MATRICES; ++i)
 	{
-		shadowCoords[i] = lightMatrices[i] * vec4(position, 1.0);
+		shadowCoords[i] = lightMatrices[i] * worldPosition;
 	}
 }
\ No newline at end of file
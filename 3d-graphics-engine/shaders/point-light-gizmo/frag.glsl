@@ -0,0 +1,10 @@
+#version 430
+
+in vec3 gizmoColour;
+
+out vec4 colour;
+
+void main()
+{
+	colour = vec4(gizmoColour, 1.0f);
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#version 430
+
+layout (location=0) in vec3 position;
+
+// The per-light data, laid out to match PointLightGizmos::Gizmo
+struct Gizmo
+{
+	vec4 position;
+	vec4 colour;
+};
+
+layout (std430, binding=1) readonly buffer GizmoBuffer
+{
+	Gizmo gizmos[];
+};
+
+uniform mat4 viewProjMatrix;
+
+// Transforms the light mesh to a gizmo centred on the origin
+uniform mat4 meshMatrix;
+
+// When set, every gizmo is drawn in diffuseColour instead of its light's colour
+uniform bool overrideColour;
+uniform vec3 diffuseColour;
+
+out vec3 gizmoColour;
+
+void main()
+{
+	Gizmo gizmo = gizmos[gl_InstanceID];
+
+	vec3 positionWorld = vec3(meshMatrix * vec4(position, 1.0)) + gizmo.position.xyz;
+	gl_Position = viewProjMatrix * vec4(positionWorld, 1.0);
+
+	gizmoColour = overrideColour ? diffuseColour : gizmo.colour.rgb;
+}
\ No newline at end of file
@@ -2,9 +2,24 @@
 
 layout (location=0) in vec3 position;
 
+// The per-instance data, laid out to match InstanceData
+struct Instance
+{
+	mat4 modelMatrix;
+	mat4 normalMatrix;
+};
+
+layout (std430, binding=0) readonly buffer InstanceBuffer
+{
+	Instance instances[];
+};
+
+// The index of the draw call's first instance in the buffer
+uniform int instanceOffset;
+
 uniform mat4 lightMatrix;
 
 void main()
 {
-	gl_Position = lightMatrix * vec4(position, 1.0);
+	gl_Position = lightMatrix * instances[instanceOffset + gl_InstanceID].modelMatrix * vec4(position, 1.0);
 }
\ No newline at end of file
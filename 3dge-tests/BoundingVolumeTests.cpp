@@ -0,0 +1,95 @@
+#include "pch.h"
+
+#include "../3d-graphics-engine/BoundingVolume.h"
+#include <glm\glm.hpp>
+#include <glm\gtc\matrix_transform.hpp>
+#include <cfloat>
+#include <vector>
+
+TEST(BoundingVolume, AABBCoversEveryPosition)
+{
+	// Arrange, an odd number of positions so that the last one is read separately
+	const std::vector<glm::vec3> positions = {
+		{ 1.0f, 2.0f, 3.0f }, { -4.0f, 0.5f, 6.0f }, { 0.0f, -7.0f, 1.0f },
+		{ 2.5f, 3.0f, -8.0f }, { 9.0f, 1.0f, 0.0f }
+	};
+
+	// Act
+	const AABB bounds = BoundingVolume::CalculateAABB(positions.data(), positions.size());
+
+	// Assert
+	EXPECT_EQ(bounds.min, glm::vec3(-4.0f, -7.0f, -8.0f));
+	EXPECT_EQ(bounds.max, glm::vec3(9.0f, 3.0f, 6.0f));
+}
+
+TEST(BoundingVolume, AABBOfSinglePosition)
+{
+	// Arrange
+	const glm::vec3 position(1.0f, -2.0f, 3.0f);
+
+	// Act
+	const AABB bounds = BoundingVolume::CalculateAABB(&position, 1);
+
+	// Assert
+	EXPECT_EQ(bounds.min, position);
+	EXPECT_EQ(bounds.max, position);
+}
+
+TEST(BoundingVolume, SphereReachesFurthestPosition)
+{
+	// Arrange
+	const std::vector<glm::vec3> positions = { { -1.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, { 0.0f, 0.5f, 0.0f } };
+	const AABB bounds = BoundingVolume::CalculateAABB(positions.data(), positions.size());
+
+	// Act
+	const BoundingSphere sphere = BoundingVolume::CalculateBoundingSphere(positions.data(), positions.size(), bounds);
+
+	// Assert
+	EXPECT_EQ(sphere.centre, glm::vec3(0.0f, 0.25f, 0.0f));
+	EXPECT_FLOAT_EQ(sphere.radius, glm::length(glm::vec3(1.0f, -0.25f, 0.0f)));
+}
+
+TEST(BoundingVolume, TransformedAABBEnclosesTransformedCorners)
+{
+	// Arrange
+	const AABB bounds{ glm::vec3(-1.0f, -2.0f, -3.0f), glm::vec3(1.0f, 2.0f, 3.0f) };
+	glm::mat4 matrix = glm::translate(glm::mat4(1.0f), glm::vec3(5.0f, 0.0f, -2.0f));
+	matrix = glm::rotate(matrix, glm::radians(30.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	matrix = glm::scale(matrix, glm::vec3(2.0f));
+
+	// Act
+	const AABB result = BoundingVolume::TransformAABB(bounds, matrix);
+
+	// Assert, the result must be the box around the eight transformed corners
+	glm::vec3 expectedMin(FLT_MAX);
+	glm::vec3 expectedMax(-FLT_MAX);
+	for(int corner = 0; corner < 8; ++corner)
+	{
+		const glm::vec3 position((corner & 1) ? bounds.max.x : bounds.min.x,
+			(corner & 2) ? bounds.max.y : bounds.min.y, (corner & 4) ? bounds.max.z : bounds.min.z);
+		const glm::vec3 transformed(matrix * glm::vec4(position, 1.0f));
+
+		expectedMin = glm::min(expectedMin, transformed);
+		expectedMax = glm::max(expectedMax, transformed);
+	}
+
+	for(int axis = 0; axis < 3; ++axis)
+	{
+		EXPECT_NEAR(result.min[axis], expectedMin[axis], 1e-5f);
+		EXPECT_NEAR(result.max[axis], expectedMax[axis], 1e-5f);
+	}
+}
+
+TEST(BoundingVolume, SphereIntersectsBoxOnlyWithinItsRadius)
+{
+	// Arrange
+	const AABB bounds{ glm::vec3(-1.0f), glm::vec3(1.0f) };
+	const BoundingSphere touchingEdge{ glm::vec3(2.0f, 2.0f, 0.0f), 1.5f };
+	const BoundingSphere nearCorner{ glm::vec3(2.0f, 2.0f, 2.0f), 1.5f };
+	const BoundingSphere inside{ glm::vec3(0.5f), 0.1f };
+
+	// Act & Assert, the corner is sqrt(3) away from the second sphere's centre
+	EXPECT_TRUE(BoundingVolume::Intersects(touchingEdge, bounds));
+	EXPECT_FALSE(BoundingVolume::Intersects(nearCorner, bounds));
+	EXPECT_TRUE(BoundingVolume::Intersects(inside, bounds));
+}
@@ -0,0 +1,101 @@
+#include "pch.h"
+
+#include "../3d-graphics-engine/Frustum.h"
+#include <glm\glm.hpp>
+#include <glm\gtc\matrix_transform.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+	// Looks down the negative z axis from the origin
+	Frustum CreateTestFrustum()
+	{
+		const glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+		const glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+		return Frustum(projection * view);
+	}
+
+	AABB CreateBox(const glm::vec3& centre, float halfSize)
+	{
+		return AABB{ centre - glm::vec3(halfSize), centre + glm::vec3(halfSize) };
+	}
+}
+
+TEST(Frustum, BoxInFrontIsVisible)
+{
+	// Arrange
+	const Frustum frustum = CreateTestFrustum();
+
+	// Assert
+	EXPECT_TRUE(frustum.IsVisible(CreateBox(glm::vec3(0.0f, 0.0f, -10.0f), 1.0f)));
+}
+
+TEST(Frustum, BoxBehindOrBeyondIsCulled)
+{
+	// Arrange
+	const Frustum frustum = CreateTestFrustum();
+
+	// Assert
+	EXPECT_FALSE(frustum.IsVisible(CreateBox(glm::vec3(0.0f, 0.0f, 10.0f), 1.0f)));
+	EXPECT_FALSE(frustum.IsVisible(CreateBox(glm::vec3(0.0f, 0.0f, -200.0f), 1.0f)));
+	EXPECT_FALSE(frustum.IsVisible(CreateBox(glm::vec3(100.0f, 0.0f, -10.0f), 1.0f)));
+}
+
+TEST(Frustum, BoxCrossingAPlaneIsVisible)
+{
+	// Arrange
+	const Frustum frustum = CreateTestFrustum();
+
+	// Assert, the box straddles the near plane
+	EXPECT_TRUE(frustum.IsVisible(CreateBox(glm::vec3(0.0f, 0.0f, 0.5f), 1.0f)));
+}
+
+TEST(Frustum, BatchedTestMatchesSingleTests)
+{
+	// Arrange, a number of objects that is not a multiple of four
+	const Frustum frustum = CreateTestFrustum();
+	CullingBounds bounds;
+	std::vector<AABB> boxes;
+
+	for(int i = 0; i < 23; ++i)
+	{
+		const glm::vec3 centre(i * 3.0f - 30.0f, (i % 5) * 4.0f - 8.0f, (i % 7) * 8.0f - 40.0f);
+		const AABB box = CreateBox(centre, 0.5f + (i % 3));
+
+		boxes.push_back(box);
+		bounds.Add(box, BoundingSphere{ centre, glm::length(box.GetExtents()) });
+	}
+
+	// Act
+	std::vector<std::uint8_t> visible;
+	frustum.TestVisibility(bounds, &visible);
+
+	// Assert
+	ASSERT_EQ(visible.size(), boxes.size());
+	for(std::size_t i = 0; i < boxes.size(); ++i)
+	{
+		EXPECT_EQ(visible[i] != 0, frustum.IsVisible(boxes[i])) << "Object " << i;
+	}
+}
+
+TEST(Frustum, SweptObjectIsVisibleOnlyIfItCanReachTheFrustum)
+{
+	// Arrange, a box above the frustum
+	const Frustum frustum = CreateTestFrustum();
+	const AABB box = CreateBox(glm::vec3(0.0f, 50.0f, -10.0f), 1.0f);
+	CullingBounds bounds;
+	bounds.Add(box, BoundingSphere{ box.GetCentre(), glm::length(box.GetExtents()) });
+
+	// Act
+	std::vector<std::uint8_t> shiningDown;
+	std::vector<std::uint8_t> shiningUp;
+	frustum.TestSweptVisibility(bounds, glm::vec3(0.0f, -1.0f, 0.0f), &shiningDown);
+	frustum.TestSweptVisibility(bounds, glm::vec3(0.0f, 1.0f, 0.0f), &shiningUp);
+
+	// Assert
+	EXPECT_FALSE(frustum.IsVisible(box));
+	EXPECT_TRUE(shiningDown[0]);
+	EXPECT_FALSE(shiningUp[0]);
+}
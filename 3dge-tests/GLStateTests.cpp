@@ -0,0 +1,152 @@
+#include "pch.h"
+
+#include "../3d-graphics-engine/GLState.h"
+#include <GL\glew.h>
+#include <vector>
+
+namespace
+{
+	// The calls that reached the fake driver functions
+	std::vector<GLuint> g_usedPrograms;
+	std::vector<GLuint> g_boundVertexArrays;
+
+	void GLAPIENTRY FakeUseProgram(GLuint program)
+	{
+		g_usedPrograms.push_back(program);
+	}
+
+	void GLAPIENTRY FakeBindVertexArray(GLuint vertexArray)
+	{
+		g_boundVertexArrays.push_back(vertexArray);
+	}
+
+	void GLAPIENTRY FakeDeleteVertexArrays(GLsizei, const GLuint*)
+	{
+	}
+
+	void GLAPIENTRY FakeActiveTexture(GLenum)
+	{
+	}
+
+	// Replaces the GLEW entry points used by the tests, so that no GL context is needed
+	class GLStateTest : public ::testing::Test
+	{
+		PFNGLUSEPROGRAMPROC m_useProgram;
+		PFNGLBINDVERTEXARRAYPROC m_bindVertexArray;
+		PFNGLDELETEVERTEXARRAYSPROC m_deleteVertexArrays;
+		PFNGLACTIVETEXTUREPROC m_activeTexture;
+
+	protected:
+		void SetUp() override
+		{
+			m_useProgram = glUseProgram;
+			m_bindVertexArray = glBindVertexArray;
+			m_deleteVertexArrays = glDeleteVertexArrays;
+			m_activeTexture = glActiveTexture;
+
+			glUseProgram = FakeUseProgram;
+			glBindVertexArray = FakeBindVertexArray;
+			glDeleteVertexArrays = FakeDeleteVertexArrays;
+			glActiveTexture = FakeActiveTexture;
+
+			g_usedPrograms.clear();
+			g_boundVertexArrays.clear();
+
+			GLState::Invalidate();
+			GLState::ResetStats();
+		}
+
+		void TearDown() override
+		{
+			glUseProgram = m_useProgram;
+			glBindVertexArray = m_bindVertexArray;
+			glDeleteVertexArrays = m_deleteVertexArrays;
+			glActiveTexture = m_activeTexture;
+
+			GLState::Invalidate();
+		}
+	};
+}
+
+TEST_F(GLStateTest, RepeatedCallsAreElided)
+{
+	// Act
+	GLState::UseProgram(3);
+	GLState::UseProgram(3);
+	GLState::UseProgram(4);
+	GLState::UseProgram(4);
+
+	// Assert
+	EXPECT_EQ(g_usedPrograms, (std::vector<GLuint>{ 3, 4 }));
+	EXPECT_EQ(GLState::GetStats().numCalls, 2);
+	EXPECT_EQ(GLState::GetStats().numElidedCalls, 2);
+}
+
+TEST_F(GLStateTest, InvalidateSendsTheNextCall)
+{
+	// Act
+	GLState::UseProgram(3);
+	GLState::Invalidate();
+	GLState::UseProgram(3);
+
+	// Assert
+	EXPECT_EQ(g_usedPrograms, (std::vector<GLuint>{ 3, 3 }));
+}
+
+TEST_F(GLStateTest, DeletedVertexArrayIsNoLongerBound)
+{
+	// Arrange, GL unbinds a deleted vertex array and may give its name to a new one
+	const GLuint vertexArray = 7;
+	GLState::BindVertexArray(vertexArray);
+
+	// Act
+	GLState::DeleteVertexArrays(1, &vertexArray);
+	GLState::BindVertexArray(vertexArray);
+	GLState::BindVertexArray(0);
+
+	// Assert
+	EXPECT_EQ(g_boundVertexArrays, (std::vector<GLuint>{ 7, 7, 0 }));
+}
+
+TEST_F(GLStateTest, DeletedTextureIsNoLongerBound)
+{
+	// Arrange, texture bindings are only tracked once the active unit is known
+	const GLuint texture = 7;
+	GLState::ActiveTexture(GL_TEXTURE0);
+	GLState::BindTexture(GL_TEXTURE_2D, texture);
+	GLState::ResetStats();
+
+	// Act
+	GLState::DeleteTextures(1, &texture);
+	GLState::BindTexture(GL_TEXTURE_2D, texture);
+	GLState::BindTexture(GL_TEXTURE_2D, texture);
+
+	// Assert
+	EXPECT_EQ(GLState::GetStats().numCalls, 1);
+	EXPECT_EQ(GLState::GetStats().numElidedCalls, 1);
+}
+
+TEST_F(GLStateTest, RepeatedDepthFuncIsElided)
+{
+	// Act
+	GLState::DepthFunc(GL_LESS);
+	GLState::DepthFunc(GL_LESS);
+	GLState::DepthFunc(GL_EQUAL);
+
+	// Assert
+	EXPECT_EQ(GLState::GetStats().numCalls, 2);
+	EXPECT_EQ(GLState::GetStats().numElidedCalls, 1);
+}
+
+TEST_F(GLStateTest, RepeatedBlendFuncIsElided)
+{
+	// Act, a change to either factor is sent
+	GLState::BlendFunc(GL_ONE, GL_ONE);
+	GLState::BlendFunc(GL_ONE, GL_ONE);
+	GLState::BlendFunc(GL_ONE, GL_ZERO);
+	GLState::BlendFunc(GL_ZERO, GL_ZERO);
+
+	// Assert
+	EXPECT_EQ(GLState::GetStats().numCalls, 3);
+	EXPECT_EQ(GLState::GetStats().numElidedCalls, 1);
+}
@@ -0,0 +1,101 @@
+#include "pch.h"
+
+#include "../3d-graphics-engine/LightClusters.h"
+#include <glm\gtc\matrix_transform.hpp>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+	constexpr float NEAR_PLANE = 0.1f;
+	constexpr float FAR_PLANE = 100.0f;
+
+	const glm::mat4 PROJECTION = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, NEAR_PLANE, FAR_PLANE);
+
+	// Looking down -z from the origin, so view space is world space
+	const glm::mat4 VIEW(1.0f);
+
+	bool ClusterHasLight(const LightClusters& clusters, int clusterIndex, std::uint32_t lightIndex)
+	{
+		const LightClusters::Cluster& cluster = clusters.GetClusters()[clusterIndex];
+		const auto first = clusters.GetLightIndices().begin() + cluster.offset;
+
+		return std::find(first, first + cluster.count, lightIndex) != first + cluster.count;
+	}
+}
+
+TEST(LightClusters, LightIsOnlyInTheClustersItReaches)
+{
+	// Arrange, a small light straight ahead of the camera
+	const std::vector<BoundingSphere> lights = { { glm::vec3(0.0f, 0.0f, -10.0f), 0.5f } };
+	LightClusters clusters;
+
+	// Act
+	clusters.Build(VIEW, PROJECTION, NEAR_PLANE, FAR_PLANE, lights, 1);
+
+	// Assert, the light is in the central clusters of the slice that contains its centre, and
+	// every cluster it was assigned to overlaps the light
+	const int slice = static_cast<int>(std::log(10.0f) * clusters.GetSliceScale() + clusters.GetSliceBias());
+	const int centreCluster = LightClusters::GetClusterIndex(
+		LightClusters::GRID_SIZE_X / 2, LightClusters::GRID_SIZE_Y / 2, slice);
+	EXPECT_TRUE(ClusterHasLight(clusters, centreCluster, 0));
+
+	int numClustersWithLight = 0;
+	for(int i = 0; i < LightClusters::NUM_CLUSTERS; ++i)
+	{
+		if(ClusterHasLight(clusters, i, 0))
+		{
+			const AABB& bounds = clusters.GetClusterBounds(i);
+			const glm::vec3 closest = glm::clamp(lights[0].centre, bounds.min, bounds.max);
+			EXPECT_LE(glm::length(closest - lights[0].centre), lights[0].radius) << "cluster " << i;
+			++numClustersWithLight;
+		}
+	}
+
+	EXPECT_LT(numClustersWithLight, 20);
+	EXPECT_EQ(clusters.GetLightIndices().size(), static_cast<std::size_t>(numClustersWithLight));
+}
+
+TEST(LightClusters, LightBehindTheCameraIsInNoCluster)
+{
+	// Arrange
+	const std::vector<BoundingSphere> lights = { { glm::vec3(0.0f, 0.0f, 5.0f), 1.0f } };
+	LightClusters clusters;
+
+	// Act
+	clusters.Build(VIEW, PROJECTION, NEAR_PLANE, FAR_PLANE, lights, 1);
+
+	// Assert
+	EXPECT_TRUE(clusters.GetLightIndices().empty());
+}
+
+TEST(LightClusters, ThreadsProduceTheSameClusters)
+{
+	// Arrange, lights scattered through the frustum
+	std::vector<BoundingSphere> lights;
+	for(int i = 0; i < 500; ++i)
+	{
+		const float x = static_cast<float>(i % 20) - 10.0f;
+		const float y = static_cast<float>((i / 20) % 5) - 2.0f;
+		const float z = -1.0f - static_cast<float>(i % 37);
+		lights.push_back({ glm::vec3(x, y, z), 0.5f + (i % 3) });
+	}
+
+	LightClusters singleThreaded;
+	LightClusters multiThreaded;
+
+	// Act
+	singleThreaded.Build(VIEW, PROJECTION, NEAR_PLANE, FAR_PLANE, lights, 1);
+	multiThreaded.Build(VIEW, PROJECTION, NEAR_PLANE, FAR_PLANE, lights, 5);
+
+	// Assert
+	EXPECT_FALSE(singleThreaded.GetLightIndices().empty());
+	EXPECT_EQ(singleThreaded.GetLightIndices(), multiThreaded.GetLightIndices());
+
+	for(int i = 0; i < LightClusters::NUM_CLUSTERS; ++i)
+	{
+		EXPECT_EQ(singleThreaded.GetClusters()[i].offset, multiThreaded.GetClusters()[i].offset);
+		EXPECT_EQ(singleThreaded.GetClusters()[i].count, multiThreaded.GetClusters()[i].count);
+	}
+}
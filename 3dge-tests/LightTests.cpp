@@ -4,6 +4,7 @@
 #include "../3d-graphics-engine/PointLight.h"
 #include "../3d-graphics-engine/DirectionalLight.h"
 #include <glm\glm.hpp>
+#include <algorithm>
 
 /*
 * Light Testing
@@ -170,6 +171,50 @@ TEST(PointLight, SetPositionNegative)
 	EXPECT_FLOAT_EQ(pos.z, -8.5f);
 }
 
+TEST(PointLight, SetPositionMarksShadowDirty)
+{
+	// Arrange
+	PointLight pointLight;
+	pointLight.ClearShadowDirty();
+
+	// Act
+	pointLight.SetPosition(glm::vec3(1.0f, 2.0f, 3.0f));
+
+	// Assert
+	EXPECT_TRUE(pointLight.IsShadowDirty());
+}
+
+TEST(PointLight, SetSamePositionLeavesShadowClean)
+{
+	// Arrange
+	PointLight pointLight;
+	pointLight.SetPosition(glm::vec3(1.0f, 2.0f, 3.0f));
+	pointLight.ClearShadowDirty();
+
+	// Act
+	pointLight.SetPosition(glm::vec3(1.0f, 2.0f, 3.0f));
+
+	// Assert
+	EXPECT_FALSE(pointLight.IsShadowDirty());
+}
+
+TEST(PointLight, RadiusIsWhereTheLightBecomesInvisible)
+{
+	// Arrange
+	const PointLight::Attenuation attenuation{ 1.0f, 0.5f, 1.0f };
+	const PointLight light(glm::vec3(0.0f), glm::vec3(1.0f), 1.0f, attenuation);
+
+	// Act
+	const float radius = light.CalculateRadius();
+
+	// Assert, the brightest channel has attenuated to 1/256 at the radius
+	const glm::vec3 colour = light.GetAmbient() + light.GetDiffuse() + light.GetSpecular();
+	const float brightness = std::max({ colour.r, colour.g, colour.b });
+	const float attenuated = brightness / (attenuation.quadratic * radius * radius
+		+ attenuation.linear * radius + attenuation.constant);
+	EXPECT_NEAR(attenuated, 1.0f / 256.0f, 1e-4f);
+}
+
 /*
 * DirectionalLight Testing
 */
@@ -200,4 +245,17 @@ TEST(DirectionalLight, CheckDirectionIsNormalised)
 	EXPECT_FLOAT_EQ(dirResult.x, inputDirNormalised.x);
 	EXPECT_FLOAT_EQ(dirResult.y, inputDirNormalised.y);
 	EXPECT_FLOAT_EQ(dirResult.z, inputDirNormalised.z);
-}
\ No newline at end of file
+}
+
+TEST(DirectionalLight, SetSameDirectionLeavesShadowClean)
+{
+	// Arrange
+	DirectionalLight dirLight(glm::vec3(0.0f, -2.0f, 0.0f), glm::vec3(1.0f, 1.0f, 1.0f), 1.0f);
+	dirLight.ClearShadowDirty();
+
+	// Act
+	dirLight.SetDirection(glm::vec3(0.0f, -1.0f, 0.0f));
+
+	// Assert
+	EXPECT_FALSE(dirLight.IsShadowDirty());
+}
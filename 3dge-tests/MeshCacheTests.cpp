@@ -0,0 +1,84 @@
+#include "pch.h"
+
+#include "../3d-graphics-engine/MappedFile.h"
+#include "../3d-graphics-engine/MeshCache.h"
+#include "../3d-graphics-engine/MeshLoader.h"
+#include <glm\glm.hpp>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+	// The cache does not care what the source contains, only whether it has changed
+	const std::string SOURCE_CONTENTS = "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n";
+
+	// Writes the source file and a cache of a single triangle with the given indices
+	std::string WriteTriangleCache(const std::string& name, const std::vector<GLuint>& indices)
+	{
+		const std::string sourcePath = (std::filesystem::temp_directory_path() / name).string();
+		std::ofstream(sourcePath, std::ios::binary) << SOURCE_CONTENTS;
+
+		MeshData meshData;
+		meshData.positions = { glm::vec3(0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f) };
+		meshData.texCoords.resize(3);
+		meshData.normals.resize(3, glm::vec3(0.0f, 0.0f, 1.0f));
+		meshData.indices = indices;
+
+		MeshCache::Write(sourcePath, MeshLoadOptions{}, meshData);
+		return sourcePath;
+	}
+
+	void RemoveTriangleCache(const std::string& sourcePath)
+	{
+		std::filesystem::remove(sourcePath);
+		std::filesystem::remove(MeshCache::GetCachePath(sourcePath));
+	}
+}
+
+TEST(MeshCache, OutOfRangeIndexIsRejected)
+{
+	// Arrange
+	const std::string sourcePath = WriteTriangleCache("3dge-out-of-range.obj", { 0, 1, 3 });
+	MappedFile file;
+	MeshView view;
+
+	// Act
+	const bool opened = MeshCache::Open(sourcePath, MeshLoadOptions{}, &file, &view);
+
+	// Assert
+	EXPECT_FALSE(opened);
+
+	file.Close();
+	RemoveTriangleCache(sourcePath);
+}
+
+TEST(MeshCache, TouchedSourceIsNotHashedAgain)
+{
+	// Arrange, touch the source without changing it
+	const std::string sourcePath = WriteTriangleCache("3dge-touched.obj", { 0, 1, 2 });
+	const auto touchedTime = std::filesystem::last_write_time(sourcePath) + std::chrono::hours(1);
+	std::filesystem::last_write_time(sourcePath, touchedTime);
+
+	MappedFile file;
+	MeshView view;
+	const bool openedAfterTouch = MeshCache::Open(sourcePath, MeshLoadOptions{}, &file, &view);
+	file.Close();
+
+	// Act, change the contents but keep the size and time, which only a hash would notice
+	std::string changed = SOURCE_CONTENTS;
+	changed[2] = '2';
+	std::ofstream(sourcePath, std::ios::binary) << changed;
+	std::filesystem::last_write_time(sourcePath, touchedTime);
+
+	const bool openedAfterChange = MeshCache::Open(sourcePath, MeshLoadOptions{}, &file, &view);
+
+	// Assert, the cache remembered the new time, so the source was not hashed
+	EXPECT_TRUE(openedAfterTouch);
+	EXPECT_TRUE(openedAfterChange);
+
+	file.Close();
+	RemoveTriangleCache(sourcePath);
+}
@@ -0,0 +1,200 @@
+#include "pch.h"
+
+#include "../3d-graphics-engine/MeshLoader.h"
+#include <glm\glm.hpp>
+#include <string>
+#include <vector>
+
+namespace
+{
+	bool Parse(const std::string& contents, MeshData* pMeshData, int maxThreads = 0)
+	{
+		return ParseObj(contents.data(), contents.data() + contents.size(), pMeshData, maxThreads);
+	}
+
+	const std::string TRIANGLE_OBJ =
+		"# A single triangle\n"
+		"o triangle\n"
+		"v 0.0 0.0 0.0\n"
+		"v 1.0 0.0 0.0\n"
+		"v 0.0 1.0 0.0\n"
+		"vt 0.0 0.0\n"
+		"vt 1.0 0.0\n"
+		"vt 0.0 1.0\n"
+		"vn 0.0 0.0 1.0\n"
+		"s 1\n"
+		"f 1/1/1 2/2/1 3/3/1\n";
+}
+
+TEST(MeshLoader, ParseTriangleVertexCount)
+{
+	// Arrange
+	MeshData meshData;
+
+	// Act
+	bool result = Parse(TRIANGLE_OBJ, &meshData);
+
+	// Assert
+	EXPECT_TRUE(result);
+	EXPECT_EQ(meshData.positions.size(), 3);
+	EXPECT_EQ(meshData.texCoords.size(), 3);
+	EXPECT_EQ(meshData.normals.size(), 3);
+	EXPECT_EQ(meshData.indices.size(), 3);
+}
+
+TEST(MeshLoader, ParseTriangleFaceOrder)
+{
+	// Arrange
+	MeshData meshData;
+
+	// Act
+	Parse(TRIANGLE_OBJ, &meshData);
+
+	// Assert
+	EXPECT_FLOAT_EQ(meshData.positions[1].x, 1.0f);
+	EXPECT_FLOAT_EQ(meshData.positions[2].y, 1.0f);
+	EXPECT_FLOAT_EQ(meshData.texCoords[2].t, 1.0f);
+	EXPECT_FLOAT_EQ(meshData.normals[0].z, 1.0f);
+}
+
+TEST(MeshLoader, ParseNumberFormats)
+{
+	// Arrange
+	const std::string obj =
+		"v -0.695370 +2.5e2 1.25E-3\r\n"
+		"vt .5 7\r\n"
+		"vn 0.123456789012 -1e-30 3.4028234e38\r\n"
+		"f 1/1/1 1/1/1 1/1/1";
+	MeshData meshData;
+
+	// Act
+	bool result = Parse(obj, &meshData);
+
+	// Assert
+	EXPECT_TRUE(result);
+	EXPECT_EQ(meshData.positions[0].x, -0.695370f);
+	EXPECT_EQ(meshData.positions[0].y, 250.0f);
+	EXPECT_EQ(meshData.positions[0].z, 1.25e-3f);
+	EXPECT_EQ(meshData.texCoords[0].s, 0.5f);
+	EXPECT_EQ(meshData.texCoords[0].t, 7.0f);
+	EXPECT_EQ(meshData.normals[0].x, 0.123456789012f);
+	EXPECT_EQ(meshData.normals[0].y, -1e-30f);
+	EXPECT_EQ(meshData.normals[0].z, 3.4028234e38f);
+}
+
+TEST(MeshLoader, ParseFaceWithMissingAttributeFails)
+{
+	// Arrange
+	const std::string obj =
+		"v 0.0 0.0 0.0\n"
+		"vn 0.0 0.0 1.0\n"
+		"f 1//1 1//1 1//1\n";
+	MeshData meshData;
+
+	// Act
+	bool result = Parse(obj, &meshData);
+
+	// Assert
+	EXPECT_FALSE(result);
+}
+
+TEST(MeshLoader, ParseFaceWithOutOfRangeIndexFails)
+{
+	// Arrange
+	const std::string obj =
+		"v 0.0 0.0 0.0\n"
+		"vt 0.0 0.0\n"
+		"vn 0.0 0.0 1.0\n"
+		"f 1/1/1 2/1/1 1/1/1\n";
+	MeshData meshData;
+
+	// Act
+	bool result = Parse(obj, &meshData);
+
+	// Assert
+	EXPECT_FALSE(result);
+}
+
+TEST(MeshLoader, ParseResultIndependentOfThreadCount)
+{
+	// Arrange
+	std::string obj;
+	for(int i = 0; i < 64; ++i)
+	{
+		const std::string n = std::to_string(i);
+		obj += "v " + n + " 0." + n + " -" + n + "\nvt 0." + n + " 1\nvn 0 " + n + " 1\n";
+		obj += "f " + std::to_string(i + 1) + "/1/1 1/" + std::to_string(i + 1) + "/1 1/1/" + std::to_string(i + 1) + "\n";
+	}
+	MeshData singleThreaded;
+	MeshData multiThreaded;
+
+	// Act
+	bool singleResult = Parse(obj, &singleThreaded, 1);
+	bool multiResult = Parse(obj, &multiThreaded, 7);
+
+	// Assert
+	EXPECT_TRUE(singleResult);
+	EXPECT_TRUE(multiResult);
+	EXPECT_EQ(singleThreaded.positions, multiThreaded.positions);
+	EXPECT_EQ(singleThreaded.texCoords, multiThreaded.texCoords);
+	EXPECT_EQ(singleThreaded.normals, multiThreaded.normals);
+	EXPECT_EQ(singleThreaded.indices, multiThreaded.indices);
+}
+
+TEST(MeshLoader, ParseMoreThreadsThanLines)
+{
+	// Arrange
+	MeshData meshData;
+
+	// Act
+	bool result = Parse(TRIANGLE_OBJ, &meshData, 64);
+
+	// Assert
+	EXPECT_TRUE(result);
+	EXPECT_EQ(meshData.positions.size(), 3);
+	EXPECT_FLOAT_EQ(meshData.positions[1].x, 1.0f);
+}
+
+TEST(MeshLoader, ParseWeldsSharedVertices)
+{
+	// Arrange
+	const std::string obj =
+		"v 0.0 0.0 0.0\n"
+		"v 1.0 0.0 0.0\n"
+		"v 0.0 1.0 0.0\n"
+		"v 1.0 1.0 0.0\n"
+		"vt 0.0 0.0\n"
+		"vn 0.0 0.0 1.0\n"
+		"f 1/1/1 2/1/1 3/1/1\n"
+		"f 3/1/1 2/1/1 4/1/1\n";
+	MeshData meshData;
+
+	// Act
+	bool result = Parse(obj, &meshData);
+
+	// Assert
+	EXPECT_TRUE(result);
+	EXPECT_EQ(meshData.positions.size(), 4);
+	EXPECT_EQ(meshData.indices, (std::vector<GLuint>{ 0, 1, 2, 2, 1, 3 }));
+	EXPECT_FLOAT_EQ(meshData.positions[3].y, 1.0f);
+}
+
+TEST(MeshLoader, ParseKeepsVerticesWithDifferentAttributesSeparate)
+{
+	// Arrange
+	const std::string obj =
+		"v 0.0 0.0 0.0\n"
+		"vt 0.0 0.0\n"
+		"vt 1.0 0.0\n"
+		"vn 0.0 0.0 1.0\n"
+		"vn 0.0 1.0 0.0\n"
+		"f 1/1/1 1/2/1 1/1/2\n";
+	MeshData meshData;
+
+	// Act
+	Parse(obj, &meshData);
+
+	// Assert
+	EXPECT_EQ(meshData.positions.size(), 3);
+	EXPECT_EQ(meshData.indices, (std::vector<GLuint>{ 0, 1, 2 }));
+}
@@ -0,0 +1,119 @@
+#include "pch.h"
+
+#include "../3d-graphics-engine/MeshLoader.h"
+#include "../3d-graphics-engine/MeshOptimiser.h"
+#include <glm\glm.hpp>
+#include <algorithm>
+#include <array>
+#include <vector>
+
+namespace
+{
+	// Creates a grid of triangles with the rows of triangles in a cache unfriendly order
+	MeshData CreateGrid(int size)
+	{
+		MeshData meshData;
+		for(int z = 0; z < size; ++z)
+		{
+			for(int x = 0; x < size; ++x)
+			{
+				meshData.positions.push_back({ x, 0.0f, z });
+				meshData.texCoords.push_back({ x, z });
+				meshData.normals.push_back({ 0.0f, 1.0f, 0.0f });
+			}
+		}
+
+		for(int x = 0; x < size - 1; ++x)
+		{
+			for(int z = 0; z < size - 1; ++z)
+			{
+				GLuint topLeft = z * size + x;
+				GLuint bottomLeft = topLeft + size;
+				meshData.indices.insert(meshData.indices.end(), { topLeft, bottomLeft, topLeft + 1 });
+				meshData.indices.insert(meshData.indices.end(), { topLeft + 1, bottomLeft, bottomLeft + 1 });
+			}
+		}
+
+		return meshData;
+	}
+
+	// Returns the positions of every triangle, sorted so that triangle order does not matter
+	std::vector<std::array<float, 9>> GetSortedTriangles(const MeshData& meshData)
+	{
+		std::vector<std::array<float, 9>> triangles;
+		for(std::size_t i = 0; i < meshData.indices.size(); i += 3)
+		{
+			std::array<float, 9> triangle;
+			for(int j = 0; j < 3; ++j)
+			{
+				const glm::vec3& position = meshData.positions[meshData.indices[i + j]];
+				triangle[j * 3] = position.x;
+				triangle[j * 3 + 1] = position.y;
+				triangle[j * 3 + 2] = position.z;
+			}
+			triangles.push_back(triangle);
+		}
+
+		std::sort(triangles.begin(), triangles.end());
+		return triangles;
+	}
+}
+
+TEST(MeshOptimiser, AnalyseSingleTriangle)
+{
+	// Arrange
+	const std::vector<GLuint> indices{ 0, 1, 2 };
+
+	// Act
+	auto stats = MeshOptimiser::AnalyseVertexCache(indices, 3);
+
+	// Assert
+	EXPECT_FLOAT_EQ(stats.acmr, 3.0f);
+	EXPECT_FLOAT_EQ(stats.atvr, 1.0f);
+}
+
+TEST(MeshOptimiser, VertexCacheImprovesAcmr)
+{
+	// Arrange
+	MeshData meshData = CreateGrid(64);
+	auto before = MeshOptimiser::AnalyseVertexCache(meshData.indices, meshData.positions.size());
+
+	// Act
+	MeshOptimiser::OptimiseVertexCache(&meshData.indices, meshData.positions.size());
+	auto after = MeshOptimiser::AnalyseVertexCache(meshData.indices, meshData.positions.size());
+
+	// Assert
+	EXPECT_LT(after.acmr, before.acmr);
+}
+
+TEST(MeshOptimiser, OptimisePreservesTriangles)
+{
+	// Arrange
+	MeshData meshData = CreateGrid(32);
+	auto expected = GetSortedTriangles(meshData);
+
+	// Act
+	MeshOptimiser::Optimise(&meshData);
+
+	// Assert
+	EXPECT_EQ(GetSortedTriangles(meshData), expected);
+}
+
+TEST(MeshOptimiser, VertexFetchOrdersByFirstUse)
+{
+	// Arrange
+	MeshData meshData;
+	meshData.positions = { { 0, 0, 0 }, { 1, 0, 0 }, { 2, 0, 0 }, { 3, 0, 0 } };
+	meshData.texCoords.resize(4);
+	meshData.normals.resize(4);
+	meshData.indices = { 3, 1, 2 };
+
+	// Act
+	MeshOptimiser::OptimiseVertexFetch(&meshData);
+
+	// Assert
+	EXPECT_EQ(meshData.indices, (std::vector<GLuint>{ 0, 1, 2 }));
+	ASSERT_EQ(meshData.positions.size(), 3);
+	EXPECT_FLOAT_EQ(meshData.positions[0].x, 3.0f);
+	EXPECT_FLOAT_EQ(meshData.positions[1].x, 1.0f);
+}
@@ -0,0 +1,17 @@
+#include "pch.h"
+
+#include "../3d-graphics-engine/Mesh.h"
+
+TEST(Mesh, SmallMeshesUseShortIndices)
+{
+	// Assert
+	EXPECT_EQ(Mesh::ChooseIndexType(8), GL_UNSIGNED_SHORT);
+	EXPECT_EQ(Mesh::ChooseIndexType(0xFFFF), GL_UNSIGNED_SHORT);
+}
+
+TEST(Mesh, LargeMeshesUseIntIndices)
+{
+	// Assert, the last 16-bit index is reserved for primitive restart
+	EXPECT_EQ(Mesh::ChooseIndexType(0x10000), GL_UNSIGNED_INT);
+	EXPECT_EQ(Mesh::ChooseIndexType(1000000), GL_UNSIGNED_INT);
+}
@@ -0,0 +1,198 @@
+#include "pch.h"
+
+#include "../3d-graphics-engine/Entity.h"
+#include "../3d-graphics-engine/Mesh.h"
+#include "../3d-graphics-engine/RenderBatcher.h"
+#include "../3d-graphics-engine/ShaderProgram.h"
+#include <GL\glew.h>
+#include <glm\glm.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+	const glm::vec3 EYE_POSITION(0.0f);
+
+	GLuint GLAPIENTRY FakeCreateShader(GLenum)
+	{
+		return 0;
+	}
+
+	GLuint GLAPIENTRY FakeCreateProgram()
+	{
+		return 0;
+	}
+
+	void GLAPIENTRY FakeDetachShader(GLuint, GLuint)
+	{
+	}
+
+	void GLAPIENTRY FakeDeleteShader(GLuint)
+	{
+	}
+
+	void GLAPIENTRY FakeDeleteObjects(GLsizei, const GLuint*)
+	{
+	}
+
+	// Replaces the GLEW entry points that creating shaders and destroying meshes use, so that
+	// no GL context is needed. Every shader ends up with program 0 and every mesh with vertex
+	// array 0, so the batcher can only tell them apart by their pointers.
+	class RenderBatcherTest : public ::testing::Test
+	{
+		PFNGLCREATESHADERPROC m_createShader;
+		PFNGLCREATEPROGRAMPROC m_createProgram;
+		PFNGLDETACHSHADERPROC m_detachShader;
+		PFNGLDELETESHADERPROC m_deleteShader;
+		PFNGLDELETEBUFFERSPROC m_deleteBuffers;
+		PFNGLDELETEVERTEXARRAYSPROC m_deleteVertexArrays;
+
+	protected:
+		void SetUp() override
+		{
+			m_createShader = glCreateShader;
+			m_createProgram = glCreateProgram;
+			m_detachShader = glDetachShader;
+			m_deleteShader = glDeleteShader;
+			m_deleteBuffers = glDeleteBuffers;
+			m_deleteVertexArrays = glDeleteVertexArrays;
+
+			glCreateShader = FakeCreateShader;
+			glCreateProgram = FakeCreateProgram;
+			glDetachShader = FakeDetachShader;
+			glDeleteShader = FakeDeleteShader;
+			glDeleteBuffers = FakeDeleteObjects;
+			glDeleteVertexArrays = FakeDeleteObjects;
+		}
+
+		void TearDown() override
+		{
+			glCreateShader = m_createShader;
+			glCreateProgram = m_createProgram;
+			glDetachShader = m_detachShader;
+			glDeleteShader = m_deleteShader;
+			glDeleteBuffers = m_deleteBuffers;
+			glDeleteVertexArrays = m_deleteVertexArrays;
+		}
+
+		Entity CreateEntity(Mesh* pMesh, ShaderProgram* pShader, const glm::vec3& position) const
+		{
+			Entity entity(pMesh);
+			entity.SetShader(pShader);
+			entity.SetPosition(position);
+
+			return entity;
+		}
+	};
+
+	std::vector<const Entity*> GetPointers(const std::vector<Entity>& entities)
+	{
+		std::vector<const Entity*> pointers;
+		for(const Entity& entity : entities)
+		{
+			pointers.push_back(&entity);
+		}
+
+		return pointers;
+	}
+}
+
+TEST_F(RenderBatcherTest, EntitiesSharingAMeshAndMaterialShareABatch)
+{
+	// Arrange
+	Mesh mesh;
+	ShaderProgram shader("", "");
+	const std::vector<Entity> entities = {
+		CreateEntity(&mesh, &shader, glm::vec3(0.0f, 0.0f, -3.0f)),
+		CreateEntity(&mesh, &shader, glm::vec3(0.0f, 0.0f, -1.0f)),
+		CreateEntity(&mesh, &shader, glm::vec3(0.0f, 0.0f, -2.0f))
+	};
+	RenderBatcher batcher;
+
+	// Act
+	batcher.Build(GetPointers(entities), BatchGrouping::BY_MESH_SHADER_AND_MATERIAL, EYE_POSITION);
+
+	// Assert, the instances are nearest to the eye first
+	ASSERT_EQ(batcher.GetBatches().size(), 1u);
+	EXPECT_EQ(batcher.GetBatches()[0].pMesh, &mesh);
+	EXPECT_EQ(batcher.GetBatches()[0].firstInstance, 0);
+	EXPECT_EQ(batcher.GetBatches()[0].numInstances, 3);
+	EXPECT_EQ(batcher.GetInstances().size(), 3u);
+	EXPECT_EQ(batcher.GetInstanceEntities(), (std::vector<std::uint32_t>{ 1, 2, 0 }));
+}
+
+TEST_F(RenderBatcherTest, BatchesCoverContiguousInstanceRanges)
+{
+	// Arrange, the meshes are interleaved so that sorting has to gather them. The vertex arrays
+	// are all 0 here, so each mesh is given its own range of depths to be sorted by instead.
+	Mesh meshes[3];
+	ShaderProgram shader("", "");
+	std::vector<Entity> entities;
+	for(int i = 0; i < 9; ++i)
+	{
+		const int mesh = i % 3;
+		const float depth = static_cast<float>(mesh * 3 + i / 3 + 1);
+		entities.push_back(CreateEntity(&meshes[mesh], &shader, glm::vec3(depth, 0.0f, 0.0f)));
+	}
+	RenderBatcher batcher;
+
+	// Act
+	batcher.Build(GetPointers(entities), BatchGrouping::BY_MESH, EYE_POSITION);
+
+	// Assert, each batch starts where the previous one ended and only holds its own mesh
+	const std::vector<RenderBatch>& batches = batcher.GetBatches();
+	ASSERT_EQ(batches.size(), 3u);
+
+	GLint nextInstance = 0;
+	for(const RenderBatch& batch : batches)
+	{
+		EXPECT_EQ(batch.firstInstance, nextInstance);
+		EXPECT_EQ(batch.numInstances, 3);
+
+		for(GLint i = batch.firstInstance; i < batch.firstInstance + batch.numInstances; ++i)
+		{
+			EXPECT_EQ(entities[batcher.GetInstanceEntities()[i]].GetMesh(), batch.pMesh);
+		}
+
+		nextInstance += batch.numInstances;
+	}
+
+	EXPECT_EQ(nextInstance, static_cast<GLint>(batcher.GetInstances().size()));
+}
+
+TEST_F(RenderBatcherTest, DifferentMeshesOrMaterialsAreSeparateBatches)
+{
+	// Arrange
+	Mesh meshA;
+	Mesh meshB;
+	ShaderProgram shader("", "");
+	std::vector<Entity> entities = {
+		CreateEntity(&meshA, &shader, glm::vec3(1.0f)),
+		CreateEntity(&meshA, &shader, glm::vec3(2.0f)),
+		CreateEntity(&meshB, &shader, glm::vec3(3.0f))
+	};
+	entities[1].GetMaterial()->SetDiffuse(glm::vec3(1.0f, 0.0f, 0.0f));
+	RenderBatcher batcher;
+
+	// Act
+	batcher.Build(GetPointers(entities), BatchGrouping::BY_MESH_SHADER_AND_MATERIAL, EYE_POSITION);
+
+	// Assert, every entity is in a batch of its own
+	const std::vector<RenderBatch>& batches = batcher.GetBatches();
+	ASSERT_EQ(batches.size(), 3u);
+
+	for(std::size_t i = 0; i < batches.size(); ++i)
+	{
+		EXPECT_EQ(batches[i].firstInstance, static_cast<GLint>(i));
+		EXPECT_EQ(batches[i].numInstances, 1);
+
+		const Entity& entity = entities[batcher.GetInstanceEntities()[i]];
+		EXPECT_EQ(batches[i].pMesh, entity.GetMesh());
+		EXPECT_TRUE(*batches[i].pMaterial == *entity.GetMaterial());
+	}
+
+	std::vector<std::uint32_t> instanceEntities = batcher.GetInstanceEntities();
+	std::sort(instanceEntities.begin(), instanceEntities.end());
+	EXPECT_EQ(instanceEntities, (std::vector<std::uint32_t>{ 0, 1, 2 }));
+}
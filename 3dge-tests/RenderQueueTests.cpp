@@ -0,0 +1,64 @@
+#include "pch.h"
+
+#include "../3d-graphics-engine/RenderQueue.h"
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+TEST(RenderQueue, KeysOrderByStateBeforeDepth)
+{
+	// Arrange
+	const std::uint64_t nearShaderOne = RenderQueue::MakeKey(0, 1, 5, 7, 1.0f);
+	const std::uint64_t farShaderOne = RenderQueue::MakeKey(0, 1, 5, 7, 100.0f);
+	const std::uint64_t nearShaderTwo = RenderQueue::MakeKey(0, 2, 0, 0, 0.5f);
+	const std::uint64_t nextLayer = RenderQueue::MakeKey(1, 0, 0, 0, 0.0f);
+
+	// Assert
+	EXPECT_LT(nearShaderOne, farShaderOne);
+	EXPECT_LT(farShaderOne, nearShaderTwo);
+	EXPECT_LT(nearShaderTwo, nextLayer);
+	EXPECT_EQ(RenderQueue::GetStateKey(nearShaderOne), RenderQueue::GetStateKey(farShaderOne));
+	EXPECT_NE(RenderQueue::GetStateKey(farShaderOne), RenderQueue::GetStateKey(nearShaderTwo));
+}
+
+TEST(RenderQueue, DepthKeepsItsOrder)
+{
+	// Arrange
+	const std::vector<float> depths = { 0.0f, 0.01f, 0.5f, 1.0f, 2.0f, 10.0f, 1000.0f };
+
+	// Assert
+	for(std::size_t i = 1; i < depths.size(); ++i)
+	{
+		EXPECT_LT(RenderQueue::MakeKey(0, 0, 0, 0, depths[i - 1]), RenderQueue::MakeKey(0, 0, 0, 0, depths[i]));
+	}
+}
+
+TEST(RenderQueue, SortMatchesStableSort)
+{
+	// Arrange, keys that differ in both the low and high digits, with many duplicates
+	std::mt19937 random(42);
+	std::vector<RenderQueue::Item> items;
+	for(std::uint32_t i = 0; i < 1000; ++i)
+	{
+		const std::uint64_t key = RenderQueue::MakeKey(random() % 2, random() % 4, random() % 3, random() % 8,
+			static_cast<float>(random() % 50));
+		items.push_back(RenderQueue::Item{ key, i });
+	}
+
+	std::vector<RenderQueue::Item> expected = items;
+	std::stable_sort(expected.begin(), expected.end(),
+		[](const RenderQueue::Item& a, const RenderQueue::Item& b) { return a.key < b.key; });
+
+	// Act
+	std::vector<RenderQueue::Item> scratch;
+	RenderQueue::Sort(&items, &scratch);
+
+	// Assert
+	ASSERT_EQ(items.size(), expected.size());
+	for(std::size_t i = 0; i < items.size(); ++i)
+	{
+		EXPECT_EQ(items[i].key, expected[i].key);
+		EXPECT_EQ(items[i].index, expected[i].index);
+	}
+}
@@ -0,0 +1,157 @@
+#include "pch.h"
+
+#include "../3d-graphics-engine/GLState.h"
+#include "../3d-graphics-engine/StorageArray.h"
+#include <GL\glew.h>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	// The offset and size of each glBufferSubData that reached the fake driver
+	std::vector<std::pair<GLintptr, GLsizeiptr>> g_subDataCalls;
+	int g_numBufferDataCalls;
+
+	void GLAPIENTRY FakeGenBuffers(GLsizei n, GLuint* pBuffers)
+	{
+		for(GLsizei i = 0; i < n; ++i)
+		{
+			pBuffers[i] = 7;
+		}
+	}
+
+	void GLAPIENTRY FakeBindBuffer(GLenum, GLuint)
+	{
+	}
+
+	void GLAPIENTRY FakeBindBufferBase(GLenum, GLuint, GLuint)
+	{
+	}
+
+	void GLAPIENTRY FakeDeleteBuffers(GLsizei, const GLuint*)
+	{
+	}
+
+	void GLAPIENTRY FakeBufferData(GLenum, GLsizeiptr, const void*, GLenum)
+	{
+		++g_numBufferDataCalls;
+	}
+
+	void GLAPIENTRY FakeBufferSubData(GLenum, GLintptr offset, GLsizeiptr size, const void*)
+	{
+		g_subDataCalls.emplace_back(offset, size);
+	}
+
+	// Replaces the GLEW entry points used by StorageArray, so that no GL context is needed
+	class StorageArrayTest : public ::testing::Test
+	{
+		PFNGLGENBUFFERSPROC m_genBuffers;
+		PFNGLBINDBUFFERPROC m_bindBuffer;
+		PFNGLBINDBUFFERBASEPROC m_bindBufferBase;
+		PFNGLDELETEBUFFERSPROC m_deleteBuffers;
+		PFNGLBUFFERDATAPROC m_bufferData;
+		PFNGLBUFFERSUBDATAPROC m_bufferSubData;
+
+	protected:
+		void SetUp() override
+		{
+			m_genBuffers = glGenBuffers;
+			m_bindBuffer = glBindBuffer;
+			m_bindBufferBase = glBindBufferBase;
+			m_deleteBuffers = glDeleteBuffers;
+			m_bufferData = glBufferData;
+			m_bufferSubData = glBufferSubData;
+
+			glGenBuffers = FakeGenBuffers;
+			glBindBuffer = FakeBindBuffer;
+			glBindBufferBase = FakeBindBufferBase;
+			glDeleteBuffers = FakeDeleteBuffers;
+			glBufferData = FakeBufferData;
+			glBufferSubData = FakeBufferSubData;
+
+			g_subDataCalls.clear();
+			g_numBufferDataCalls = 0;
+
+			GLState::Invalidate();
+		}
+
+		void TearDown() override
+		{
+			glGenBuffers = m_genBuffers;
+			glBindBuffer = m_bindBuffer;
+			glBindBufferBase = m_bindBufferBase;
+			glDeleteBuffers = m_deleteBuffers;
+			glBufferData = m_bufferData;
+			glBufferSubData = m_bufferSubData;
+
+			GLState::Invalidate();
+		}
+	};
+}
+
+TEST_F(StorageArrayTest, OnlyChangedElementsAreUploaded)
+{
+	// Arrange, eight elements that have all been uploaded once
+	StorageArray array(sizeof(float), 2);
+	array.Resize(8);
+	for(std::size_t i = 0; i < 8; ++i)
+	{
+		const float value = static_cast<float>(i);
+		array.Set(i, &value);
+	}
+	array.Upload();
+	g_subDataCalls.clear();
+
+	// Act, change elements 2, 3 and 6 and set element 5 to the value it already has
+	const float newValue = 100.0f;
+	const float sameValue = 5.0f;
+	array.Set(2, &newValue);
+	array.Set(3, &newValue);
+	array.Set(5, &sameValue);
+	array.Set(6, &newValue);
+	const std::size_t numUploaded = array.Upload();
+
+	// Assert, one call per run of changed elements
+	EXPECT_EQ(numUploaded, 3u);
+	const std::vector<std::pair<GLintptr, GLsizeiptr>> expected = {
+		{ 2 * sizeof(float), 2 * sizeof(float) }, { 6 * sizeof(float), sizeof(float) }
+	};
+	EXPECT_EQ(g_subDataCalls, expected);
+}
+
+TEST_F(StorageArrayTest, NothingIsUploadedWhenNothingChanged)
+{
+	// Arrange
+	StorageArray array(sizeof(float), 2);
+	array.Resize(4);
+	array.Upload();
+	g_subDataCalls.clear();
+
+	// Act
+	const float zero = 0.0f;
+	array.Set(1, &zero);
+	const std::size_t numUploaded = array.Upload();
+
+	// Assert
+	EXPECT_EQ(numUploaded, 0u);
+	EXPECT_TRUE(g_subDataCalls.empty());
+}
+
+TEST_F(StorageArrayTest, GrowingPastCapacityReallocatesAndUploadsEverything)
+{
+	// Arrange
+	StorageArray array(sizeof(float), 2);
+	const std::size_t initialCapacity = array.GetCapacity();
+	const int numInitialAllocations = g_numBufferDataCalls;
+
+	// Act, hundreds of elements
+	array.Resize(initialCapacity * 20);
+	const std::size_t numUploaded = array.Upload();
+
+	// Assert
+	EXPECT_GE(array.GetCapacity(), initialCapacity * 20);
+	EXPECT_EQ(g_numBufferDataCalls, numInitialAllocations + 1);
+	EXPECT_EQ(numUploaded, initialCapacity * 20);
+	ASSERT_EQ(g_subDataCalls.size(), 1u);
+	EXPECT_EQ(g_subDataCalls[0].second, static_cast<GLsizeiptr>(initialCapacity * 20 * sizeof(float)));
+}
@@ -0,0 +1,42 @@
+#include "pch.h"
+
+#include "../3d-graphics-engine/ThreadPool.h"
+#include <atomic>
+#include <vector>
+
+TEST(ThreadPool, EveryIndexIsRunOnce)
+{
+	// Arrange
+	ThreadPool pool;
+	std::vector<std::atomic<int>> calls(100);
+
+	// Act
+	pool.Run(static_cast<int>(calls.size()), [&calls](int i) { ++calls[i]; });
+
+	// Assert
+	for(const std::atomic<int>& count : calls)
+	{
+		EXPECT_EQ(count.load(), 1);
+	}
+}
+
+TEST(ThreadPool, WorkersAreKeptBetweenRuns)
+{
+	// Arrange
+	ThreadPool pool;
+	std::atomic<int> total = 0;
+
+	// Act, a smaller run after a larger one needs no more workers
+	pool.Run(4, [&total](int i) { total += i; });
+	const int numWorkers = pool.GetNumWorkers();
+
+	for(int run = 0; run < 10; ++run)
+	{
+		pool.Run(3, [&total](int i) { total += i; });
+	}
+
+	// Assert
+	EXPECT_EQ(numWorkers, 3);
+	EXPECT_EQ(pool.GetNumWorkers(), numWorkers);
+	EXPECT_EQ(total.load(), 6 + 10 * 3);
+}
@@ -0,0 +1,70 @@
+#include "pch.h"
+
+#include "../3d-graphics-engine/UniformTable.h"
+#include <string>
+#include <vector>
+
+TEST(UniformTable, HandleIsHashedAtCompileTime)
+{
+	// Arrange & Act
+	constexpr UniformHandle handle("instanceOffset");
+
+	// Assert
+	static_assert(handle.GetHash() == UniformHandle::Hash("instanceOffset"));
+	EXPECT_EQ(handle.GetHash(), UniformHandle(std::string("instanceOffset")).GetHash());
+}
+
+TEST(UniformTable, FindsEveryUniform)
+{
+	// Arrange, more uniforms than the smallest table has slots
+	std::vector<UniformInfo> uniforms;
+	for(int i = 0; i < 40; ++i)
+	{
+		uniforms.push_back(UniformInfo{ "uniform" + std::to_string(i), i * 3, 1 });
+	}
+
+	UniformTable table;
+
+	// Act
+	table.Build(uniforms);
+
+	// Assert
+	for(const UniformInfo& uniform : uniforms)
+	{
+		EXPECT_EQ(table.Find(UniformHandle(uniform.name)), uniform.location) << uniform.name;
+	}
+	EXPECT_EQ(table.Find(UniformHandle("missing")), -1);
+}
+
+TEST(UniformTable, ArraysAreFoundByNameAndElement)
+{
+	// Arrange, as GL reports an array and a member of an array of structs
+	const std::vector<UniformInfo> uniforms = {
+		{ "shadowMaps[0]", 4, 3 },
+		{ "lights[1].colour", 10, 1 }
+	};
+
+	UniformTable table;
+
+	// Act
+	table.Build(uniforms);
+
+	// Assert
+	EXPECT_EQ(table.Find(UniformHandle("shadowMaps")), 4);
+	EXPECT_EQ(table.Find(UniformHandle("shadowMaps[0]")), 4);
+	EXPECT_EQ(table.Find(UniformHandle("shadowMaps[2]")), 6);
+	EXPECT_EQ(table.Find(UniformHandle("shadowMaps[3]")), -1);
+	EXPECT_EQ(table.Find(UniformHandle("lights[1].colour")), 10);
+	EXPECT_EQ(table.Find(UniformHandle("lights")), -1);
+}
+
+TEST(UniformTable, EmptyTableFindsNothing)
+{
+	// Arrange
+	UniformTable table;
+	table.Build({});
+
+	// Assert
+	EXPECT_EQ(table.Find(UniformHandle("instanceOffset")), -1);
+	EXPECT_EQ(table.GetNumUniforms(), 0u);
+}
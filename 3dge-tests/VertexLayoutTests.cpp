@@ -0,0 +1,124 @@
+#include "pch.h"
+
+#include "../3d-graphics-engine/VertexLayout.h"
+#include <glm\glm.hpp>
+#include <glm\gtc\constants.hpp>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+TEST(VertexLayout, StandardLayoutStride)
+{
+	// Assert
+	EXPECT_EQ(StandardVertexLayout::STRIDE, 32);
+}
+
+TEST(VertexLayout, InterleaveOrdersAttributesPerVertex)
+{
+	// Arrange
+	const glm::vec3 positions[] = { { 1, 2, 3 }, { 4, 5, 6 } };
+	const glm::vec3 normals[]   = { { 0, 1, 0 }, { 0, 0, 1 } };
+	const glm::vec2 texCoords[] = { { 0.25f, 0.5f }, { 0.75f, 1.0f } };
+	const GLuint indices[] = { 0, 1, 0 };
+	const MeshView view{ positions, texCoords, normals, 2, indices, 3 };
+	std::vector<unsigned char> data(2 * StandardVertexLayout::STRIDE);
+
+	// Act
+	StandardVertexLayout::Interleave(view, data.data());
+
+	// Assert
+	const unsigned char* pSecondVertex = data.data() + StandardVertexLayout::STRIDE;
+	glm::vec3 position;
+	glm::vec3 normal;
+	glm::vec2 texCoord;
+	std::memcpy(&position, pSecondVertex, sizeof(position));
+	std::memcpy(&normal, pSecondVertex + sizeof(position), sizeof(normal));
+	std::memcpy(&texCoord, pSecondVertex + sizeof(position) + sizeof(normal), sizeof(texCoord));
+
+	EXPECT_EQ(position, positions[1]);
+	EXPECT_EQ(normal, normals[1]);
+	EXPECT_EQ(texCoord, texCoords[1]);
+}
+
+TEST(VertexLayout, QuantisedLayoutStride)
+{
+	// Assert
+	EXPECT_EQ(QuantisedVertexLayout::STRIDE, 16);
+}
+
+TEST(VertexLayout, QuantisedPositionErrorIsWithinHalfAStep)
+{
+	// Arrange
+	const glm::vec3 positions[] = { { -10.0f, 0.0f, 3.0f }, { 0.123456f, 2.5f, 3.0f }, { 10.0f, 5.0f, 3.0f } };
+	MeshView view{ positions, nullptr, nullptr, 3, nullptr, 0 };
+	view.bounds = AABB{ glm::vec3(-10.0f, 0.0f, 3.0f), glm::vec3(10.0f, 5.0f, 3.0f) };
+	const glm::vec3 extent = view.bounds.max - view.bounds.min;
+	const QuantisedPositionAttrib::Quantiser quantiser = QuantisedPositionAttrib::Prepare(view);
+
+	for(GLsizei i = 0; i < view.numVertices; ++i)
+	{
+		// Act
+		const glm::u16vec4 quantised = QuantisedPositionAttrib::Read(view, quantiser, i);
+		const glm::vec3 dequantised = view.bounds.min + glm::vec3(quantised) / 65535.0f * extent;
+
+		// Assert
+		const glm::vec3 error = glm::abs(dequantised - positions[i]);
+		EXPECT_LE(error.x, extent.x / 65535.0f / 2.0f);
+		EXPECT_LE(error.y, extent.y / 65535.0f / 2.0f);
+		EXPECT_FLOAT_EQ(dequantised.z, 3.0f);
+	}
+}
+
+TEST(VertexLayout, QuantisedFlatAxisIsStoredAsZero)
+{
+	// Arrange, a quad lying flat in the xz plane
+	const glm::vec3 positions[] = { { 0, 2, 0 }, { 1, 2, 0 }, { 1, 2, 1 }, { 0, 2, 1 } };
+	const glm::vec3 normals[]   = { { 0, 1, 0 }, { 0, 1, 0 }, { 0, 1, 0 }, { 0, 1, 0 } };
+	const glm::vec2 texCoords[] = { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 } };
+	const GLuint indices[] = { 0, 1, 2, 0, 2, 3 };
+	MeshView view{ positions, texCoords, normals, 4, indices, 6 };
+	view.bounds = AABB{ glm::vec3(0.0f, 2.0f, 0.0f), glm::vec3(1.0f, 2.0f, 1.0f) };
+	std::vector<unsigned char> data(4 * QuantisedVertexLayout::STRIDE);
+
+	// Act
+	QuantisedVertexLayout::Interleave(view, data.data());
+
+	// Assert
+	for(int i = 0; i < 4; ++i)
+	{
+		glm::u16vec4 quantised;
+		std::memcpy(&quantised, data.data() + i * QuantisedVertexLayout::STRIDE, sizeof(quantised));
+
+		EXPECT_EQ(quantised.y, 0);
+		EXPECT_EQ(quantised.x, positions[i].x == 0.0f ? 0 : 65535);
+		EXPECT_EQ(quantised.z, positions[i].z == 0.0f ? 0 : 65535);
+	}
+}
+
+TEST(VertexLayout, OctahedralNormalAngularErrorIsSmall)
+{
+	// Arrange
+	const int NUM_STEPS = 64;
+	float maxErrorDegrees = 0.0f;
+
+	for(int i = 0; i <= NUM_STEPS; ++i)
+	{
+		for(int j = 0; j < NUM_STEPS; ++j)
+		{
+			const float theta = glm::pi<float>() * i / NUM_STEPS;
+			const float phi = 2.0f * glm::pi<float>() * j / NUM_STEPS;
+			const glm::vec3 normal(std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta));
+
+			// Act
+			const glm::vec2 stored = glm::unpackSnorm2x16(glm::packSnorm2x16(OctahedralNormalAttrib::Encode(normal)));
+			const glm::vec3 decoded = OctahedralNormalAttrib::Decode(stored);
+
+			// acos loses too much precision for angles this small
+			const float angle = std::atan2(glm::length(glm::cross(normal, decoded)), glm::dot(normal, decoded));
+			maxErrorDegrees = glm::max(maxErrorDegrees, glm::degrees(angle));
+		}
+	}
+
+	// Assert
+	EXPECT_LT(maxErrorDegrees, 0.01f);
+}